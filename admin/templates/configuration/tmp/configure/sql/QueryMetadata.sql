@@ -94,6 +94,28 @@ ENGINE = InnoDB
 COMMENT = 'Mapping of queries to workers';
 
 
+-- -----------------------------------------------------
+-- Table `QUsage`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QUsage` (
+  `queryId` BIGINT NOT NULL COMMENT 'Query ID',
+  `tasks` INT NOT NULL DEFAULT 0 COMMENT 'Number of worker tasks which reported usage',
+  `cpuUs` BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'CPU time of worker threads, microseconds',
+  `chunkBytes` BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Bytes of chunk tables locked in memory, summed over tasks sharing them',
+  `memLockWaitUs` BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Time waiting for memory lock, microseconds',
+  `rowsExamined` BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Rows read by worker mysqld, traced queries only',
+  `rowsReturned` BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Rows in worker results',
+  `bytesSent` BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Bytes of result messages sent to czar',
+  PRIMARY KEY (`queryId`),
+  CONSTRAINT `QUsage_qid`
+    FOREIGN KEY (`queryId`)
+    REFERENCES `QInfo` (`queryId`)
+    ON DELETE CASCADE
+    ON UPDATE CASCADE)
+ENGINE = InnoDB
+COMMENT = 'Resources used by worker tasks of a query';
+
+
 SET SQL_MODE=@OLD_SQL_MODE;
 SET FOREIGN_KEY_CHECKS=@OLD_FOREIGN_KEY_CHECKS;
 SET UNIQUE_CHECKS=@OLD_UNIQUE_CHECKS;
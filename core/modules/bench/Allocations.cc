@@ -0,0 +1,104 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "bench/Allocations.h"
+
+// System headers
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Constant initialized, so that they count the allocations made by the
+// static constructors of every library too.
+std::atomic<std::uint64_t> allocCount(0);
+std::atomic<std::uint64_t> allocBytes(0);
+
+void* countedAlloc(std::size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    // malloc(0) may return nullptr, operator new may not.
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+}
+
+// Replacements of the global allocation functions. The array and nothrow
+// forms are replaced too, as the standard library may not route them
+// through operator new(std::size_t).
+void* operator new(std::size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (std::bad_alloc const&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (std::bad_alloc const&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::nothrow_t const&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept {
+    std::free(ptr);
+}
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+Allocations getAllocations() {
+    Allocations allocs;
+    allocs.count = allocCount.load(std::memory_order_relaxed);
+    allocs.bytes = allocBytes.load(std::memory_order_relaxed);
+    return allocs;
+}
+
+}}} // namespace lsst::qserv::bench
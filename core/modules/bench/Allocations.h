@@ -0,0 +1,47 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_BENCH_ALLOCATIONS_H
+#define LSST_QSERV_BENCH_ALLOCATIONS_H
+
+// System headers
+#include <cstdint>
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+/// Allocations counts the calls to the global operator new, and the bytes
+/// they asked for, since the program started. The programs of the bench
+/// module replace the global operator new and delete to count them; the
+/// counts include every thread.
+struct Allocations {
+    std::uint64_t count{0};
+    std::uint64_t bytes{0};
+};
+
+/// @return the allocations made so far.
+Allocations getAllocations();
+
+}}} // namespace lsst::qserv::bench
+
+#endif // LSST_QSERV_BENCH_ALLOCATIONS_H
@@ -0,0 +1,153 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "bench/Bench.h"
+
+// System headers
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+// Qserv headers
+#include "bench/Allocations.h"
+
+namespace {
+
+/// @return the value at 'fraction' of 'sorted', 0 if it is empty.
+template <typename T>
+T percentile(std::vector<T> const& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    auto idx = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[idx];
+}
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+////////////////////////////////////////////////////////////////////////
+// Args
+////////////////////////////////////////////////////////////////////////
+Args::Args(int argc, char const* const* argv) {
+    for (int j = 1; j < argc; ++j) {
+        std::string arg(argv[j]);
+        if (arg.compare(0, 2, "--") != 0) {
+            throw std::invalid_argument("Unexpected argument " + arg);
+        }
+        auto eq = arg.find('=');
+        if (eq == std::string::npos) {
+            _args[arg.substr(2)] = "";
+        } else {
+            _args[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        }
+    }
+}
+
+
+std::string Args::get(std::string const& name, std::string const& def) const {
+    auto iter = _args.find(name);
+    return iter == _args.end() ? def : iter->second;
+}
+
+
+long Args::getInt(std::string const& name, long def) const {
+    auto iter = _args.find(name);
+    return iter == _args.end() ? def : std::stol(iter->second);
+}
+
+
+std::set<std::string> Args::getSet(std::string const& name, std::string const& def) const {
+    std::set<std::string> result;
+    std::istringstream is(get(name, def));
+    std::string value;
+    while (std::getline(is, value, ',')) {
+        if (!value.empty()) result.insert(value);
+    }
+    return result;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+// Bench
+////////////////////////////////////////////////////////////////////////
+void Bench::run(std::function<void()> const& func, std::uint64_t bytes) {
+    _bytes = bytes;
+    for (int j = 0; j < _warmup; ++j) {
+        func();
+    }
+    _nanos.clear();
+    _nanos.reserve(_iters);
+    Allocations const before = getAllocations();
+    for (int j = 0; j < _iters; ++j) {
+        auto begin = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        _nanos.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+    }
+    Allocations const after = getAllocations();
+    _allocs = _iters > 0 ? double(after.count - before.count) / _iters : 0;
+    _allocBytes = _iters > 0 ? double(after.bytes - before.bytes) / _iters : 0;
+    std::sort(_nanos.begin(), _nanos.end());
+}
+
+
+void Bench::write(std::ostream& os) const {
+    std::int64_t total = std::accumulate(_nanos.begin(), _nanos.end(), std::int64_t(0));
+    std::int64_t mean = _nanos.empty() ? 0 : total / static_cast<std::int64_t>(_nanos.size());
+    os << "{\"bench\":\"" << _name << "\"";
+    for (auto const& param : _params) {
+        os << ",\"" << param.first << "\":\"" << param.second << "\"";
+    }
+    os << ",\"iters\":" << _nanos.size()
+       << ",\"bytes\":" << _bytes
+       << ",\"nsMean\":" << mean
+       << ",\"nsMin\":" << (_nanos.empty() ? 0 : _nanos.front())
+       << ",\"nsP50\":" << percentile(_nanos, 0.5)
+       << ",\"nsP90\":" << percentile(_nanos, 0.9)
+       << ",\"nsP99\":" << percentile(_nanos, 0.99)
+       << ",\"nsMax\":" << (_nanos.empty() ? 0 : _nanos.back())
+       // bytes per nanosecond is GB/s; the median is least disturbed by noise.
+       << ",\"mbPerSec\":" << (percentile(_nanos, 0.5) > 0 ? _bytes * 1000.0 / percentile(_nanos, 0.5) : 0)
+       << ",\"allocs\":" << _allocs
+       << ",\"allocBytes\":" << _allocBytes;
+    for (auto const& counter : _counters) {
+        os << ",\"" << counter.first << "\":" << counter.second;
+    }
+    os << "}\n";
+    os.flush();
+}
+
+
+void writeDistribution(std::ostream& os, std::string const& name, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    os << ",\"" << name << "P50\":" << percentile(values, 0.5)
+       << ",\"" << name << "P90\":" << percentile(values, 0.9)
+       << ",\"" << name << "P99\":" << percentile(values, 0.99)
+       << ",\"" << name << "Max\":" << (values.empty() ? 0 : values.back());
+}
+
+}}} // namespace lsst::qserv::bench
@@ -0,0 +1,104 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_BENCH_BENCH_H
+#define LSST_QSERV_BENCH_BENCH_H
+
+// System headers
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+/// Args holds the "--name=value" arguments of a benchmark program.
+class Args {
+public:
+    /// @throws std::invalid_argument if an argument is not "--name=value" or "--name".
+    Args(int argc, char const* const* argv);
+
+    bool has(std::string const& name) const { return _args.count(name) > 0; }
+    std::string get(std::string const& name, std::string const& def) const;
+    long getInt(std::string const& name, long def) const;
+    /// @return the comma separated values of argument 'name', or of 'def'.
+    std::set<std::string> getSet(std::string const& name, std::string const& def) const;
+
+private:
+    std::map<std::string, std::string> _args;
+};
+
+
+/// Bench times the iterations of one benchmark and writes the result as one
+/// JSON object per line, so that the results of successive builds can be
+/// collected and compared by scripts.
+///
+/// The parameters identify the benchmark setup (width, type mix, seed...), so
+/// that only results with equal parameters are compared.
+class Bench {
+public:
+    using Params = std::vector<std::pair<std::string, std::string>>;
+
+    Bench(std::string const& name, Params const& params, int iters, int warmup)
+        : _name(name), _params(params), _iters(iters), _warmup(warmup) {}
+
+    /// Call 'func' 'warmup' times untimed, then 'iters' times timed.
+    /// @param bytes number of bytes processed by one call, for the throughput.
+    void run(std::function<void()> const& func, std::uint64_t bytes);
+
+    /// Add a measure of the benchmark, written as a number after the timings,
+    /// such as a count the benchmarked code reports itself.
+    void setCounter(std::string const& name, double value) {
+        _counters.emplace_back(name, value);
+    }
+
+    /// Write the name, parameters and timings of the last run, in nanoseconds,
+    /// with the mean number of allocations, and allocated bytes, of one call,
+    /// and the counters.
+    void write(std::ostream& os) const;
+
+private:
+    std::string _name;
+    Params _params;
+    int _iters;
+    int _warmup;
+    std::uint64_t _bytes{0};
+    double _allocs{0};
+    double _allocBytes{0};
+    std::vector<std::pair<std::string, double>> _counters;
+    std::vector<std::int64_t> _nanos; ///< sorted durations of the timed calls
+};
+
+
+/// Write the distribution of 'values' as JSON members named <name>P50,
+/// <name>P90, <name>P99 and <name>Max.
+void writeDistribution(std::ostream& os, std::string const& name, std::vector<double> values);
+
+}}} // namespace lsst::qserv::bench
+
+#endif // LSST_QSERV_BENCH_BENCH_H
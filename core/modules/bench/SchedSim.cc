@@ -0,0 +1,456 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "bench/SchedSim.h"
+
+// System headers
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "bench/Bench.h"
+#include "proto/ScanTableInfo.h"
+#include "proto/worker.pb.h"
+#include "wbase/Task.h"
+#include "wsched/BlendScheduler.h"
+#include "wsched/GroupScheduler.h"
+#include "wsched/ScanScheduler.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.bench.SchedSim");
+
+using lsst::qserv::bench::SimTask;
+
+/// @return a value, uniform in [0, 1), of 'rng', the same with all standard libraries.
+double uniform(std::mt19937& rng) {
+    return rng() / 4294967296.0;
+}
+
+/// @return the time to the next arrival of a Poisson process of 'mean' interval.
+double nextInterval(std::mt19937& rng, double mean) {
+    return -std::log(1.0 - uniform(rng)) * mean;
+}
+
+lsst::qserv::wbase::Task::Ptr makeTask(SimTask const& simTask, int jobId) {
+    auto msg = std::make_shared<lsst::qserv::proto::TaskMsg>();
+    msg->set_session(0);
+    msg->set_queryid(simTask.queryId);
+    msg->set_jobid(jobId);
+    msg->set_chunkid(simTask.chunkId);
+    auto dot = simTask.table.find('.');
+    msg->set_db(simTask.table.substr(0, dot));
+    if (simTask.scanRating >= 0) {
+        msg->set_scanpriority(simTask.scanRating);
+        auto scanTbl = msg->add_scantable();
+        scanTbl->set_db(simTask.table.substr(0, dot));
+        scanTbl->set_table(dot == std::string::npos ? simTask.table : simTask.table.substr(dot + 1));
+        scanTbl->set_scanrating(simTask.scanRating);
+        scanTbl->set_lockinmemory(true);
+    }
+    return std::make_shared<lsst::qserv::wbase::Task>(msg, nullptr);
+}
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+////////////////////////////////////////////////////////////////////////
+// Traces
+////////////////////////////////////////////////////////////////////////
+std::vector<SimTask> readTrace(std::istream& is) {
+    std::vector<SimTask> tasks;
+    std::string line;
+    int lineNum = 0;
+    while (std::getline(is, line)) {
+        ++lineNum;
+        if (line.empty() || line[0] == '#' || line.compare(0, 7, "arrival") == 0) continue;
+        std::vector<std::string> fields;
+        std::istringstream ls(line);
+        std::string field;
+        while (std::getline(ls, field, ',')) {
+            fields.push_back(field);
+        }
+        try {
+            if (fields.size() < 5 || fields.size() > 6) {
+                throw std::invalid_argument("expected 5 or 6 fields");
+            }
+            SimTask task{std::stod(fields[0]), std::stoull(fields[1]), std::stoi(fields[2]),
+                         std::stoi(fields[3]), std::stod(fields[4]),
+                         fields.size() > 5 ? fields[5] : std::string()};
+            if (task.scanRating >= 0 && task.table.empty()) {
+                task.table = "LSST.Object";
+            }
+            tasks.push_back(task);
+        } catch (std::exception const& exc) {
+            throw std::invalid_argument("trace line " + std::to_string(lineNum) + ": "
+                                        + exc.what() + ": " + line);
+        }
+    }
+    return tasks;
+}
+
+
+void writeTrace(std::ostream& os, std::vector<SimTask> const& tasks) {
+    auto precision = os.precision(12);
+    os << "arrival,queryId,chunkId,scanRating,runtime,table\n";
+    for (auto const& task : tasks) {
+        os << task.arrival << "," << task.queryId << "," << task.chunkId << ","
+           << task.scanRating << "," << task.runtime << "," << task.table << "\n";
+    }
+    os.precision(precision);
+}
+
+
+std::vector<SimTask> makeWorkload(WorkloadConfig const& config) {
+    struct ScanKind {
+        char const* table;
+        int rating;
+        double runtime; ///< mean seconds per chunk
+    };
+    static ScanKind const kinds[] = {
+        {"LSST.Object", proto::ScanInfo::Rating::FAST, 2.0},
+        {"LSST.Source", proto::ScanInfo::Rating::MEDIUM, 8.0},
+        {"LSST.ForcedSource", proto::ScanInfo::Rating::SLOW, 20.0}
+    };
+    std::mt19937 rng(config.seed);
+    std::vector<SimTask> tasks;
+    QueryId queryId = 0;
+    double arrival = 0;
+    for (int q = 0; q < config.scans; ++q) {
+        arrival += nextInterval(rng, config.scanInterval);
+        auto const& kind = kinds[rng() % 3];
+        ++queryId;
+        for (int chunk = 0; chunk < config.chunks; ++chunk) {
+            double runtime = kind.runtime * (0.5 + uniform(rng));
+            tasks.push_back(SimTask{arrival, queryId, chunk, kind.rating, runtime, kind.table});
+        }
+    }
+    arrival = 0;
+    for (int q = 0; q < config.interactive; ++q) {
+        arrival += nextInterval(rng, config.interactiveInterval);
+        ++queryId;
+        int chunk = rng() % std::max(config.chunks, 1);
+        double runtime = 0.05 + 0.45 * uniform(rng);
+        tasks.push_back(SimTask{arrival, queryId, chunk, -1, runtime, "LSST.Object"});
+    }
+    std::stable_sort(tasks.begin(), tasks.end(), [](SimTask const& a, SimTask const& b) {
+        return a.arrival < b.arrival;
+    });
+    return tasks;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+// SimMemMan
+////////////////////////////////////////////////////////////////////////
+void SimMemMan::setTableBytes(std::string const& table, std::uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _bytesByTable[table] = bytes;
+}
+
+
+std::uint64_t SimMemMan::_bytesOf(std::string const& table) const {
+    auto iter = _bytesByTable.find(table);
+    return iter == _bytesByTable.end() ? _tableBytes : iter->second;
+}
+
+
+bool SimMemMan::_locks(memman::TableInfo const& info) {
+    return info.theData == memman::TableInfo::LockType::MUSTLOCK
+        || info.theData == memman::TableInfo::LockType::FLEXIBLE;
+}
+
+
+memman::MemMan::Handle SimMemMan::lock(std::vector<memman::TableInfo> const& tables, int chunk) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    ++_churn.lockCalls;
+    std::vector<Key> keys;
+    std::uint64_t needed = 0;
+    bool mustLock = false;
+    for (auto const& info : tables) {
+        if (!_locks(info)) continue;
+        Key key(info.tableName, chunk);
+        if (_resident.count(key) == 0) needed += _bytesOf(info.tableName);
+        mustLock |= info.theData == memman::TableInfo::LockType::MUSTLOCK;
+        keys.push_back(key);
+    }
+    if (keys.empty()) {
+        return HandleType::ISEMPTY;
+    }
+    if (mustLock && _bytesLocked + needed > _maxBytes) {
+        ++_churn.lockFailures;
+        errno = ENOMEM;
+        return HandleType::INVALID;
+    }
+    for (auto const& key : keys) {
+        if (_resident[key]++ == 0) {
+            ++_churn.loads;
+            if (!_loaded.insert(key).second) ++_churn.reloads;
+            _bytesLocked += _bytesOf(key.first);
+        }
+    }
+    _churn.peakBytes = std::max(_churn.peakBytes, _bytesLocked);
+    Handle handle = ++_lastHandle;
+    _handles[handle] = keys;
+    return handle;
+}
+
+
+bool SimMemMan::unlock(Handle handle) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _handles.find(handle);
+    if (iter == _handles.end()) {
+        return false;
+    }
+    for (auto const& key : iter->second) {
+        if (--_resident[key] == 0) {
+            _resident.erase(key);
+            _bytesLocked -= _bytesOf(key.first);
+        }
+    }
+    _handles.erase(iter);
+    return true;
+}
+
+
+bool SimMemMan::isResident(std::vector<memman::TableInfo> const& tables, int chunk) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    for (auto const& info : tables) {
+        if (_locks(info) && _resident.count(Key(info.tableName, chunk)) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void SimMemMan::unlockAll() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _handles.clear();
+    _resident.clear();
+    _bytesLocked = 0;
+}
+
+
+memman::MemMan::Statistics SimMemMan::getStatistics() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    Statistics stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.bytesLockMax = _maxBytes;
+    stats.bytesLocked = _bytesLocked;
+    stats.numFiles = _resident.size();
+    stats.numLocks = _churn.lockCalls;
+    stats.numErrors = _churn.lockFailures;
+    return stats;
+}
+
+
+memman::MemMan::Status SimMemMan::getStatus(Handle handle) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    Status status;
+    memset(&status, 0, sizeof(status));
+    auto iter = _handles.find(handle);
+    if (iter != _handles.end() && !iter->second.empty()) {
+        status.numFiles = iter->second.size();
+        status.chunk = iter->second.front().second;
+        for (auto const& key : iter->second) {
+            status.bytesLock += _bytesOf(key.first);
+        }
+    }
+    return status;
+}
+
+
+SimMemMan::Churn SimMemMan::getChurn() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _churn;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+// SchedSim
+////////////////////////////////////////////////////////////////////////
+void SchedSim::run(std::vector<SimTask> const& tasks) {
+    // Same schedulers as the worker builds in xrdsvc::SsiService.
+    int const fastest = proto::ScanInfo::Rating::FASTEST;
+    int const fast    = proto::ScanInfo::Rating::FAST;
+    int const medium  = proto::ScanInfo::Rating::MEDIUM;
+    int const slow    = proto::ScanInfo::Rating::SLOW;
+    int const pool = _config.poolSize;
+    auto memMan = std::make_shared<SimMemMan>(_config.memBytes, _config.tableBytes);
+    auto group = std::make_shared<wsched::GroupScheduler>(
+        "SchedGroup", pool, 2, _config.groupSize, wsched::SchedulerBase::getMaxPriority());
+    std::vector<wsched::ScanScheduler::Ptr> scanSchedulers{
+        std::make_shared<wsched::ScanScheduler>(
+            "SchedSlow", pool, _config.reserveSlow, _config.prioritySlow, memMan, medium+1, slow),
+        std::make_shared<wsched::ScanScheduler>(
+            "SchedMed", pool, _config.reserveMed, _config.priorityMed, memMan, fast+1, medium),
+        std::make_shared<wsched::ScanScheduler>(
+            "SchedFast", pool, _config.reserveFast, _config.priorityFast, memMan, fastest, fast)
+    };
+    for (auto const& scan : scanSchedulers) {
+        scan->setMaxActiveChunks(_config.maxActiveChunks);
+    }
+    auto blend = std::make_shared<wsched::BlendScheduler>("BlendSched", pool, group, scanSchedulers);
+    blend->setRelaxReserve(_config.relaxReserve);
+
+    // Times are in microseconds, so that events are ordered exactly.
+    auto micros = [](double sec) { return static_cast<std::int64_t>(std::llround(sec * 1e6)); };
+    std::vector<size_t> order(tasks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&tasks](size_t a, size_t b) {
+        return tasks[a].arrival < tasks[b].arrival;
+    });
+
+    struct Running {
+        std::int64_t finish;
+        std::uint64_t seq; ///< breaks ties in start order
+        wbase::Task::Ptr task;
+        Record record;
+        bool operator>(Running const& rhs) const {
+            return finish > rhs.finish || (finish == rhs.finish && seq > rhs.seq);
+        }
+    };
+    std::priority_queue<Running, std::vector<Running>, std::greater<Running>> running;
+    std::uint64_t seq = 0;
+    std::int64_t now = 0;
+    size_t next = 0;
+    _records.clear();
+    _busySec = 0;
+    while (next < order.size() || !running.empty()) {
+        // Tasks finishing at the time others arrive free their thread first.
+        if (!running.empty() && (next == order.size()
+                                 || running.top().finish <= micros(tasks[order[next]].arrival))) {
+            Running done = running.top();
+            running.pop();
+            now = done.finish;
+            blend->commandFinish(done.task);
+            done.record.finish = now / 1e6;
+            _busySec += done.record.finish - done.record.start;
+            _records.push_back(done.record);
+        } else {
+            auto idx = order[next++];
+            now = std::max(now, micros(tasks[idx].arrival));
+            blend->queCmd(makeTask(tasks[idx], idx));
+        }
+        while (static_cast<int>(running.size()) < pool) {
+            auto task = std::dynamic_pointer_cast<wbase::Task>(blend->getCmd(false));
+            if (task == nullptr) break;
+            blend->commandStart(task);
+            auto const& simTask = tasks[task->msg->jobid()];
+            auto sched = blend->lookup(task);
+            Record record{sched != nullptr ? sched->getName() : "?", simTask.queryId,
+                          micros(simTask.arrival) / 1e6, now / 1e6, 0};
+            running.push(Running{now + micros(simTask.runtime), seq++, task, record});
+        }
+    }
+    _endSec = now / 1e6;
+    _stuck = blend->getSize();
+    if (_stuck > 0) {
+        LOGS(_log, LOG_LVL_WARN, "SchedSim " << _stuck << " Tasks never started");
+    }
+    _churn = memMan->getChurn();
+}
+
+
+void SchedSim::writeReport(std::ostream& os) const {
+    std::map<std::string, std::vector<Record const*>> byLane;
+    std::map<QueryId, std::pair<double, double>> queryTimes; ///< first arrival, last finish
+    for (auto const& rec : _records) {
+        byLane[rec.lane].push_back(&rec);
+        auto iter = queryTimes.find(rec.queryId);
+        if (iter == queryTimes.end()) {
+            queryTimes[rec.queryId] = std::make_pair(rec.arrival, rec.finish);
+        } else {
+            iter->second.first = std::min(iter->second.first, rec.arrival);
+            iter->second.second = std::max(iter->second.second, rec.finish);
+        }
+    }
+    double const span = _endSec > 0 ? _endSec : 1;
+
+    os << "{\"sim\":\"total\",\"poolSize\":" << _config.poolSize
+       << ",\"groupSize\":" << _config.groupSize
+       << ",\"priority\":\"" << _config.priorityFast << "/" << _config.priorityMed
+       << "/" << _config.prioritySlow << "\""
+       << ",\"reserve\":\"" << _config.reserveFast << "/" << _config.reserveMed
+       << "/" << _config.reserveSlow << "\""
+       << ",\"maxActiveChunks\":" << _config.maxActiveChunks
+       << ",\"relaxReserve\":" << (_config.relaxReserve ? "true" : "false")
+       << ",\"tasks\":" << _records.size()
+       << ",\"queries\":" << queryTimes.size()
+       << ",\"stuck\":" << _stuck
+       << ",\"makespanSec\":" << _endSec
+       << ",\"tasksPerSec\":" << _records.size() / span
+       << ",\"utilization\":" << _busySec / (span * _config.poolSize)
+       << "}\n";
+
+    for (auto const& elem : byLane) {
+        std::vector<double> waits;
+        std::vector<double> latencies;
+        std::vector<double> queryLatencies;
+        std::set<QueryId> queries;
+        int starved = 0;
+        for (auto rec : elem.second) {
+            double wait = rec->start - rec->arrival;
+            waits.push_back(wait);
+            latencies.push_back(rec->finish - rec->arrival);
+            if (wait > _config.starveSec) ++starved;
+            if (queries.insert(rec->queryId).second) {
+                auto const& times = queryTimes.at(rec->queryId);
+                queryLatencies.push_back(times.second - times.first);
+            }
+        }
+        os << "{\"sim\":\"lane\",\"lane\":\"" << elem.first << "\""
+           << ",\"tasks\":" << elem.second.size()
+           << ",\"queries\":" << queries.size()
+           << ",\"tasksPerSec\":" << elem.second.size() / span;
+        writeDistribution(os, "waitSec", waits);
+        writeDistribution(os, "taskSec", latencies);
+        writeDistribution(os, "querySec", queryLatencies);
+        os << ",\"starved\":" << starved << "}\n";
+    }
+
+    os << "{\"sim\":\"memman\""
+       << ",\"lockCalls\":" << _churn.lockCalls
+       << ",\"lockFailures\":" << _churn.lockFailures
+       << ",\"loads\":" << _churn.loads
+       << ",\"reloads\":" << _churn.reloads
+       << ",\"peakBytes\":" << _churn.peakBytes
+       << "}\n";
+    os.flush();
+}
+
+}}} // namespace lsst::qserv::bench
@@ -0,0 +1,202 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_BENCH_SCHEDSIM_H
+#define LSST_QSERV_BENCH_SCHEDSIM_H
+
+// System headers
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Qserv headers
+#include "global/intTypes.h"
+#include "memman/MemMan.h"
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+/// SimTask is one Task of a worker workload, as recorded in a trace.
+struct SimTask {
+    double arrival;     ///< seconds since the start of the trace
+    QueryId queryId;
+    int chunkId;
+    int scanRating;     ///< -1 for interactive Tasks, which scan no table
+    double runtime;     ///< seconds the Task runs once started
+    std::string table;  ///< "db.table" scanned, empty for interactive Tasks
+};
+
+/// Read a trace, in CSV with one Task per line:
+///   arrival,queryId,chunkId,scanRating,runtime,table
+/// Lines starting with '#' or 'arrival' (a header) are skipped.
+/// @throws std::invalid_argument, with the line number, on a malformed line.
+std::vector<SimTask> readTrace(std::istream& is);
+
+/// Write 'tasks' in the format readTrace() reads.
+void writeTrace(std::ostream& os, std::vector<SimTask> const& tasks);
+
+
+/// Parameters of a synthetic workload: shared scans of every chunk, on
+/// Object (fast), Source (medium) or ForcedSource (slow), mixed with
+/// interactive queries on a single chunk. Arrivals are Poisson.
+struct WorkloadConfig {
+    int chunks{200};
+    int scans{20};                  ///< number of scan queries
+    double scanInterval{60};        ///< mean seconds between scan queries
+    int interactive{200};           ///< number of interactive queries
+    double interactiveInterval{3};  ///< mean seconds between interactive queries
+    unsigned seed{1};
+};
+
+/// @return the Tasks of a synthetic workload, in arrival order. The same
+///         configuration always gives the same Tasks.
+std::vector<SimTask> makeWorkload(WorkloadConfig const& config);
+
+
+/// SimMemMan is a MemMan that locks nothing, but accounts for the memory
+/// locked chunk tables would use, so that the schedulers see the memory
+/// limits they would see on a worker with that much memory.
+///
+/// Tables marked MUSTLOCK are refused with ENOMEM beyond the limit. Tables
+/// marked FLEXIBLE are always granted, as MemManReal then reserves the
+/// memory instead. Tables stay resident as long as a handle uses them.
+class SimMemMan : public memman::MemMan {
+public:
+    /// Counts of chunk table loads, to measure how often the schedulers
+    /// make the worker read the same chunk again.
+    struct Churn {
+        std::uint64_t lockCalls{0};
+        std::uint64_t lockFailures{0};
+        std::uint64_t loads{0};    ///< chunk tables made resident
+        std::uint64_t reloads{0};  ///< loads of chunk tables that were resident before
+        std::uint64_t peakBytes{0};
+    };
+
+    /// @param maxBytes memory available for locking.
+    /// @param tableBytes size of one chunk of a table, unless set by setTableBytes().
+    SimMemMan(std::uint64_t maxBytes, std::uint64_t tableBytes)
+        : _maxBytes(maxBytes), _tableBytes(tableBytes) {}
+
+    /// @param table "db/table", as in memman::TableInfo::tableName.
+    void setTableBytes(std::string const& table, std::uint64_t bytes);
+
+    Handle lock(std::vector<memman::TableInfo> const& tables, int chunk) override;
+    bool unlock(Handle handle) override;
+    bool isResident(std::vector<memman::TableInfo> const& tables, int chunk) override;
+    void unlockAll() override;
+    Statistics getStatistics() override;
+    Status getStatus(Handle handle) override;
+
+    Churn getChurn();
+
+private:
+    using Key = std::pair<std::string, int>; ///< table and chunk
+    std::uint64_t _bytesOf(std::string const& table) const;
+    static bool _locks(memman::TableInfo const& info);
+
+    std::mutex _mtx; ///< protects all members below
+    std::uint64_t const _maxBytes;
+    std::uint64_t const _tableBytes;
+    std::map<std::string, std::uint64_t> _bytesByTable;
+    std::uint64_t _bytesLocked{0};
+    std::map<Key, int> _resident; ///< number of handles using each chunk table
+    std::set<Key> _loaded;        ///< chunk tables loaded at least once
+    std::map<Handle, std::vector<Key>> _handles;
+    Handle _lastHandle{HandleType::ISEMPTY};
+    Churn _churn;
+};
+
+
+/// Scheduler settings, named as in the worker configuration.
+struct SimConfig {
+    int poolSize{20};           ///< scheduler.thread_pool_size
+    int groupSize{1};           ///< scheduler.group_size
+    int priorityFast{3};        ///< scheduler.priority_fast
+    int priorityMed{2};
+    int prioritySlow{1};
+    int reserveFast{2};         ///< scheduler.reserve_fast
+    int reserveMed{2};
+    int reserveSlow{2};
+    int maxActiveChunks{20};    ///< of each ScanScheduler
+    bool relaxReserve{false};   ///< scheduler.relax_reserve
+    std::uint64_t memBytes{8000ULL*1000*1000}; ///< memman.memory
+    std::uint64_t tableBytes{100ULL*1000*1000}; ///< size of one chunk table
+    double starveSec{600};      ///< a Task queued longer than this is starved
+};
+
+
+/// SchedSim is a discrete-event simulation of a worker: it runs the Tasks of a
+/// workload through the real BlendScheduler, GroupScheduler, ScanScheduler
+/// and ChunkDisk code, on a pool of simulated threads, with SimMemMan in
+/// place of the memory manager. A started Task finishes after its runtime,
+/// in simulated time, so a day of workload replays in seconds.
+///
+/// The schedulers are driven from a single thread, the way pool threads
+/// drive them: a thread that is free takes the next Task with getCmd(), calls
+/// commandStart(), and commandFinish() when the Task is done. Chunk prefetch,
+/// SchedulerTuner and ScanStats measure wall clock time and are not simulated.
+class SchedSim {
+public:
+    explicit SchedSim(SimConfig const& config) : _config(config) {}
+    SchedSim(SchedSim const&) = delete;
+    SchedSim& operator=(SchedSim const&) = delete;
+
+    /// Replay 'tasks'. Tasks still queued when nothing is running and no
+    /// Task is left to arrive are counted as stuck.
+    void run(std::vector<SimTask> const& tasks);
+
+    /// Write the results as JSON objects, one per line: the totals, each
+    /// scheduler lane, and the chunk table churn.
+    void writeReport(std::ostream& os) const;
+
+    /// Times, in seconds, of a Task that ran.
+    struct Record {
+        std::string lane;
+        QueryId queryId;
+        double arrival;
+        double start;
+        double finish;
+    };
+    std::vector<Record> const& getRecords() const { return _records; }
+    int getStuck() const { return _stuck; }
+    SimMemMan::Churn const& getChurn() const { return _churn; }
+
+private:
+    SimConfig const _config;
+    std::vector<Record> _records;
+    double _busySec{0};  ///< thread-seconds spent running Tasks
+    double _endSec{0};   ///< time the last Task finished
+    int _stuck{0};
+    SimMemMan::Churn _churn;
+};
+
+}}} // namespace lsst::qserv::bench
+
+#endif // LSST_QSERV_BENCH_SCHEDSIM_H
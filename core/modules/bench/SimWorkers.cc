@@ -0,0 +1,209 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "bench/SimWorkers.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+// Qserv headers
+#include "bench/SyntheticResult.h"
+#include "proto/ProtoHeaderWrap.h"
+#include "proto/worker.pb.h"
+#include "qdisp/ResponseHandler.h"
+#include "util/StringHash.h"
+
+namespace {
+
+// Only the raw mt19937 output is used, as in SyntheticResult.
+double uniform(std::mt19937& rng) {
+    return rng() / 4294967296.0;
+}
+
+/// @return the wrapped header of 'msg', the way QueryRunner::_transmitHeader() makes it.
+std::string makeHeader(std::string const& msg, std::string const& wname) {
+    lsst::qserv::proto::ProtoHeader protoHeader;
+    protoHeader.set_protocol(2);
+    protoHeader.set_size(msg.size());
+    protoHeader.set_md5(lsst::qserv::util::StringHash::getMd5(msg.data(), msg.size()));
+    protoHeader.set_wname(wname);
+    std::string protoHeaderString;
+    protoHeader.SerializeToString(&protoHeaderString);
+    return lsst::qserv::proto::ProtoHeaderWrap::wrap(protoHeaderString);
+}
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+SimWorkers::SimWorkers(SimWorkersConfig const& config)
+    : _config(config), _busy(std::max(config.workers, 0), 0) {
+    if (_config.workers < 1 || _config.threadsPerWorker < 1) {
+        throw std::invalid_argument("SimWorkers: needs at least one worker and one thread");
+    }
+    // Split the rows into messages as QueryRunner::_fillRows() does: a
+    // message is sent as soon as its rows exceed the desired size. Only the
+    // first message has the schema.
+    SyntheticResult res(_config.rows, _config.cols, _config.mix, _config.seed);
+    int row = 0;
+    do {
+        proto::Result result;
+        result.mutable_rowschema();
+        if (row == 0) {
+            res.fillSchema(result);
+        }
+        std::uint64_t size = 0;
+        while (row < res.getNumRows() && size <= proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT) {
+            size += res.fillRows(result, row, row + 1);
+            ++row;
+        }
+        result.set_continues(row < res.getNumRows());
+        std::string msg;
+        result.SerializeToString(&msg);
+        _messages.push_back(msg);
+    } while (row < res.getNumRows());
+
+    _headers.resize(_config.workers);
+    for (int w = 0; w < _config.workers; ++w) {
+        for (auto const& msg : _messages) {
+            _headers[w].push_back(makeHeader(msg, "simworker" + std::to_string(w)));
+        }
+    }
+    for (size_t i = 0; i < _messages.size(); ++i) {
+        _streamBytes += _headers[0][i].size() + _messages[i].size();
+    }
+}
+
+
+std::string SimWorkers::makePayload(int queryNum, int chunkId) {
+    return std::to_string(queryNum) + ":" + std::to_string(chunkId);
+}
+
+
+bool SimWorkers::respond(std::string const& payload, qdisp::ResponseHandler& handler) {
+    auto colon = payload.find(':');
+    if (colon == std::string::npos) {
+        handler.errorFlush("SimWorkers: unexpected payload " + payload, -1);
+        return false;
+    }
+    int const queryNum = std::stoi(payload.substr(0, colon));
+    int const chunkId = std::stoi(payload.substr(colon + 1));
+    int const worker = std::abs(chunkId) % _config.workers;
+
+    std::seed_seq seq{_config.seed, static_cast<unsigned>(queryNum), static_cast<unsigned>(chunkId)};
+    std::mt19937 rng(seq);
+    double const latencyMs = -std::log(1 - uniform(rng)) * _config.latencyMs;
+    size_t const segments = 2 * _messages.size();
+    size_t failAt = segments;
+    if (uniform(rng) < _config.failRate) {
+        failAt = rng() % segments;
+    }
+
+    _acquire(worker);
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(latencyMs));
+    bool success = true;
+    std::uint64_t bytes = 0;
+    for (size_t i = 0; i < segments; ++i) {
+        if (i == failAt) {
+            handler.errorFlush("Simulated failure of simworker" + std::to_string(worker), -1);
+            success = false;
+            break;
+        }
+        std::string const& segment = (i % 2 == 0) ? _headers[worker][i / 2] : _messages[i / 2];
+        if (_config.mbPerSec > 0) {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(
+                    segment.size() / _config.mbPerSec));
+        }
+        std::vector<char>& buffer = handler.nextBuffer();
+        if (buffer.size() != segment.size()) {
+            handler.errorFlush("SimWorkers: expected a buffer of " + std::to_string(segment.size())
+                               + " bytes, got " + std::to_string(buffer.size()), -1);
+            success = false;
+            break;
+        }
+        std::copy(segment.begin(), segment.end(), buffer.begin());
+        if (i == 0) {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _firstByte.insert(std::make_pair(queryNum, Clock::now()));
+        }
+        bool last = false;
+        bool flushOk = handler.flush(segment.size(), last);
+        bytes += segment.size();
+        // On failure, the handler has its error, as QueryRequest expects.
+        if (!flushOk) {
+            success = false;
+            break;
+        }
+        if (last) break;
+    }
+    _release(worker);
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    ++_counts.jobs;
+    if (failAt < segments) ++_counts.failures;
+    _counts.bytes += bytes;
+    return success;
+}
+
+
+SimWorkers::Clock::time_point SimWorkers::takeFirstByte(int queryNum) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _firstByte.find(queryNum);
+    if (iter == _firstByte.end()) {
+        return Clock::time_point();
+    }
+    auto firstByte = iter->second;
+    _firstByte.erase(iter);
+    return firstByte;
+}
+
+
+SimWorkers::Counts SimWorkers::getCounts() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _counts;
+}
+
+
+void SimWorkers::_acquire(int worker) {
+    std::unique_lock<std::mutex> lock(_mtx);
+    _threadFree.wait(lock, [this, worker]() { return _busy[worker] < _config.threadsPerWorker; });
+    ++_busy[worker];
+}
+
+
+void SimWorkers::_release(int worker) {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        --_busy[worker];
+    }
+    _threadFree.notify_all();
+}
+
+}}} // namespace lsst::qserv::bench
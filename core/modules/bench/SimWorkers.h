@@ -0,0 +1,115 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_BENCH_SIMWORKERS_H
+#define LSST_QSERV_BENCH_SIMWORKERS_H
+
+// System headers
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+    class ResponseHandler;
+}}} // End of forward declarations
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+/// Settings of the simulated workers.
+struct SimWorkersConfig {
+    int workers{10};
+    int threadsPerWorker{8};   ///< jobs a worker runs at once, the others wait
+    double latencyMs{50};      ///< mean time a job runs before its first byte, exponential
+    double mbPerSec{0};        ///< rate a result is sent at, 0 for no limit
+    double failRate{0};        ///< fraction of the jobs that fail, part way through their result
+    int rows{1000};            ///< rows of the result of every job
+    int cols{8};
+    std::string mix{"iddddn"}; ///< column types, see SyntheticResult
+    unsigned seed{1};
+};
+
+
+/// SimWorkers stands in for the workers behind qdisp::XrdSsiServiceMock:
+/// it answers each job with the stream a worker sends, a wrapped ProtoHeader
+/// then a Result message, repeated, with the rows of a SyntheticResult split
+/// into messages as QueryRunner splits large results.
+///
+/// A job runs on worker (chunkId modulo workers), and waits for one of its
+/// threads. It then waits for its latency, and streams its result through
+/// the ResponseHandler the way QueryRequest does. The latency and failure of
+/// a job only depend on the seed, query and chunk.
+class SimWorkers {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SimWorkers(SimWorkersConfig const& config);
+    SimWorkers(SimWorkers const&) = delete;
+    SimWorkers& operator=(SimWorkers const&) = delete;
+
+    /// @return the payload of the job of query 'queryNum' on chunk 'chunkId'.
+    static std::string makePayload(int queryNum, int chunkId);
+
+    /// Respond to the job with 'payload', see XrdSsiServiceMock::Responder.
+    bool respond(std::string const& payload, qdisp::ResponseHandler& handler);
+
+    /// @return the time the first result bytes of query 'queryNum' were
+    ///         flushed, and forget it, or Clock::time_point() if none were.
+    Clock::time_point takeFirstByte(int queryNum);
+
+    /// @return the bytes of the stream of one job.
+    std::uint64_t getStreamBytes() const { return _streamBytes; }
+
+    struct Counts {
+        std::uint64_t jobs{0};
+        std::uint64_t failures{0};  ///< jobs made to fail
+        std::uint64_t bytes{0};     ///< bytes flushed
+    };
+    Counts getCounts();
+
+private:
+    void _acquire(int worker);
+    void _release(int worker);
+
+    SimWorkersConfig const _config;
+    std::vector<std::string> _messages; ///< serialized Result messages of a job
+    std::vector<std::vector<std::string>> _headers; ///< wrapped headers of the messages, by worker
+    std::uint64_t _streamBytes{0};
+
+    std::mutex _mtx; ///< protects all members below
+    std::condition_variable _threadFree;
+    std::vector<int> _busy; ///< threads busy on each worker
+    std::map<int, Clock::time_point> _firstByte;
+    Counts _counts;
+};
+
+}}} // namespace lsst::qserv::bench
+
+#endif // LSST_QSERV_BENCH_SIMWORKERS_H
@@ -0,0 +1,161 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "bench/SyntheticResult.h"
+
+// System headers
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Only the raw mt19937 output is used, the standard distributions are not
+// the same in all standard libraries.
+using Rng = std::mt19937;
+
+double uniform(Rng& rng, double lo, double hi) {
+    return lo + (hi - lo) * (rng() / 4294967296.0);
+}
+
+std::string formatDouble(double val) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.15g", val);
+    return buf;
+}
+
+std::string makeText(Rng& rng) {
+    static char const special[] = {'\t', '\n', '\\', '\''};
+    std::string text(16 + rng() % 49, ' ');
+    for (auto& c : text) {
+        auto r = rng() % 32;
+        c = r < 4 ? special[r] : static_cast<char>('a' + r - 4);
+    }
+    return text;
+}
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+SyntheticResult::SyntheticResult(int rows, int cols, std::string const& mix, unsigned seed)
+    : _rows(rows), _cols(cols) {
+    static char const* const filters[] = {"u", "g", "r", "i", "z", "y"};
+    if (mix.empty()) {
+        throw std::invalid_argument("SyntheticResult: empty type mix");
+    }
+    for (int c = 0; c < cols; ++c) {
+        sql::ColSchema cs;
+        cs.name = "c" + std::to_string(c);
+        cs.hasDefault = false;
+        switch (mix[c % mix.size()]) {
+        case 'i': cs.colType = sql::ColType{"BIGINT(20)", MYSQL_TYPE_LONGLONG}; break;
+        case 'd': // fall-through
+        case 'n': cs.colType = sql::ColType{"DOUBLE", MYSQL_TYPE_DOUBLE}; break;
+        case 's': cs.colType = sql::ColType{"CHAR(8)", MYSQL_TYPE_STRING}; break;
+        case 't': cs.colType = sql::ColType{"TEXT", MYSQL_TYPE_BLOB}; break;
+        default:
+            throw std::invalid_argument("SyntheticResult: unknown type in mix " + mix);
+        }
+        _schema.columns.push_back(cs);
+    }
+
+    Rng rng(seed);
+    _values.reserve(static_cast<size_t>(rows) * cols);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            switch (mix[c % mix.size()]) {
+            case 'i':
+                _values.push_back(std::to_string(386942193651347ULL + rng() % 1000000000));
+                break;
+            case 'd':
+                _values.push_back(formatDouble(uniform(rng, -90.0, 360.0)));
+                break;
+            case 'n':
+                if (rng() % 4 == 0) {
+                    _values.push_back(std::string());
+                    _fields.push_back(nullptr);
+                    _lengths.push_back(0);
+                    continue;
+                }
+                _values.push_back(formatDouble(uniform(rng, 0.0, 1e-28)));
+                break;
+            case 's':
+                _values.push_back(filters[rng() % 6]);
+                break;
+            case 't':
+                _values.push_back(makeText(rng));
+                break;
+            }
+            _fields.push_back(&_values.back()[0]); // fixed below, _values may move
+            _lengths.push_back(_values.back().size());
+            _bytes += _values.back().size();
+        }
+    }
+    for (size_t j = 0; j < _fields.size(); ++j) {
+        if (_fields[j] != nullptr) _fields[j] = &_values[j][0];
+    }
+}
+
+
+mysql::Row SyntheticResult::getRow(int i) {
+    auto offset = static_cast<size_t>(i) * _cols;
+    return mysql::Row(&_fields[offset], &_lengths[offset], _cols);
+}
+
+
+void SyntheticResult::fillSchema(proto::Result& result) const {
+    for (auto const& col : _schema.columns) {
+        proto::ColumnSchema* cs = result.mutable_rowschema()->add_columnschema();
+        cs->set_name(col.name);
+        cs->set_hasdefault(false);
+        cs->clear_defaultvalue();
+        cs->set_sqltype(col.colType.sqlType);
+        cs->set_mysqltype(col.colType.mysqlType);
+    }
+}
+
+
+std::uint64_t SyntheticResult::fillRows(proto::Result& result, int begin, int end) {
+    std::uint64_t size = 0;
+    for (int r = begin; r < end; ++r) {
+        mysql::Row row = getRow(r);
+        proto::RowBundle* rawRow = result.add_row();
+        for (int i = 0; i < row.numFields; ++i) {
+            if (row.row[i]) {
+                rawRow->add_column(row.row[i], row.lengths[i]);
+                rawRow->add_isnull(false);
+            } else {
+                rawRow->add_column();
+                rawRow->add_isnull(true);
+            }
+        }
+        size += rawRow->ByteSize();
+    }
+    return size;
+}
+
+}}} // namespace lsst::qserv::bench
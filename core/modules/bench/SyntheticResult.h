@@ -0,0 +1,91 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_BENCH_SYNTHETICRESULT_H
+#define LSST_QSERV_BENCH_SYNTHETICRESULT_H
+
+// System headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "mysql/RowBuffer.h"
+#include "proto/worker.pb.h"
+#include "sql/Schema.h"
+
+namespace lsst {
+namespace qserv {
+namespace bench {
+
+/// SyntheticResult is a result set, as a worker gets it from mysqld, made
+/// of pseudo-random values that only depend on its parameters, so that
+/// benchmark runs on different builds and hosts process the same bytes.
+///
+/// The type mix is a string with one letter per column type, repeated over
+/// the columns:
+///   i  BIGINT, such as an objectId
+///   d  DOUBLE, such as a coordinate or a flux
+///   s  short CHAR, such as a filter name
+///   t  TEXT with tabs, newlines and backslashes, which have to be escaped
+///   n  DOUBLE that is NULL one time in four
+/// For example "iddddn" looks like a typical Object table selection.
+class SyntheticResult {
+public:
+    /// @throws std::invalid_argument if 'mix' is empty or has an unknown type.
+    SyntheticResult(int rows, int cols, std::string const& mix, unsigned seed);
+    SyntheticResult(SyntheticResult const&) = delete;
+    SyntheticResult& operator=(SyntheticResult const&) = delete;
+
+    int getNumRows() const { return _rows; }
+    int getNumFields() const { return _cols; }
+
+    /// @return row 'i' the way mysql_fetch_row() and mysql_fetch_lengths()
+    ///         present it. It is valid while this object lives.
+    mysql::Row getRow(int i);
+
+    /// @return the number of bytes of the values, not counting NULLs.
+    std::uint64_t getBytes() const { return _bytes; }
+
+    sql::Schema const& getSchema() const { return _schema; }
+
+    /// Fill the schema of 'result' as the worker does from a MYSQL_RES.
+    void fillSchema(proto::Result& result) const;
+
+    /// Add rows [begin, end) to 'result', the way QueryRunner::_fillRows()
+    /// does from a MYSQL_RES.
+    /// @return the serialized size of the rows added.
+    std::uint64_t fillRows(proto::Result& result, int begin, int end);
+
+private:
+    int _rows;
+    int _cols;
+    sql::Schema _schema;
+    std::vector<std::string> _values;  ///< row-major, empty for NULL
+    std::vector<char*> _fields;        ///< row-major, nullptr for NULL
+    std::vector<unsigned long> _lengths;
+    std::uint64_t _bytes{0};
+};
+
+}}} // namespace lsst::qserv::bench
+
+#endif // LSST_QSERV_BENCH_SYNTHETICRESULT_H
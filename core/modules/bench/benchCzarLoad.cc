@@ -0,0 +1,226 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/**
+ * @file
+ *
+ * @brief Load generator for the czar result path: queries run concurrently
+ * through the czar pipeline, Executive, MergingHandler and InfileMerger into
+ * a local mysqld, against simulated workers (see bench::SimWorkers) that
+ * XrdSsiServiceMock calls in place of xrootd.
+ *
+ * Usage:
+ *   benchCzarLoad --socket=/path/mysql.sock [--user=qsmaster --password= --db=qservResult]
+ *                 [--queries=100 --concurrency=4 --chunks=100]
+ *                 [--workers=10 --workerThreads=8 --latencyMs=50 --mbPerSec=0
+ *                  --failRate=0 --rows=1000 --cols=8 --mix=iddddn --seed=1]
+ *
+ * Each of --concurrency threads runs queries one after the other, until
+ * --queries have run. A query has a job on each of --chunks chunks; each job
+ * returns --rows rows after its latency, and a fraction --failRate of the
+ * jobs fail part way through their result, which fails their query.
+ *
+ * The results are written as JSON objects, one per line: the totals, with
+ * the sustained queries per second and merge throughput, then the
+ * distributions of the time to the first result byte, and of the query time.
+ */
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "bench/Bench.h"
+#include "bench/SimWorkers.h"
+#include "ccontrol/MergingHandler.h"
+#include "ccontrol/TmpTableName.h"
+#include "global/MsgReceiver.h"
+#include "global/ResourceUnit.h"
+#include "mysql/MySqlConfig.h"
+#include "qdisp/Executive.h"
+#include "qdisp/JobDescription.h"
+#include "qdisp/MessageStore.h"
+#include "qdisp/XrdSsiMocks.h"
+#include "rproc/InfileMerger.h"
+#include "sql/SqlConnection.h"
+#include "sql/SqlErrorObject.h"
+
+using namespace lsst::qserv;
+
+namespace {
+
+using Clock = bench::SimWorkers::Clock;
+
+double seconds(Clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+/// Ignores the messages of the jobs, the czar only shows them to the user.
+class NullMsgReceiver : public MsgReceiver {
+public:
+    void operator()(int code, std::string const& msg) override {}
+};
+
+/// Times of a query, in seconds.
+struct QueryTimes {
+    double firstByte;  ///< until the first result byte, < 0 if none came
+    double total;      ///< until the result is merged
+    bool success;
+};
+
+/// Run query 'queryNum' as UserQuerySelect::submit() and join() do, with
+/// one job per chunk, and drop its result table.
+QueryTimes runQuery(int queryNum, int chunks, mysql::MySqlConfig const& mySqlConfig,
+                    bench::SimWorkers& workers, sql::SqlConnection& sqlConn) {
+    auto const start = Clock::now();
+    rproc::InfileMergerConfig mergerConfig(mySqlConfig);
+    mergerConfig.targetTable = mySqlConfig.dbName + ".benchCzarLoad_" + std::to_string(queryNum);
+    auto merger = std::make_shared<rproc::InfileMerger>(mergerConfig);
+    auto executive = std::make_shared<qdisp::Executive>(
+            std::make_shared<qdisp::Executive::Config>(qdisp::Executive::Config::getMockStr()),
+            std::make_shared<qdisp::MessageStore>());
+    executive->setQueryId(queryNum);
+    auto receiver = std::make_shared<NullMsgReceiver>();
+    ccontrol::TmpTableName ttn(queryNum, "benchCzarLoad");
+    for (int chunkId = 0; chunkId < chunks; ++chunkId) {
+        auto handler = std::make_shared<ccontrol::MergingHandler>(receiver, merger, ttn.make(chunkId));
+        ResourceUnit ru;
+        ru.setAsDbChunk("LSST", chunkId);
+        executive->add(qdisp::JobDescription(chunkId, ru, bench::SimWorkers::makePayload(queryNum, chunkId),
+                                             handler));
+    }
+    bool success = executive->join();
+    merger->finalize();
+    auto const end = Clock::now();
+
+    sql::SqlErrorObject errObj;
+    sqlConn.runQuery("DROP TABLE IF EXISTS " + mergerConfig.targetTable, errObj);
+    auto const firstByte = workers.takeFirstByte(queryNum);
+    return QueryTimes{firstByte == Clock::time_point() ? -1 : seconds(firstByte - start),
+                      seconds(end - start), success};
+}
+
+int runLoad(bench::Args const& args) {
+    if (!args.has("socket")) {
+        std::cerr << "--socket is required, the merge needs a local mysqld" << std::endl;
+        return 1;
+    }
+    mysql::MySqlConfig const mySqlConfig(args.get("user", "qsmaster"), args.get("password", ""),
+                                         args.get("socket", ""), args.get("db", "qservResult"));
+    int const queries = args.getInt("queries", 100);
+    int const concurrency = args.getInt("concurrency", 4);
+    int const chunks = args.getInt("chunks", 100);
+
+    bench::SimWorkersConfig config;
+    config.workers = args.getInt("workers", config.workers);
+    config.threadsPerWorker = args.getInt("workerThreads", config.threadsPerWorker);
+    config.latencyMs = std::stod(args.get("latencyMs", std::to_string(config.latencyMs)));
+    config.mbPerSec = std::stod(args.get("mbPerSec", std::to_string(config.mbPerSec)));
+    config.failRate = std::stod(args.get("failRate", std::to_string(config.failRate)));
+    config.rows = args.getInt("rows", config.rows);
+    config.cols = args.getInt("cols", config.cols);
+    config.mix = args.get("mix", config.mix);
+    config.seed = args.getInt("seed", config.seed);
+    bench::SimWorkers workers(config);
+    qdisp::XrdSsiServiceMock::setResponder(
+        [&workers](std::string const& payload, qdisp::ResponseHandler& handler) {
+            return workers.respond(payload, handler);
+        });
+
+    std::atomic<int> nextQuery{0};
+    std::mutex timesMtx;
+    std::vector<QueryTimes> times;
+    std::string error;
+    auto const start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < concurrency; ++t) {
+        threads.emplace_back([&]() {
+            sql::SqlConnection sqlConn(mySqlConfig);
+            try {
+                for (int q = nextQuery++; q < queries; q = nextQuery++) {
+                    QueryTimes queryTimes = runQuery(q, chunks, mySqlConfig, workers, sqlConn);
+                    std::lock_guard<std::mutex> lock(timesMtx);
+                    times.push_back(queryTimes);
+                }
+            } catch (std::exception const& exc) {
+                std::lock_guard<std::mutex> lock(timesMtx);
+                error = exc.what();
+                nextQuery = queries;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double const wallSec = seconds(Clock::now() - start);
+    qdisp::XrdSsiServiceMock::setResponder(nullptr);
+    if (!error.empty()) {
+        std::cerr << "benchCzarLoad: " << error << std::endl;
+        return 1;
+    }
+
+    std::vector<double> firstBytes;
+    std::vector<double> totals;
+    int failed = 0;
+    for (auto const& queryTimes : times) {
+        if (!queryTimes.success) {
+            ++failed;
+            continue;
+        }
+        if (queryTimes.firstByte >= 0) firstBytes.push_back(queryTimes.firstByte);
+        totals.push_back(queryTimes.total);
+    }
+    auto const counts = workers.getCounts();
+    std::cout << "{\"load\":\"total\",\"queries\":" << times.size()
+              << ",\"concurrency\":" << concurrency << ",\"chunks\":" << chunks
+              << ",\"workers\":" << config.workers << ",\"workerThreads\":" << config.threadsPerWorker
+              << ",\"latencyMs\":" << config.latencyMs << ",\"failRate\":" << config.failRate
+              << ",\"rows\":" << config.rows << ",\"cols\":" << config.cols << ",\"mix\":\"" << config.mix << "\""
+              << ",\"failedQueries\":" << failed << ",\"jobs\":" << counts.jobs
+              << ",\"failedJobs\":" << counts.failures << ",\"bytes\":" << counts.bytes
+              << ",\"wallSec\":" << wallSec
+              << ",\"queriesPerSec\":" << (wallSec > 0 ? times.size() / wallSec : 0)
+              << ",\"mergeMbPerSec\":" << (wallSec > 0 ? counts.bytes / wallSec / 1e6 : 0)
+              << "}\n";
+    std::cout << "{\"load\":\"firstByte\"";
+    bench::writeDistribution(std::cout, "sec", firstBytes);
+    std::cout << "}\n{\"load\":\"query\"";
+    bench::writeDistribution(std::cout, "sec", totals);
+    std::cout << "}" << std::endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char const* const* argv) {
+    try {
+        bench::Args args(argc, argv);
+        return runLoad(args);
+    } catch (std::exception const& exc) {
+        std::cerr << argv[0] << ": " << exc.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,317 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/**
+ * @file
+ *
+ * @brief Benchmark of the czar query planning, stage by stage, over the
+ * LSST partitioning:
+ *
+ *   analyze    parse and analyze the query, QuerySession::analyzeQuery
+ *   chunks     find the chunks it covers, IndexMap::getChunks or getAllChunks
+ *   generate   build the chunk queries, QuerySession::Iter and QueryMapping::apply
+ *   serialize  serialize and check the TaskMsg of each chunk, TaskMsgFactory::serializeMsg
+ *   plan       all of the above, as UserQueryFactory and UserQuerySelect run them
+ *
+ * Usage:
+ *   benchPlanning [--kvmap=core/modules/qproc/testMap.kvmap] [--db=LSST]
+ *                 [--stripes=340 --subStripes=12] [--emptyChunks=.]
+ *                 [--iters=10] [--warmup=1] [--bench=analyze,chunks,...]
+ *                 [--query=objectPoint,coneSearch,...]
+ *
+ * The CSS is read from a key-value map, such as the testMap.kvmap and
+ * testPlugins.kvmap fixtures, with the striping of every partitioning
+ * replaced by --stripes and --subStripes. The queries are the shapes of the
+ * LSST data challenge queries, on the tables and columns of the fixtures;
+ * the secondary index is the fake one of qproc::SecondaryIndex. Empty chunks
+ * are read from --emptyChunks, none if the file is missing.
+ *
+ * Each benchmark writes one JSON object on a line of the standard output,
+ * with the query and the number of chunks it covers, the distribution of the
+ * time of one iteration and its mean allocations. Each iteration plans the
+ * query over all the chunks it covers. The analyze and plan benchmarks also
+ * report the query:: objects allocated by the analysis of the query, in the
+ * arena of its QuerySession: arenaAllocs, arenaBytes and arenaBlocks.
+ */
+
+// System headers
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+// Qserv headers
+#include "bench/Bench.h"
+#include "ccontrol/TmpTableName.h"
+#include "css/CssAccess.h"
+#include "global/intTypes.h"
+#include "proto/ProtoImporter.h"
+#include "proto/worker.pb.h"
+#include "qproc/ChunkQuerySpec.h"
+#include "qproc/IndexMap.h"
+#include "qproc/QuerySession.h"
+#include "qproc/SecondaryIndex.h"
+#include "qproc/TaskMsgFactory.h"
+#include "util/Arena.h"
+
+using namespace lsst::qserv;
+
+namespace {
+
+struct QueryShape {
+    char const* name;
+    char const* sql;
+};
+
+QueryShape const corpus[] = {
+    {"objectPoint",
+     "SELECT * FROM Object WHERE objectIdObjTest = 430213989000"},
+    {"objectList",
+     "SELECT * FROM Object WHERE objectIdObjTest IN (386942193651347, 386942193651348, 386950783579546)"},
+    {"sourcesOfObject",
+     "SELECT * FROM Source WHERE objectIdSourceTest = 430213989000"},
+    {"coneSearch",
+     "SELECT objectIdObjTest, ra_Test, decl_Test, rFlux_PS FROM Object "
+     "WHERE qserv_areaspec_circle(1.2, 3.2, 0.05)"},
+    {"smallAreaCount",
+     "SELECT COUNT(*) FROM Object WHERE qserv_areaspec_box(0.1, -6, 4, 6) AND rFlux_PS > 0.01"},
+    {"largeAreaFilter",
+     "SELECT objectIdObjTest, ra_Test, decl_Test FROM Object "
+     "WHERE qserv_areaspec_box(0, -30, 90, 30) AND rFlux_PS BETWEEN 0.01 AND 0.02"},
+    {"fullScanFilter",
+     "SELECT objectIdObjTest, ra_Test, decl_Test FROM Object WHERE rFlux_PS > 0.05 AND gFlux_PS < 0.01"},
+    {"fullScanAggregate",
+     "SELECT COUNT(*) AS n, AVG(ra_Test), AVG(decl_Test), _chunkId FROM Object GROUP BY _chunkId"},
+    {"fullScanOrderBy",
+     "SELECT objectIdObjTest, iFlux_PS FROM Object WHERE iFlux_PS > 0.4 ORDER BY iFlux_PS LIMIT 100"},
+    {"objectSourceJoin",
+     "SELECT o.objectIdObjTest, s.psfFlux FROM Object o, Source s "
+     "WHERE qserv_areaspec_box(2, 2, 3, 3) AND o.objectIdObjTest = s.objectIdSourceTest"},
+    {"nearNeighbor",
+     "SELECT COUNT(*) FROM Object o1, Object o2 WHERE qserv_areaspec_box(6, 6, 7, 7) "
+     "AND scisql_angSep(o1.ra_Test, o1.decl_Test, o2.ra_Test, o2.decl_Test) < 0.001"},
+    {"nonPartitioned",
+     "SELECT * FROM Filter WHERE filterId = 4"},
+};
+
+/// @return 'kvMap' with the number of stripes and sub-stripes of every
+///         partitioning replaced.
+std::string restripe(std::string const& kvMap, int stripes, int subStripes) {
+    auto endsWith = [](std::string const& key, std::string const& suffix) {
+        return key.size() >= suffix.size()
+            && key.compare(key.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    std::istringstream is(kvMap);
+    std::ostringstream os;
+    std::string line;
+    while (std::getline(is, line)) {
+        std::string const key = line.substr(0, line.find('\t'));
+        if (endsWith(key, "/nStripes")) {
+            line = key + "\t" + std::to_string(stripes);
+        } else if (endsWith(key, "/nSubStripes")) {
+            line = key + "\t" + std::to_string(subStripes);
+        }
+        os << line << "\n";
+    }
+    return os.str();
+}
+
+/// Analyze 'sql' in a new QuerySession, as UserQueryFactory::newUserQuery().
+std::shared_ptr<qproc::QuerySession> analyze(qproc::QuerySession::Test& qsTest,
+                                             std::string const& sql) {
+    auto qs = std::make_shared<qproc::QuerySession>(qsTest);
+    qs->analyzeQuery(sql);
+    if (!qs->getError().empty()) {
+        throw std::runtime_error("Invalid query: " + qs->getError());
+    }
+    return qs;
+}
+
+/// @return the chunks covered by the query of 'qs', as UserQuerySelect::setupChunking().
+qproc::ChunkSpecVector findChunks(qproc::QuerySession& qs,
+                                  std::shared_ptr<qproc::SecondaryIndex> const& secondaryIndex) {
+    if (!qs.hasChunks()) {
+        return qproc::ChunkSpecVector();
+    }
+    qproc::IndexMap im(qs.getDbStriping(), secondaryIndex);
+    auto constraints = qs.getConstraints();
+    return constraints ? im.getChunks(*constraints) : im.getAllChunks();
+}
+
+/// Add the chunks of 'csv' that are not empty to 'qs', and finalize it.
+void addChunks(qproc::QuerySession& qs, qproc::ChunkSpecVector const& csv, IntSet const& emptyChunks) {
+    for (auto const& cs : csv) {
+        if (emptyChunks.count(cs.chunkId) == 0) {
+            qs.addChunk(cs);
+        }
+    }
+    qs.finalize();
+}
+
+/// Serialize and check the TaskMsg of 'spec', as UserQuerySelect::submit().
+/// @return the size of the message.
+std::uint64_t serialize(qproc::TaskMsgFactory& factory, ccontrol::TmpTableName& ttn,
+                        proto::ProtoImporter<proto::TaskMsg>& pi,
+                        qproc::ChunkQuerySpec const& spec, int jobId) {
+    std::ostringstream os;
+    factory.serializeMsg(spec, ttn.make(spec.chunkId), 1, jobId, os);
+    std::string const msg = os.str();
+    if (!pi(msg.data(), msg.size())) {
+        throw std::runtime_error("Error serializing TaskMsg");
+    }
+    return msg.size();
+}
+
+int runBenchmarks(bench::Args const& args) {
+    std::string const kvMapPath = args.get("kvmap", "core/modules/qproc/testMap.kvmap");
+    int const stripes = args.getInt("stripes", 340);
+    int const subStripes = args.getInt("subStripes", 12);
+    int const iters = args.getInt("iters", 10);
+    int const warmup = args.getInt("warmup", 1);
+    auto const names = args.getSet("bench", "analyze,chunks,generate,serialize,plan");
+    auto wanted = [&names](std::string const& name) { return names.count(name) > 0; };
+    auto const queries = args.getSet("query", "");
+
+    std::ifstream kvMapStream(kvMapPath);
+    if (!kvMapStream) {
+        std::cerr << "cannot read " << kvMapPath << std::endl;
+        return 1;
+    }
+    std::ostringstream kvMap;
+    kvMap << kvMapStream.rdbuf();
+    qproc::QuerySession::Test qsTest;
+    qsTest.cfgNum = 0;
+    qsTest.defaultDb = args.get("db", "LSST");
+    qsTest.css = css::CssAccess::createFromData(restripe(kvMap.str(), stripes, subStripes),
+                                                args.get("emptyChunks", "."));
+    auto const secondaryIndex = std::make_shared<qproc::SecondaryIndex>();
+
+    for (auto const& shape : corpus) {
+        if (!queries.empty() && queries.count(shape.name) == 0) {
+            continue;
+        }
+        std::string const sql = shape.sql;
+
+        // Inputs of the later stages, built once.
+        auto qs = analyze(qsTest, sql);
+        auto const csv = findChunks(*qs, secondaryIndex);
+        IntSet emptyChunks;
+        if (qs->hasChunks()) {
+            try {
+                emptyChunks = *qs->getEmptyChunks();
+            } catch (std::exception const&) {
+                // No empty chunks file, plan on all chunks.
+            }
+        }
+        addChunks(*qs, csv, emptyChunks);
+        std::vector<qproc::ChunkQuerySpec> specs;
+        for (auto i = qs->cQueryBegin(), e = qs->cQueryEnd(); i != e; ++i) {
+            specs.push_back(*i);
+        }
+
+        bench::Bench::Params const params = {
+            {"query", shape.name}, {"kvmap", kvMapPath},
+            {"stripes", std::to_string(stripes)}, {"subStripes", std::to_string(subStripes)},
+            {"chunks", std::to_string(specs.size())}};
+        // Arena statistics of the last QuerySession analyzed by a benchmark.
+        util::Arena::Stats arena;
+        auto runOne = [&](std::string const& name, std::function<void()> const& func,
+                          std::uint64_t bytes, bool hasArena) {
+            bench::Bench bench("planning." + name, params, iters, warmup);
+            bench.run(func, bytes);
+            if (hasArena) {
+                bench.setCounter("arenaAllocs", arena.allocs);
+                bench.setCounter("arenaBytes", arena.bytes);
+                bench.setCounter("arenaBlocks", arena.blocks);
+            }
+            bench.write(std::cout);
+        };
+
+        if (wanted("analyze")) {
+            runOne("analyze", [&]() { arena = analyze(qsTest, sql)->getArenaStats(); },
+                   sql.size(), true);
+        }
+        if (wanted("chunks")) {
+            runOne("chunks", [&]() { findChunks(*qs, secondaryIndex); }, 0, false);
+        }
+        std::uint64_t queryBytes = 0;
+        for (auto const& spec : specs) {
+            for (auto const& query : spec.queries) queryBytes += query.size();
+        }
+        if (wanted("generate")) {
+            runOne("generate", [&]() {
+                for (auto i = qs->cQueryBegin(), e = qs->cQueryEnd(); i != e; ++i) {
+                    if (i->queries.empty()) throw std::runtime_error("No chunk query");
+                }
+            }, queryBytes, false);
+        }
+        if (wanted("serialize") || wanted("plan")) {
+            // Message sizes, for the throughput.
+            qproc::TaskMsgFactory factory(1);
+            ccontrol::TmpTableName ttn(1, sql);
+            proto::ProtoImporter<proto::TaskMsg> pi;
+            std::uint64_t msgBytes = 0;
+            int jobId = 0;
+            for (auto const& spec : specs) {
+                msgBytes += serialize(factory, ttn, pi, spec, jobId++);
+            }
+            if (wanted("serialize")) {
+                runOne("serialize", [&]() {
+                    qproc::TaskMsgFactory factory(1);
+                    ccontrol::TmpTableName ttn(1, sql);
+                    proto::ProtoImporter<proto::TaskMsg> pi;
+                    int jobId = 0;
+                    for (auto const& spec : specs) {
+                        serialize(factory, ttn, pi, spec, jobId++);
+                    }
+                }, msgBytes, false);
+            }
+            if (wanted("plan")) {
+                runOne("plan", [&]() {
+                    auto planned = analyze(qsTest, sql);
+                    addChunks(*planned, findChunks(*planned, secondaryIndex), emptyChunks);
+                    qproc::TaskMsgFactory factory(1);
+                    ccontrol::TmpTableName ttn(1, sql);
+                    proto::ProtoImporter<proto::TaskMsg> pi;
+                    int jobId = 0;
+                    for (auto i = planned->cQueryBegin(), e = planned->cQueryEnd(); i != e; ++i) {
+                        serialize(factory, ttn, pi, *i, jobId++);
+                    }
+                    arena = planned->getArenaStats();
+                }, msgBytes, true);
+            }
+        }
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char const* const* argv) {
+    try {
+        bench::Args args(argc, argv);
+        return runBenchmarks(args);
+    } catch (std::exception const& exc) {
+        std::cerr << argv[0] << ": " << exc.what() << std::endl;
+        return 2;
+    }
+}
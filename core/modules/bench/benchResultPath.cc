@@ -0,0 +1,227 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/**
+ * @file
+ *
+ * @brief Micro-benchmarks of the result path, from the rows a worker gets
+ * from mysqld to the rows the czar loads in its result table:
+ *
+ *   fillRows        build the Result message, as QueryRunner::_fillRows
+ *   serialize       serialize the Result message, as QueryRunner::_transmit
+ *   transmitHeader  hash the message and wrap its header, as QueryRunner::_transmitHeader
+ *   headerWrap      ProtoHeaderWrap::wrap and unwrap of the header alone
+ *   decode          unwrap, verify and parse the message, as MergingHandler::flush
+ *   fetch           escape the rows to LOAD DATA format with ProtoRowBuffer::fetch
+ *   infileRead      stream the escaped rows through LocalInfile::read
+ *   infileMerge     LOAD DATA LOCAL INFILE the rows into a local mysqld,
+ *                   only run when --socket is given
+ *
+ * Usage:
+ *   benchResultPath [--rows=10000] [--cols=8] [--mix=iddddn] [--seed=1]
+ *                   [--iters=50] [--warmup=5] [--bench=fillRows,decode,...]
+ *                   [--socket=/path/mysql.sock --user=qsmaster --password= --db=qservResult]
+ *
+ * Each benchmark writes one JSON object on a line of the standard output,
+ * with its parameters, the distribution of the time of one iteration and
+ * its mean allocations, so that successive results can be collected and compared by scripts.
+ * Each iteration processes the whole result set.
+ */
+
+// System headers
+#include <iostream>
+#include <stdexcept>
+
+// Qserv headers
+#include "bench/Bench.h"
+#include "bench/SyntheticResult.h"
+#include "mysql/LocalInfile.h"
+#include "mysql/MySqlConfig.h"
+#include "mysql/MySqlConnection.h"
+#include "proto/ProtoHeaderWrap.h"
+#include "proto/ProtoImporter.h"
+#include "proto/WorkerResponse.h"
+#include "proto/worker.pb.h"
+#include "rproc/ProtoRowBuffer.h"
+#include "sql/statement.h"
+#include "util/StringHash.h"
+
+using namespace lsst::qserv;
+
+namespace {
+
+/// Build a Result message from all the rows of 'res', the way
+/// QueryRunner::_fillRows() does from a MYSQL_RES.
+void fillResult(bench::SyntheticResult& res, proto::Result& result) {
+    result.set_continues(0);
+    res.fillSchema(result);
+    std::uint64_t size = res.fillRows(result, 0, res.getNumRows());
+    if (size > proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT) {
+        // The worker would have split the result in several messages.
+        std::cerr << "warning: the result is larger than one message, "
+                  << size << " bytes" << std::endl;
+    }
+}
+
+/// @return the wrapped header of 'msg', the way QueryRunner::_transmitHeader() makes it.
+std::string makeHeader(proto::ProtoHeader& protoHeader, std::string const& msg) {
+    protoHeader.set_protocol(2);
+    protoHeader.set_size(msg.size());
+    protoHeader.set_md5(util::StringHash::getMd5(msg.data(), msg.size()));
+    protoHeader.set_wname("bench-worker");
+    std::string protoHeaderString;
+    protoHeader.SerializeToString(&protoHeaderString);
+    return proto::ProtoHeaderWrap::wrap(protoHeaderString);
+}
+
+/// Decode 'header' and 'msg', the way MergingHandler::flush() does.
+void decode(std::vector<char>& header, std::vector<char>& msg) {
+    auto response = std::make_shared<proto::WorkerResponse>();
+    if (!proto::ProtoHeaderWrap::unwrap(response, header)) {
+        throw std::runtime_error("decode: bad header");
+    }
+    if (response->protoHeader.md5() != util::StringHash::getMd5(msg.data(), msg.size())) {
+        throw std::runtime_error("decode: md5 mismatch");
+    }
+    if (!proto::ProtoImporter<proto::Result>::setMsgFrom(response->result, &msg[0], msg.size())) {
+        throw std::runtime_error("decode: bad result message");
+    }
+}
+
+/// @return the number of bytes fetched from 'rowBuffer', 'buf' at a time.
+std::uint64_t drain(mysql::RowBuffer& rowBuffer, std::vector<char>& buf) {
+    std::uint64_t total = 0;
+    while (unsigned fetched = rowBuffer.fetch(&buf[0], buf.size())) {
+        total += fetched;
+    }
+    return total;
+}
+
+int runBenchmarks(bench::Args const& args) {
+    int const rows = args.getInt("rows", 10000);
+    int const cols = args.getInt("cols", 8);
+    std::string const mix = args.get("mix", "iddddn");
+    unsigned const seed = args.getInt("seed", 1);
+    int const iters = args.getInt("iters", 50);
+    int const warmup = args.getInt("warmup", 5);
+    auto const names = args.getSet("bench", "fillRows,serialize,transmitHeader,"
+                                    "headerWrap,decode,fetch,infileRead,infileMerge");
+    auto wanted = [&names](std::string const& name) { return names.count(name) > 0; };
+
+    bench::SyntheticResult res(rows, cols, mix, seed);
+    bench::Bench::Params const params = {
+        {"rows", std::to_string(rows)}, {"cols", std::to_string(cols)},
+        {"mix", mix}, {"seed", std::to_string(seed)}};
+    auto runOne = [&](std::string const& name, std::function<void()> const& func,
+                      std::uint64_t bytes) {
+        bench::Bench bench(name, params, iters, warmup);
+        bench.run(func, bytes);
+        bench.write(std::cout);
+    };
+
+    // Inputs of the later steps, built once.
+    proto::Result result;
+    fillResult(res, result);
+    std::string msg;
+    result.SerializeToString(&msg);
+    proto::ProtoHeader protoHeader;
+    std::string header = makeHeader(protoHeader, msg);
+    std::vector<char> headerBuf(header.begin(), header.end());
+    std::vector<char> msgBuf(msg.begin(), msg.end());
+
+    if (wanted("fillRows")) {
+        // The worker builds each message in a new Result.
+        runOne("fillRows", [&]() { proto::Result out; fillResult(res, out); }, res.getBytes());
+    }
+    if (wanted("serialize")) {
+        std::string out;
+        runOne("serialize", [&]() { out.clear(); result.SerializeToString(&out); }, msg.size());
+    }
+    if (wanted("transmitHeader")) {
+        proto::ProtoHeader ph;
+        runOne("transmitHeader", [&]() { makeHeader(ph, msg); }, msg.size());
+    }
+    if (wanted("headerWrap")) {
+        std::string phString;
+        protoHeader.SerializeToString(&phString);
+        auto response = std::make_shared<proto::WorkerResponse>();
+        runOne("headerWrap", [&]() {
+            auto wrapped = proto::ProtoHeaderWrap::wrap(phString);
+            std::vector<char> buf(wrapped.begin(), wrapped.end());
+            proto::ProtoHeaderWrap::unwrap(response, buf);
+        }, proto::ProtoHeaderWrap::PROTO_HEADER_SIZE);
+    }
+    if (wanted("decode")) {
+        runOne("decode", [&]() { decode(headerBuf, msgBuf); }, msg.size());
+    }
+
+    // Size of the LOAD DATA stream, to report the escaping throughput.
+    std::vector<char> fetchBuf(16*1024);
+    std::uint64_t infileBytes = drain(*rproc::newProtoRowBuffer(result), fetchBuf);
+    if (wanted("fetch")) {
+        runOne("fetch", [&]() { drain(*rproc::newProtoRowBuffer(result), fetchBuf); }, infileBytes);
+    }
+    if (wanted("infileRead")) {
+        runOne("infileRead", [&]() {
+            mysql::LocalInfile infile("bench", rproc::newProtoRowBuffer(result));
+            while (infile.read(&fetchBuf[0], fetchBuf.size()) > 0) {
+            }
+        }, infileBytes);
+    }
+    if (wanted("infileMerge") && args.has("socket")) {
+        mysql::MySqlConfig config(args.get("user", "qsmaster"), args.get("password", ""),
+                                  args.get("socket", ""), args.get("db", "qservResult"));
+        mysql::MySqlConnection conn(config);
+        if (!conn.connect()) {
+            std::cerr << "infileMerge: cannot connect to " << config << std::endl;
+            return 1;
+        }
+        mysql::LocalInfile::Mgr infileMgr;
+        infileMgr.attach(conn.getMySql());
+        std::string const table = "benchResultPath";
+        auto apply = [&conn](std::string const& stmt) {
+            if (mysql_real_query(conn.getMySql(), stmt.data(), stmt.size()) != 0) {
+                throw std::runtime_error("infileMerge: " + conn.getError() + " in " + stmt);
+            }
+        };
+        apply("DROP TABLE IF EXISTS " + table);
+        apply(sql::formCreateTable(table, res.getSchema()) + " ENGINE=MyISAM");
+        runOne("infileMerge", [&]() {
+            std::string virtFile = infileMgr.prepareSrc(rproc::newProtoRowBuffer(result));
+            apply(sql::formLoadInfile(table, virtFile));
+        }, infileBytes);
+        apply("DROP TABLE " + table);
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char const* const* argv) {
+    try {
+        bench::Args args(argc, argv);
+        return runBenchmarks(args);
+    } catch (std::exception const& exc) {
+        std::cerr << argv[0] << ": " << exc.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,119 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/**
+ * @file
+ *
+ * @brief Replay a worker workload through the worker schedulers in
+ * simulated time, see bench::SchedSim, to compare scheduler settings
+ * offline.
+ *
+ * Usage:
+ *   benchScheduler [--trace=tasks.csv] [scheduler settings]
+ *   benchScheduler [--chunks=200 --scans=20 --scanInterval=60
+ *                   --interactive=200 --interactiveInterval=3 --seed=1]
+ *                  [--genTrace] [scheduler settings]
+ *
+ * With --trace, the Tasks are read from a CSV file (see bench::readTrace),
+ * "-" for the standard input. Otherwise a synthetic workload is made from
+ * the other options; --genTrace writes it as a trace instead of running it.
+ *
+ * Scheduler settings, as in the worker configuration:
+ *   --pool=20 --groupSize=1 --priorityFast=3 --priorityMed=2 --prioritySlow=1
+ *   --reserveFast=2 --reserveMed=2 --reserveSlow=2 --maxActiveChunks=20
+ *   --relaxReserve=0 --memMb=8000 --tableMb=100 --starveSec=600
+ *
+ * The results are written as JSON objects, one per line, see SchedSim::writeReport().
+ */
+
+// System headers
+#include <fstream>
+#include <iostream>
+
+// Qserv headers
+#include "bench/Bench.h"
+#include "bench/SchedSim.h"
+
+using namespace lsst::qserv;
+
+namespace {
+
+int runSimulation(bench::Args const& args) {
+    std::vector<bench::SimTask> tasks;
+    std::string const traceFile = args.get("trace", "");
+    if (traceFile == "-") {
+        tasks = bench::readTrace(std::cin);
+    } else if (!traceFile.empty()) {
+        std::ifstream is(traceFile);
+        if (!is) {
+            std::cerr << "cannot read " << traceFile << std::endl;
+            return 1;
+        }
+        tasks = bench::readTrace(is);
+    } else {
+        bench::WorkloadConfig workload;
+        workload.chunks = args.getInt("chunks", workload.chunks);
+        workload.scans = args.getInt("scans", workload.scans);
+        workload.scanInterval = std::stod(args.get("scanInterval", std::to_string(workload.scanInterval)));
+        workload.interactive = args.getInt("interactive", workload.interactive);
+        workload.interactiveInterval = std::stod(args.get("interactiveInterval",
+                                                          std::to_string(workload.interactiveInterval)));
+        workload.seed = args.getInt("seed", workload.seed);
+        tasks = bench::makeWorkload(workload);
+        if (args.has("genTrace")) {
+            bench::writeTrace(std::cout, tasks);
+            return 0;
+        }
+    }
+
+    bench::SimConfig config;
+    config.poolSize = args.getInt("pool", config.poolSize);
+    config.groupSize = args.getInt("groupSize", config.groupSize);
+    config.priorityFast = args.getInt("priorityFast", config.priorityFast);
+    config.priorityMed = args.getInt("priorityMed", config.priorityMed);
+    config.prioritySlow = args.getInt("prioritySlow", config.prioritySlow);
+    config.reserveFast = args.getInt("reserveFast", config.reserveFast);
+    config.reserveMed = args.getInt("reserveMed", config.reserveMed);
+    config.reserveSlow = args.getInt("reserveSlow", config.reserveSlow);
+    config.maxActiveChunks = args.getInt("maxActiveChunks", config.maxActiveChunks);
+    config.relaxReserve = args.getInt("relaxReserve", 0) != 0;
+    config.memBytes = args.getInt("memMb", config.memBytes/1000000) * 1000000ULL;
+    config.tableBytes = args.getInt("tableMb", config.tableBytes/1000000) * 1000000ULL;
+    config.starveSec = std::stod(args.get("starveSec", std::to_string(config.starveSec)));
+
+    bench::SchedSim sim(config);
+    sim.run(tasks);
+    sim.writeReport(std::cout);
+    return sim.getStuck() > 0 ? 1 : 0;
+}
+
+}
+
+int main(int argc, char const* const* argv) {
+    try {
+        bench::Args args(argc, argv);
+        return runSimulation(args);
+    } catch (std::exception const& exc) {
+        std::cerr << argv[0] << ": " << exc.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,124 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <sstream>
+#include <string>
+
+// Qserv headers
+#include "bench/SchedSim.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE SchedSim
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+namespace bench = lsst::qserv::bench;
+namespace memman = lsst::qserv::memman;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(TraceRoundTrip) {
+    std::istringstream is("arrival,queryId,chunkId,scanRating,runtime,table\n"
+                          "# interactive\n"
+                          "0.5,7,1234,-1,0.25\n"
+                          "1,8,1235,20,12.5,LSST.Source\n");
+    auto tasks = bench::readTrace(is);
+    BOOST_REQUIRE_EQUAL(tasks.size(), 2U);
+    BOOST_CHECK_EQUAL(tasks[0].queryId, 7U);
+    BOOST_CHECK_EQUAL(tasks[0].scanRating, -1);
+    BOOST_CHECK_EQUAL(tasks[1].table, "LSST.Source");
+
+    std::ostringstream os;
+    bench::writeTrace(os, tasks);
+    std::istringstream again(os.str());
+    auto copy = bench::readTrace(again);
+    BOOST_REQUIRE_EQUAL(copy.size(), 2U);
+    BOOST_CHECK_EQUAL(copy[1].runtime, 12.5);
+
+    std::istringstream bad("1,2,3\n");
+    BOOST_CHECK_THROW(bench::readTrace(bad), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(MemManChurn) {
+    bench::SimMemMan memMan(250, 100);
+    std::vector<memman::TableInfo> tables{memman::TableInfo("LSST/Object")};
+    auto h1 = memMan.lock(tables, 1);
+    auto h2 = memMan.lock(tables, 2);
+    BOOST_CHECK(h1 != memman::MemMan::HandleType::INVALID);
+    BOOST_CHECK(h2 != memman::MemMan::HandleType::INVALID);
+    // No room for a third chunk, but the first one is shared.
+    BOOST_CHECK(memMan.lock(tables, 3) == memman::MemMan::HandleType::INVALID);
+    auto h3 = memMan.lock(tables, 1);
+    BOOST_CHECK(memMan.isResident(tables, 1));
+    memMan.unlock(h1);
+    memMan.unlock(h3);
+    BOOST_CHECK(!memMan.isResident(tables, 1));
+    memMan.unlock(memMan.lock(tables, 1));
+    auto churn = memMan.getChurn();
+    BOOST_CHECK_EQUAL(churn.lockCalls, 5U);
+    BOOST_CHECK_EQUAL(churn.lockFailures, 1U);
+    BOOST_CHECK_EQUAL(churn.loads, 3U);
+    BOOST_CHECK_EQUAL(churn.reloads, 1U);
+    BOOST_CHECK_EQUAL(churn.peakBytes, 200U);
+}
+
+BOOST_AUTO_TEST_CASE(Replay) {
+    bench::WorkloadConfig workload;
+    workload.chunks = 20;
+    workload.scans = 4;
+    workload.interactive = 30;
+    auto tasks = bench::makeWorkload(workload);
+    BOOST_CHECK_EQUAL(tasks.size(), 4U*20 + 30);
+
+    bench::SimConfig config;
+    config.poolSize = 10;
+    config.memBytes = 1000;
+    config.tableBytes = 100;
+    bench::SchedSim sim(config);
+    sim.run(tasks);
+    BOOST_CHECK_EQUAL(sim.getStuck(), 0);
+    BOOST_CHECK_EQUAL(sim.getRecords().size(), tasks.size());
+    int interactive = 0;
+    for (auto const& rec : sim.getRecords()) {
+        BOOST_CHECK(rec.start >= rec.arrival);
+        BOOST_CHECK(rec.finish >= rec.start);
+        if (rec.lane == "SchedGroup") ++interactive;
+    }
+    BOOST_CHECK_EQUAL(interactive, 30);
+    BOOST_CHECK(sim.getChurn().loads >= 20U);
+
+    std::ostringstream os;
+    sim.writeReport(os);
+    BOOST_CHECK(os.str().find("{\"sim\":\"total\",\"poolSize\":10,") == 0);
+    BOOST_CHECK(os.str().find("\"lane\":\"SchedGroup\"") != std::string::npos);
+
+    // The same workload gives the same results.
+    bench::SchedSim again(config);
+    again.run(bench::makeWorkload(workload));
+    std::ostringstream os2;
+    again.writeReport(os2);
+    BOOST_CHECK_EQUAL(os.str(), os2.str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
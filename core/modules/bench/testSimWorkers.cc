@@ -0,0 +1,141 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "bench/SimWorkers.h"
+#include "proto/ProtoHeaderWrap.h"
+#include "proto/ProtoImporter.h"
+#include "proto/WorkerResponse.h"
+#include "qdisp/ResponseHandler.h"
+#include "util/StringHash.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE SimWorkers
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+namespace bench = lsst::qserv::bench;
+namespace proto = lsst::qserv::proto;
+namespace qdisp = lsst::qserv::qdisp;
+namespace util = lsst::qserv::util;
+
+namespace {
+
+/// DecodingHandler decodes the stream of a worker, as MergingHandler does,
+/// and counts the rows instead of merging them.
+class DecodingHandler : public qdisp::ResponseHandler {
+public:
+    DecodingHandler() : _buffer(proto::ProtoHeaderWrap::PROTO_HEADER_SIZE) {}
+    std::vector<char>& nextBuffer() override { return _buffer; }
+    bool flush(int bLen, bool& last) override {
+        if (_header) {
+            _response = std::make_shared<proto::WorkerResponse>();
+            if (!proto::ProtoHeaderWrap::unwrap(_response, _buffer)) return false;
+            wname = _response->protoHeader.wname();
+            _buffer.resize(_response->protoHeader.size());
+            _header = false;
+            return true;
+        }
+        if (_response->protoHeader.md5() != util::StringHash::getMd5(_buffer.data(), _buffer.size())) {
+            return false;
+        }
+        if (!proto::ProtoImporter<proto::Result>::setMsgFrom(_response->result, &_buffer[0], _buffer.size())) {
+            return false;
+        }
+        ++messages;
+        rows += _response->result.row_size();
+        if (messages == 1) columns = _response->result.rowschema().columnschema_size();
+        last = !_response->result.continues();
+        _buffer.resize(last ? 0 : proto::ProtoHeaderWrap::PROTO_HEADER_SIZE);
+        _header = true;
+        return true;
+    }
+    void errorFlush(std::string const& msg, int code) override { error = msg; }
+    bool finished() const override { return _buffer.empty(); }
+    bool reset() override { return false; }
+    std::ostream& print(std::ostream& os) const override { return os << "DecodingHandler"; }
+    Error getError() const override { return Error(-1, error); }
+
+    int messages{0};
+    int rows{0};
+    int columns{0};
+    std::string wname;
+    std::string error;
+
+private:
+    std::vector<char> _buffer;
+    bool _header{true};
+    std::shared_ptr<proto::WorkerResponse> _response;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Stream) {
+    bench::SimWorkersConfig config;
+    config.workers = 3;
+    config.latencyMs = 0;
+    config.rows = 30000;
+    bench::SimWorkers workers(config);
+
+    DecodingHandler handler;
+    BOOST_CHECK(workers.respond(bench::SimWorkers::makePayload(7, 5), handler));
+    BOOST_CHECK(handler.finished());
+    // The result is larger than one message, and split as a worker splits it.
+    BOOST_CHECK(handler.messages > 1);
+    BOOST_CHECK_EQUAL(handler.rows, config.rows);
+    BOOST_CHECK_EQUAL(handler.columns, config.cols);
+    BOOST_CHECK_EQUAL(handler.wname, "simworker2");
+
+    auto counts = workers.getCounts();
+    BOOST_CHECK_EQUAL(counts.jobs, 1U);
+    BOOST_CHECK_EQUAL(counts.failures, 0U);
+    BOOST_CHECK_EQUAL(counts.bytes, workers.getStreamBytes());
+    BOOST_CHECK(workers.takeFirstByte(7) != bench::SimWorkers::Clock::time_point());
+    BOOST_CHECK(workers.takeFirstByte(7) == bench::SimWorkers::Clock::time_point());
+}
+
+BOOST_AUTO_TEST_CASE(Failure) {
+    bench::SimWorkersConfig config;
+    config.latencyMs = 0;
+    config.rows = 10;
+    config.failRate = 1;
+    bench::SimWorkers workers(config);
+
+    DecodingHandler handler;
+    BOOST_CHECK(!workers.respond(bench::SimWorkers::makePayload(1, 1), handler));
+    BOOST_CHECK(!handler.error.empty());
+    BOOST_CHECK(!handler.finished());
+    BOOST_CHECK_EQUAL(workers.getCounts().failures, 1U);
+
+    DecodingHandler badPayload;
+    BOOST_CHECK(!workers.respond("chunk 1", badPayload));
+    BOOST_CHECK(!badPayload.error.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
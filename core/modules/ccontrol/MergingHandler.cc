@@ -70,6 +70,7 @@ MergingHandler::MergingHandler(
 
 MergingHandler::~MergingHandler() {
     LOGS(_log, LOG_LVL_DEBUG, "~MergingHandler()");
+    _releaseWorkerGauge();
 }
 
 const char* MergingHandler::getStateStr(MsgState const& state) {
@@ -105,7 +106,10 @@ bool MergingHandler::flush(int bLen, bool& last) {
             return false;
         }
         if (_wName == "~") {
+            // The worker is only known once its first header arrives, move
+            // the job from the unassigned gauge to the one of that worker.
             _wName = _response->protoHeader.wname();
+            _acquireWorkerGauge();
         }
         LOGS(_log, LOG_LVL_DEBUG, "HEADER_SIZE_WAIT: From:" << _wName
              << "Resizing buffer to " <<  _response->protoHeader.size());
@@ -129,6 +133,7 @@ bool MergingHandler::flush(int bLen, bool& last) {
             } else {
                 LOGS(_log, LOG_LVL_DEBUG, "Message ends, setting last=true");
                 last = true;
+                _releaseWorkerGauge();
             }
             LOGS(_log, LOG_LVL_DEBUG, "Flushed msgContinues=" << msgContinues
                  << " last=" << last << " for tableName=" << _tableName);
@@ -191,6 +196,10 @@ bool MergingHandler::reset() {
         return false; // Can't reset if we have already pushed state.
     }
     _initState();
+    // reset() is called each time the job is dispatched, the worker that
+    // will answer is not known yet.
+    _wName = "~";
+    _acquireWorkerGauge();
     return true;
 }
 
@@ -208,6 +217,19 @@ void MergingHandler::_initState() {
     _setError(0, "");
 }
 
+void MergingHandler::_acquireWorkerGauge() {
+    _releaseWorkerGauge();
+    _workerGauge = &util::Metrics::get().gauge("ccontrol.resultsInFlight." + _wName);
+    _workerGauge->add();
+}
+
+void MergingHandler::_releaseWorkerGauge() {
+    if (_workerGauge != nullptr) {
+        _workerGauge->sub();
+        _workerGauge = nullptr;
+    }
+}
+
 bool MergingHandler::_merge() {
     if (auto job = getJobQuery().lock()) {
         if (job->isCancelled()) {
@@ -217,6 +239,25 @@ bool MergingHandler::_merge() {
         if (_flushed) {
             throw Bug("MergingRequester::_merge : already flushed");
         }
+        if (_trace != nullptr) {
+            for (auto const& span : _response->result.tracespan()) {
+                _trace->add(util::Trace::Span{span.name(), span.begin(), span.end(), _jobId, _wName});
+            }
+        }
+        if (_usageSum != nullptr && _response->result.has_usage()) {
+            // The worker counts the bytes of all messages but the last one.
+            auto const& usage = _response->result.usage();
+            qmeta::QUsage jobUsage;
+            jobUsage.tasks = 1;
+            jobUsage.cpuUs = usage.cpuus();
+            jobUsage.chunkBytes = usage.chunkbytes();
+            jobUsage.memLockWaitUs = usage.memlockwaitus();
+            jobUsage.rowsExamined = usage.rowsexamined();
+            jobUsage.rowsReturned = usage.rowsreturned();
+            jobUsage.bytesSent = usage.bytessent() + _response->protoHeader.size();
+            _usageSum->add(jobUsage);
+        }
+        util::Trace::Scope scope(_trace, "merge", _jobId);
         bool success = _infileMerger->merge(_response);
         if (!success) {
             LOGS(_log, LOG_LVL_WARN, "_merge() failed");
@@ -238,6 +279,7 @@ void MergingHandler::_setError(int code, std::string const& msg) {
 }
 
 bool MergingHandler::_setResult() {
+    util::Trace::Scope scope(_trace, "decode", _jobId);
     auto start = std::chrono::system_clock::now();
     if (!ProtoImporter<proto::Result>::setMsgFrom(_response->result, &_buffer[0], _buffer.size())) {
         _setError(ccontrol::MSG_RESULT_DECODE, "Error decoding result msg");
@@ -250,6 +292,7 @@ bool MergingHandler::_setResult() {
     return true;
 }
 bool MergingHandler::_verifyResult() {
+    util::Trace::Scope scope(_trace, "verify", _jobId);
     if (_response->protoHeader.md5() != util::StringHash::getMd5(_buffer.data(), _buffer.size())) {
         _setError(ccontrol::MSG_RESULT_MD5, "Result message MD5 mismatch");
         _state = MsgState::RESULT_ERR;
@@ -29,6 +29,9 @@
 
 // Qserv headers
 #include "qdisp/ResponseHandler.h"
+#include "qmeta/QUsage.h"
+#include "util/Metrics.h"
+#include "util/Trace.h"
 
 // Forward decl
 namespace lsst {
@@ -53,6 +56,24 @@ namespace ccontrol {
 /// InfileMerger.
 class MergingHandler : public qdisp::ResponseHandler {
 public:
+    /// UsageSum adds up the worker resource usage reported with the results
+    /// of all the jobs of a query, from the handlers of those jobs.
+    class UsageSum {
+    public:
+        typedef std::shared_ptr<UsageSum> Ptr;
+        void add(qmeta::QUsage const& usage) {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _usage += usage;
+        }
+        qmeta::QUsage get() const {
+            std::lock_guard<std::mutex> lock(_mtx);
+            return _usage;
+        }
+    private:
+        mutable std::mutex _mtx;
+        qmeta::QUsage _usage;
+    };
+
     /// Possible MergingHandler message state
     enum class MsgState { INVALID, HEADER_SIZE_WAIT,
                     RESULT_WAIT, RESULT_EXTRA,
@@ -98,8 +119,20 @@ public:
         return _error;
     }
 
+    /// Record the decoding, verification and merging of the results of job
+    /// 'jobId' in 'trace', with the spans the worker sent back.
+    void setTrace(util::Trace::Ptr const& trace, int jobId) {
+        _trace = trace;
+        _jobId = jobId;
+    }
+
+    /// Add the worker resource usage of the job to 'usageSum'.
+    void setUsageSum(UsageSum::Ptr const& usageSum) { _usageSum = usageSum; }
+
 private:
     void _initState();
+    void _acquireWorkerGauge();
+    void _releaseWorkerGauge();
     bool _merge();
     void _setError(int code, std::string const& msg);
     bool _setResult();
@@ -115,6 +148,13 @@ private:
     std::shared_ptr<proto::WorkerResponse> _response; ///< protobufs msg buf
     bool _flushed {false}; ///< flushed to InfileMerger?
     std::string _wName {"~"}; /// worker name
+    util::Trace::Ptr _trace; ///< nullptr unless the query is traced
+    int _jobId {-1};
+    UsageSum::Ptr _usageSum; ///< nullptr if usage is not accounted
+    /// Jobs dispatched to _wName and not finished, reported in the czar
+    /// stats. Counted under the worker "~" from dispatch until the worker's
+    /// first header arrives.
+    util::Gauge* _workerGauge {nullptr};
 };
 
 }}} // namespace lsst::qserv::qdisp
@@ -53,6 +53,8 @@
 #include "qproc/SecondaryIndex.h"
 #include "rproc/InfileMerger.h"
 #include "sql/SqlConnection.h"
+#include "util/Diagnostics.h"
+#include "util/Trace.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.UserQueryFactory");
@@ -77,6 +79,10 @@ public:
     std::shared_ptr<qmeta::QMeta> queryMetadata;
     std::unique_ptr<sql::SqlConnection> resultDbConn;
     qmeta::CzarId qMetaCzarId = {0};   ///< Czar ID in QMeta database
+    int interactiveDeadlineSec = 0;    ///< see CzarConfig::getInteractiveDeadlineSec()
+    std::string traceDir;              ///< see CzarConfig::getTraceDir()
+    util::Diagnostics::Ptr diagnostics; ///< nullptr unless CzarConfig::getDiagDir() is set
+    int slowQuerySec = 0;              ///< see CzarConfig::getSlowQuerySec()
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -101,6 +107,7 @@ UserQueryFactory::newUserQuery(std::string const& query,
         bool sessionValid = true;
         std::string errorExtra;
         qproc::QuerySession::Ptr qs = std::make_shared<qproc::QuerySession>(_impl->css);
+        auto analyzeBegin = util::Trace::now();
         try {
             qs->setDefaultDb(defaultDb);
             qs->analyzeQuery(query);
@@ -113,6 +120,7 @@ UserQueryFactory::newUserQuery(std::string const& query,
             LOGS(_log, LOG_LVL_ERROR, "Invalid query: " << qs->getError());
             sessionValid = false;
         }
+        auto analyzeEnd = util::Trace::now();
 
         auto messageStore = std::make_shared<qdisp::MessageStore>();
         std::shared_ptr<qdisp::Executive> executive;
@@ -125,6 +133,14 @@ UserQueryFactory::newUserQuery(std::string const& query,
                                                     _impl->secondaryIndex, _impl->queryMetadata,
                                                     _impl->qMetaCzarId, errorExtra);
         if (sessionValid) {
+            uq->setInteractiveDeadline(_impl->interactiveDeadlineSec);
+            if (!_impl->traceDir.empty()) {
+                uq->setTraceDir(_impl->traceDir);
+                uq->getTrace()->add("analyze", analyzeBegin, analyzeEnd);
+            }
+            if (_impl->diagnostics != nullptr && _impl->slowQuerySec > 0) {
+                uq->setDiagnostics(_impl->diagnostics, _impl->slowQuerySec);
+            }
             uq->setupChunking();
         }
         return uq;
@@ -158,7 +174,15 @@ UserQueryFactory::newUserQuery(std::string const& query,
 }
 
 UserQueryFactory::Impl::Impl(czar::CzarConfig const& czarConfig)
-    : mysqlResultConfig(czarConfig.getMySqlResultConfig()) {
+    : mysqlResultConfig(czarConfig.getMySqlResultConfig()),
+      interactiveDeadlineSec(czarConfig.getInteractiveDeadlineSec()),
+      traceDir(czarConfig.getTraceDir()),
+      slowQuerySec(czarConfig.getSlowQuerySec()) {
+
+    if (!czarConfig.getDiagDir().empty()) {
+        diagnostics = std::make_shared<util::Diagnostics>(czarConfig.getDiagDir(),
+                                                          czarConfig.getDiagMaxFiles());
+    }
 
     executiveConfig = std::make_shared<qdisp::Executive::Config>(czarConfig.getXrootdFrontendUrl());
     secondaryIndex = std::make_shared<qproc::SecondaryIndex>(mysqlResultConfig);
@@ -64,7 +64,9 @@
 #include "ccontrol/UserQuerySelect.h"
 
 // System headers
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <memory>
 
 // LSST headers
@@ -80,6 +82,7 @@
 #include "proto/ProtoImporter.h"
 #include "qdisp/Executive.h"
 #include "qdisp/MessageStore.h"
+#include "qmeta/Exceptions.h"
 #include "qmeta/QMeta.h"
 #include "qproc/geomAdapter.h"
 #include "qproc/IndexMap.h"
@@ -91,9 +94,14 @@
 #include "rproc/InfileMerger.h"
 #include "util/Callable.h"
 #include "util/IterableFormatter.h"
+#include "util/Metrics.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.UserQuerySelect");
+
+/// Number of chunk jobs dispatched in the first wave of a LIMIT-only query.
+/// Each following wave is twice as large as the previous one.
+int const LIMIT_FIRST_WAVE_SIZE = 10;
 }
 
 namespace lsst {
@@ -202,12 +210,26 @@ void UserQuerySelect::submit() {
     LOGS(_log, LOG_LVL_DEBUG, "UserQuerySelect beginning submission " << _qMetaQueryId);
     assert(_infileMerger);
 
+    util::Trace::Scope submitScope(_trace, "submit");
     qproc::TaskMsgFactory taskMsgFactory(_qMetaQueryId);
+    taskMsgFactory.setTrace(_trace != nullptr);
     TmpTableName ttn(_qMetaQueryId, _qSession->getOriginal());
     proto::ProtoImporter<proto::TaskMsg> pi;
     std::vector<int> chunks;
     int msgCount = 0;
     int sequence = 0;
+    // Queries that only truncate their result to a LIMIT are dispatched in
+    // waves, and stop as soon as enough rows have been merged.
+    bool limitOnly = _infileMerger->getRowLimit() != NOTSET;
+    if (limitOnly) {
+        std::weak_ptr<qdisp::Executive> weakExec = _executive;
+        _infileMerger->setRowLimitCallback([weakExec]() {
+            auto exec = weakExec.lock();
+            if (exec) {
+                exec->squashSuperfluous();
+            }
+        });
+    }
     // Writing query for each chunk, stop if query is cancelled.
     for(auto i = _qSession->cQueryBegin(), e = _qSession->cQueryEnd();
             i != e && !_executive->getCancelled(); ++i) {
@@ -216,22 +238,40 @@ void UserQuerySelect::submit() {
         std::string chunkResultName = ttn.make(cs.chunkId);
         ++msgCount;
         std::ostringstream ss;
-        taskMsgFactory.serializeMsg(cs, chunkResultName, _executive->getId(), sequence, ss);
-        std::string msg = ss.str();
+        {
+            util::Trace::Scope scope(_trace, "serialize", sequence);
+            if (_interactiveDeadlineSec > 0) {
+                taskMsgFactory.setInteractiveDeadline(_remainingBudgetMs());
+            }
+            taskMsgFactory.serializeMsg(cs, chunkResultName, _executive->getId(), sequence, ss);
+            std::string msg = ss.str();
 
-        pi(msg.data(), msg.size());
-        if (pi.getNumAccepted() != msgCount) {
-            throw UserQueryBug("Error serializing TaskMsg.");
+            pi(msg.data(), msg.size());
+            if (pi.getNumAccepted() != msgCount) {
+                throw UserQueryBug("Error serializing TaskMsg.");
+            }
         }
 
         std::shared_ptr<ChunkMsgReceiver> cmr = ChunkMsgReceiver::newInstance(cs.chunkId, _messageStore);
         ResourceUnit ru;
         ru.setAsDbChunk(cs.db, cs.chunkId);
-        qdisp::JobDescription jobDesc(sequence, ru, ss.str(),
-                std::make_shared<MergingHandler>(cmr, _infileMerger, chunkResultName));
-        _executive->add(jobDesc);
+        auto handler = std::make_shared<MergingHandler>(cmr, _infileMerger, chunkResultName);
+        handler->setTrace(_trace, sequence);
+        handler->setUsageSum(_usageSum);
+        qdisp::JobDescription jobDesc(sequence, ru, ss.str(), handler);
+        if (limitOnly && sequence >= LIMIT_FIRST_WAVE_SIZE) {
+            // Held back until earlier waves fail to produce enough rows.
+            _pendingJobs.push_back(jobDesc);
+        } else {
+            util::Trace::Scope scope(_trace, "dispatch", sequence);
+            _executive->add(jobDesc);
+        }
         ++sequence;
     }
+    if (!_pendingJobs.empty()) {
+        LOGS(_log, LOG_LVL_DEBUG, "UserQuerySelect holding back " << _pendingJobs.size()
+             << " jobs of LIMIT " << _infileMerger->getRowLimit() << " query");
+    }
 
     // we only care about per-chunk info for ASYNC queries, and
     // currently all queries are SYNC, so we skip this.
@@ -244,9 +284,19 @@ void UserQuerySelect::submit() {
 /// Block until a submit()'ed query completes.
 /// @return the QueryState indicating success or failure
 QueryState UserQuerySelect::join() {
-    bool successful = _executive->join(); // Wait for all data
-    _infileMerger->finalize(); // Wait for all data to get merged
+    _dispatchWaves();
+    bool successful;
+    {
+        util::Trace::Scope scope(_trace, "wait");
+        successful = _executive->join(); // Wait for all data
+    }
+    {
+        util::Trace::Scope scope(_trace, "finalize");
+        _infileMerger->finalize(); // Wait for all data to get merged
+    }
     _discardMerger();
+    _writeTrace();
+    _qMetaAddUsage();
     if (successful) {
         _qMetaUpdateStatus(qmeta::QInfo::COMPLETED);
         LOGS(_log, LOG_LVL_DEBUG, "Joined everything (success)");
@@ -258,6 +308,91 @@ QueryState UserQuerySelect::join() {
     }
 }
 
+/// Dispatch the jobs held back by submit() in waves of doubling size, until
+/// the merger has enough rows, the query is cancelled, or none are left.
+void UserQuerySelect::_dispatchWaves() {
+    int waveSize = LIMIT_FIRST_WAVE_SIZE;
+    while (!_pendingJobs.empty()) {
+        _executive->waitInflight();
+        if (_infileMerger->isRowLimitReached() || _executive->getCancelled()) {
+            LOGS(_log, LOG_LVL_DEBUG, "UserQuerySelect skipping " << _pendingJobs.size()
+                 << " jobs, rowLimitReached=" << _infileMerger->isRowLimitReached());
+            break;
+        }
+        waveSize *= 2;
+        for (int j=0; j < waveSize && !_pendingJobs.empty(); ++j) {
+            qdisp::JobDescription& jobDesc = _pendingJobs.front();
+            {
+                util::Trace::Scope scope(_trace, "dispatch", jobDesc.id());
+                std::string payload = jobDesc.payload();
+                if (_interactiveDeadlineSec > 0
+                    && qproc::TaskMsgFactory::resetDeadlineBudget(payload, _remainingBudgetMs())) {
+                    _executive->add(qdisp::JobDescription(jobDesc.id(), jobDesc.resource(),
+                                                          payload, jobDesc.respHandler()));
+                } else {
+                    _executive->add(jobDesc);
+                }
+            }
+            _pendingJobs.pop_front();
+        }
+        LOGS(_log, LOG_LVL_DEBUG, "UserQuerySelect dispatched wave of " << waveSize
+             << ", " << _pendingJobs.size() << " jobs left");
+    }
+    _pendingJobs.clear();
+}
+
+/// @return what is left of the interactive deadline of this query, the
+/// budget for a job dispatched now. Jobs of queries that spent longer on
+/// the czar, or in held-back waves, get smaller budgets and are started
+/// first on the workers. At least 1, as 0 means no deadline.
+std::int64_t UserQuerySelect::_remainingBudgetMs() const {
+    auto deadline = _created + std::chrono::seconds(_interactiveDeadlineSec);
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    return std::max<std::int64_t>(left, 1);
+}
+
+void UserQuerySelect::setTraceDir(std::string const& traceDir) {
+    _traceDir = traceDir;
+    _trace = std::make_shared<util::Trace>(qmeta::QueryIdHelper::makeIdStr(_qMetaQueryId));
+}
+
+/// Log a summary of the trace and write it to the trace directory.
+void UserQuerySelect::_writeTrace() {
+    if (_trace == nullptr) {
+        return;
+    }
+    LOGS(_log, LOG_LVL_INFO, "trace " << _trace->summaryStr());
+    std::string path = _traceDir + "/" + std::to_string(_qMetaQueryId) + ".json";
+    if (!_trace->writeChromeJson(path)) {
+        LOGS(_log, LOG_LVL_WARN, "failed to write trace " << path);
+    }
+}
+
+void UserQuerySelect::setDiagnostics(util::Diagnostics::Ptr const& diagnostics, int slowSec) {
+    _diagnostics = diagnostics;
+    _executive->setSlowHandler(std::chrono::seconds(slowSec), [this]() { _writeDiagnostics(); });
+}
+
+/// Write the state of the jobs in flight and of the czar to the diagnostics directory.
+void UserQuerySelect::_writeDiagnostics() {
+    std::string const idStr = qmeta::QueryIdHelper::makeIdStr(_qMetaQueryId);
+    _diagnostics->write("czar-" + std::to_string(_qMetaQueryId), [this, &idStr](std::ostream& os) {
+        os << idStr << " slow query: " << _qSession->getOriginal() << "\n";
+        os << "\n== jobs in flight\n";
+        _executive->printState(os);
+        os << "\n== metrics\n";
+        for (auto const& entry : util::Metrics::get().snapshot()) {
+            os << entry.first << " " << entry.second << "\n";
+        }
+        if (_trace != nullptr) {
+            os << "\n== trace\n" << _trace->summaryStr() << "\n";
+        }
+        os << "\n== threads\n";
+        util::Diagnostics::writeThreadStacks(os);
+    });
+}
+
 /// Release resources held by the merger
 void UserQuerySelect::_discardMerger() {
     _infileMergerConfig.reset();
@@ -301,6 +436,7 @@ void UserQuerySelect::_setupMerger() {
 
 void UserQuerySelect::setupChunking() {
     LOGS(_log, LOG_LVL_TRACE, "Setup chunking");
+    util::Trace::Scope scope(_trace, "plan");
     // Do not throw exceptions here, set _errorExtra .
     std::shared_ptr<qproc::IndexMap> im;
     std::string dominantDb = _qSession->getDominantDb();
@@ -420,6 +556,23 @@ void UserQuerySelect::_qMetaUpdateStatus(qmeta::QInfo::QStatus qStatus)
     _queryMetadata->completeQuery(_qMetaQueryId, qStatus);
 }
 
+// add worker resource usage of all jobs to qmeta
+void UserQuerySelect::_qMetaAddUsage()
+{
+    auto usage = _usageSum->get();
+    if (usage.tasks == 0) return;
+    LOGS(_log, LOG_LVL_DEBUG, "Query usage: tasks=" << usage.tasks << " cpuUs=" << usage.cpuUs
+         << " chunkBytes=" << usage.chunkBytes << " memLockWaitUs=" << usage.memLockWaitUs
+         << " rowsExamined=" << usage.rowsExamined << " rowsReturned=" << usage.rowsReturned
+         << " bytesSent=" << usage.bytesSent);
+    try {
+        _queryMetadata->addQueryUsage(_qMetaQueryId, usage);
+    } catch (qmeta::Exception const& exc) {
+        // usage is informational, do not fail the query
+        LOGS(_log, LOG_LVL_WARN, "Failed to store query usage in QMeta: " << exc.what());
+    }
+}
+
 // add chunk information to qmeta
 void UserQuerySelect::_qMetaAddChunks(std::vector<int> const& chunks)
 {
@@ -32,19 +32,25 @@
   */
 
 // System headers
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
 
 // Third-party headers
 
 // Qserv headers
+#include "ccontrol/MergingHandler.h"
 #include "ccontrol/UserQuery.h"
 #include "css/StripingParams.h"
+#include "qdisp/JobDescription.h"
 #include "qmeta/QInfo.h"
 #include "qmeta/types.h"
 #include "qproc/ChunkSpec.h"
 #include "query/Constraint.h"
+#include "util/Diagnostics.h"
+#include "util/Trace.h"
 
 // Forward decl
 namespace lsst {
@@ -119,12 +125,32 @@ public:
 
     void setupChunking();
 
+    /// Ask workers to start interactive tasks within 'seconds' of the creation
+    /// of this query, 0 for no deadline.
+    void setInteractiveDeadline(int seconds) { _interactiveDeadlineSec = seconds; }
+
+    /// Time the steps of this query, on the czar and on the workers, and
+    /// write them to 'traceDir' once the query is joined.
+    void setTraceDir(std::string const& traceDir);
+
+    /// @return the trace of this query, nullptr if it is not traced.
+    util::Trace::Ptr getTrace() const { return _trace; }
+
+    /// Write diagnostics to 'diagnostics' if the query is still running
+    /// 'slowSec' seconds after it was created.
+    void setDiagnostics(util::Diagnostics::Ptr const& diagnostics, int slowSec);
+
 private:
     void _setupMerger();
+    void _dispatchWaves();
+    std::int64_t _remainingBudgetMs() const;
     void _discardMerger();
     void _qMetaRegister();
     void _qMetaUpdateStatus(qmeta::QInfo::QStatus qStatus);
     void _qMetaAddChunks(std::vector<int> const& chunks);
+    void _qMetaAddUsage();
+    void _writeTrace();
+    void _writeDiagnostics();
 
     // Delegate classes
     std::shared_ptr<qproc::QuerySession> _qSession;
@@ -141,6 +167,15 @@ private:
     std::mutex _killMutex;
     std::string _errorExtra;        ///< Additional error information
     std::string _resultTable;       ///< Result table name
+    std::deque<qdisp::JobDescription> _pendingJobs; ///< Jobs not dispatched yet
+    int _interactiveDeadlineSec{0};
+    /// When the user submitted the query, the start of the interactive deadline.
+    std::chrono::steady_clock::time_point const _created{std::chrono::steady_clock::now()};
+    std::string _traceDir;
+    util::Trace::Ptr _trace;        ///< nullptr unless the query is traced
+    util::Diagnostics::Ptr _diagnostics; ///< nullptr unless slow queries are diagnosed
+    /// Worker resource usage of all jobs
+    MergingHandler::UsageSum::Ptr _usageSum{std::make_shared<MergingHandler::UsageSum>()};
 };
 
 }}} // namespace lsst::qserv:ccontrol
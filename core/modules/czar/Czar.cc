@@ -24,6 +24,7 @@
 #include "czar/Czar.h"
 
 // System headers
+#include <chrono>
 #include <sys/time.h>
 #include <thread>
 
@@ -36,12 +37,17 @@
 // Qserv headers
 #include "ccontrol/ConfigMap.h"
 #include "czar/MessageTable.h"
+#include "qdisp/WorkerStats.h"
 #include "util/IterableFormatter.h"
+#include "util/Metrics.h"
 
 namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.czar.Czar");
 
+/// Longest wait for a worker to reply to "SHOW QSERV STATS FOR WORKER".
+std::chrono::seconds const WORKER_STATS_TIMEOUT(10);
+
 // parse KILL query, return thread ID or -1
 int parseKillQuery(std::string const& query);
 
@@ -221,6 +227,31 @@ Czar::killQuery(std::string const& query, std::string const& clientId) {
     return std::string();
 }
 
+std::vector<std::string>
+Czar::getStats() {
+
+    auto stats = util::Metrics::get().snapshot();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        int userQueries = 0;
+        for (auto const& entry : _clientToQuery) {
+            if (!entry.second.expired()) ++userQueries;
+        }
+        stats["czar.userQueries"] = userQueries;
+    }
+
+    std::vector<std::string> lines;
+    for (auto const& entry : stats) {
+        lines.push_back(entry.first + " " + std::to_string(entry.second));
+    }
+    return lines;
+}
+
+std::vector<std::string>
+Czar::getWorkerStats(std::string const& hostPort) {
+    return qdisp::WorkerStats::fetch(hostPort, WORKER_STATS_TIMEOUT);
+}
+
 }}} // namespace lsst::qserv::czar
 
 namespace {
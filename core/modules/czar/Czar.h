@@ -89,6 +89,23 @@ public:
      */
     std::string killQuery(std::string const& query, std::string const& clientId);
 
+    /**
+     * Report the state of this czar: jobs in flight, jobs dispatched to
+     * each worker, merge backlog and merge throughput counters.
+     *
+     * @return one "name value" string per statistic, sorted by name.
+     */
+    std::vector<std::string> getStats();
+
+    /**
+     * Fetch the statistics served by one worker.
+     *
+     * @param hostPort host:port of the xrootd server of the worker.
+     * @return one "name value" string per statistic, sorted by name.
+     * @throws std::runtime_error if the worker did not reply.
+     */
+    std::vector<std::string> getWorkerStats(std::string const& hostPort);
+
 protected:
 
 private:
@@ -32,6 +32,7 @@
 // Qserv headers
 #include "mysql/MySqlConfig.h"
 #include "util/ConfigStore.h"
+#include "util/ConfigStoreError.h"
 #include "util/IterableFormatter.h"
 
 namespace {
@@ -58,7 +59,15 @@ CzarConfig::CzarConfig(util::ConfigStore const& configStore)
                         configStore.get("qmeta.unix_socket"),
                         configStore.get("qmeta.db", "qservMeta")),
        _xrootdFrontendUrl(configStore.get("frontend.xrootd", "localhost:1094")),
-       _emptyChunkPath(configStore.get("partitioner.emptyChunkPath", ".")) {
+       _emptyChunkPath(configStore.get("partitioner.emptyChunkPath", ".")),
+       _interactiveDeadlineSec(configStore.getInt("tuning.interactiveDeadline", 60)),
+       _traceDir(configStore.get("tuning.traceDir")),
+       _diagDir(configStore.get("tuning.diagDir")),
+       _slowQuerySec(configStore.getInt("tuning.slowQuery", 600)),
+       _diagMaxFiles(configStore.getInt("tuning.diagMaxFiles", 20)) {
+    if (_diagMaxFiles < 1) {
+        throw util::InvalidIntegerValue("tuning.diagMaxFiles", std::to_string(_diagMaxFiles));
+    }
 }
 
 std::ostream& operator<<(std::ostream &out, CzarConfig const& czarConfig) {
@@ -68,6 +77,11 @@ std::ostream& operator<<(std::ostream &out, CzarConfig const& czarConfig) {
            ", mySqlQmetaConfig=" << czarConfig._mySqlQmetaConfig <<
            ", mySqlResultConfig=" << czarConfig._mySqlResultConfig <<
            ", xrootdFrontendUrl=" << czarConfig._xrootdFrontendUrl <<
+           ", interactiveDeadlineSec=" << czarConfig._interactiveDeadlineSec <<
+           ", traceDir=" << czarConfig._traceDir <<
+           ", diagDir=" << czarConfig._diagDir <<
+           ", slowQuerySec=" << czarConfig._slowQuerySec <<
+           ", diagMaxFiles=" << czarConfig._diagMaxFiles <<
            "]";
 
     return out;
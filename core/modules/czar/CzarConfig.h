@@ -112,6 +112,60 @@ public:
         return _xrootdFrontendUrl;
     }
 
+    /* Get the time workers are asked to start interactive queries in
+     *
+     * The deadline counts from the submission of a query that does not need
+     * a shared scan. Each task is sent with what is left of it when it is
+     * dispatched. Each worker adds that to the time it received the task and
+     * starts those tasks earliest deadline first.
+     *
+     * @return number of seconds after a query is submitted, 0 for no deadline
+     */
+    int getInteractiveDeadlineSec() const {
+        return _interactiveDeadlineSec;
+    }
+
+    /* Get the directory the traces of queries are written to
+     *
+     * When set, the steps of every query on the czar and on the workers are
+     * timed, summarized in the log, and written to <traceDir>/<queryId>.json
+     * in the Chrome trace event format.
+     *
+     * @return directory, empty for no tracing
+     */
+    std::string const& getTraceDir() const {
+        return _traceDir;
+    }
+
+    /* Get the directory diagnostics of slow queries are written to
+     *
+     * When set, the czar writes the state of the jobs in flight, its
+     * metrics and the stacks of its threads to this directory when a query
+     * runs longer than getSlowQuerySec(). Only the latest
+     * getDiagMaxFiles() reports are kept.
+     *
+     * @return directory, empty for no diagnostics
+     */
+    std::string const& getDiagDir() const {
+        return _diagDir;
+    }
+
+    /* Get the time after which a query is slow
+     *
+     * @return number of seconds after submission, 0 to never capture diagnostics
+     */
+    int getSlowQuerySec() const {
+        return _slowQuerySec;
+    }
+
+    /* Get the number of diagnostics reports kept
+     *
+     * @return number of reports, at least 1
+     */
+    int getDiagMaxFiles() const {
+        return _diagMaxFiles;
+    }
+
 private:
 
     CzarConfig(util::ConfigStore const& ConfigStore);
@@ -125,6 +179,11 @@ private:
     mysql::MySqlConfig const _mySqlQmetaConfig;
     std::string const _xrootdFrontendUrl;
     std::string const _emptyChunkPath;
+    int const _interactiveDeadlineSec;
+    std::string const _traceDir;
+    std::string const _diagDir;
+    int const _slowQuerySec;
+    int const _diagMaxFiles;
 };
 
 }}} // namespace lsst::qserv::czar
@@ -93,6 +93,8 @@ ResourceUnit::path() const {
     case RESULT:
         ss << _hashName;
         break;
+    case STATS:
+        break;
     default:
         ::abort();
         break;
@@ -120,6 +122,8 @@ ResourceUnit::prefix(UnitType const& r) {
         return "UNKNOWN";
     case RESULT:
         return "result";
+    case STATS:
+        return "stats";
     case GARBAGE:
     default:
         return "GARBAGE";
@@ -140,6 +144,11 @@ ResourceUnit::setAsCquery(std::string const& db, int chunk) {
     _chunk = chunk;
 }
 
+void
+ResourceUnit::setAsStats() {
+    _unitType = STATS;
+}
+
 bool ResourceUnit::_markGarbageIfDone(Tokenizer& t) {
     if (t.done()) {
         _unitType = GARBAGE;
@@ -196,6 +205,8 @@ ResourceUnit::_setFromPath(std::string const& path) {
         t.next();
         _hashName = t.token();
         if (_hashName.empty()) { _unitType = GARBAGE; return; }
+    } else if (rTypeString == prefix(STATS)) {
+        _unitType = STATS;
     } else {
         _unitType = GARBAGE;
     }
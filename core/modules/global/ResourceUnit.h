@@ -46,7 +46,7 @@ namespace qserv {
 class ResourceUnit {
 public:
     class Checker;
-    enum UnitType {GARBAGE, DBCHUNK, CQUERY, UNKNOWN, RESULT};
+    enum UnitType {GARBAGE, DBCHUNK, CQUERY, UNKNOWN, RESULT, STATS};
 
     ResourceUnit() : _unitType(GARBAGE), _chunk(-1) {}
 
@@ -74,6 +74,9 @@ public:
     void setAsCquery(std::string const& db, int chunk=DUMMY_CHUNK);
     void setAsResult(std::string const& hashName);
 
+    // Setup the path of the worker statistics, "/stats".
+    void setAsStats();
+
     // Optional specifiers may not be supported by XrdSsi
     // Add optional specifiers ?foo&bar=1&bar2=2
     void addKey(std::string const& key);
@@ -98,4 +98,12 @@ BOOST_AUTO_TEST_CASE(Old) {
     BOOST_CHECK_EQUAL(res.unitType(), ResourceUnit::RESULT);
 }
 
+BOOST_AUTO_TEST_CASE(Stats) {
+    ResourceUnit stats("/stats");
+    BOOST_CHECK_EQUAL(stats.unitType(), ResourceUnit::STATS);
+    ResourceUnit r;
+    r.setAsStats();
+    BOOST_CHECK_EQUAL(r.path(), "/stats");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -25,6 +25,7 @@
 #include "memman/MemFile.h"
 
 // System Headers
+#include <condition_variable>
 #include <errno.h>
 #include <mutex>
 #include <unordered_map>
@@ -39,16 +40,37 @@ namespace memman {
   
 namespace {
 std::mutex                                cacheMutex;
+std::condition_variable                   lockDone;
 std::unordered_map<std::string, MemFile*> fileCache;
 }
 
+/******************************************************************************/
+/*                              i s L o c k e d                               */
+/******************************************************************************/
+
+bool MemFile::isLocked(std::string const& fPath) {
+
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    // The file is resident only if some file set has it locked. A file that
+    // is merely reserved still needs memory to be locked.
+    //
+    auto it = fileCache.find(fPath);
+    return it != fileCache.end() && it->second->_isLocked;
+}
+
 /******************************************************************************/
 /*                               m e m L o c k                                */
 /******************************************************************************/
 
 MemFile::MLResult MemFile::memLock() {
 
-    std::lock_guard<std::mutex> guard(cacheMutex);
+    std::unique_lock<std::mutex> lock(cacheMutex);
+
+    // If another file set is in the middle of locking this very file, wait
+    // for it to finish so that the file is mapped only once.
+    //
+    lockDone.wait(lock, [this]{return !_isLocking;});
 
     // If the file is already locked, indicate success
     //
@@ -76,33 +98,42 @@ MemFile::MLResult MemFile::memLock() {
         }
     }
 
-    // Lock this table in memory if possible.
+    // Reserve the memory before dropping the mutex so that concurrent lockers
+    // see it as used, then map and lock the file without holding any mutex.
+    // Faulting in a large file takes a long time and must not stall threads
+    // that only want to unlock memory or gather statistics.
     //
+    bool wasReserved = _isReserved;
+    if (!_isReserved) {
+        _memory.memReserve(_memInfo.size());
+        _isReserved = true;
+    }
+    _isLocking = true;
+    lock.unlock();
+
     MemInfo mInfo = _memory.memLock(_fPath, _isFlex);
 
+    lock.lock();
+    _isLocking = false;
+    lockDone.notify_all();
+
     // If we successfully locked this file, then indicate so, update the
-    // memory information and return. If memory was previously reserved for
-    // this file then credit the reserve count using the original size.
+    // memory information and return. Credit the reserve count using the
+    // original size as the locked bytes are now counted instead.
     //
     if (mInfo.isValid()) {
         MLResult aokResult(mInfo.size(),0);
-        if (_isReserved) {
-            _memory.memRestore(_memInfo.size());
-            _isReserved = false;
-        }
+        _memory.memRestore(_memInfo.size());
+        _isReserved = false;
         _isLocked = true;
         _memInfo = mInfo;
         return aokResult;
     }
 
-    // If this is a flex table and there was not enough memory and storage
-    // was not yet reserved for it, do so now.
+    // If this is a flex table and there was not enough memory, keep the
+    // storage reserved for it.
     //
     if (_isFlex && mInfo.errCode() == ENOMEM) {
-        if (!_isReserved) {
-            _memory.memReserve(_memInfo.size());
-            _isReserved = true;
-        }
         MLResult nilResult(0,0);
         return nilResult;
     }
@@ -110,20 +141,20 @@ MemFile::MLResult MemFile::memLock() {
     // TODO: Find a better solution for systems where mmap is not viable, which
     // manifests as no bytes being locked but bytes are reserved.
     // Fake mmap as the configuration isn't working properly.
-    // At this point, there is enough free space, it was not a flex table,
+    // At this point, there was enough free space, it was not a flex table,
     // but mmap failed. So,this will fake it being a flexilock file and
-    // reserve space for it.
+    // keep the space reserved for it.
     if (_memInfo.size() < freeBytes) {
-        if (!_isReserved) {
-            _memory.memReserve(_memInfo.size());
-            _isReserved = true;
-        }
         MLResult nilResult(0,0);
         return nilResult;
     }
 
-    // Diagnose any errors
+    // Diagnose any errors after backing out a reservation made by this call
     //
+    if (!wasReserved) {
+        _memory.memRestore(_memInfo.size());
+        _isReserved = false;
+    }
     MLResult errResult(0, mInfo.errCode());
     return errResult;
 }
@@ -62,10 +62,23 @@ public:
     //!                   the reason. When retc = 0 there was not enough memory
     //!                   but flexible locking was requested and memory was
     //!                   reserved for a future attempt.
+    //!
+    //! The memory is reserved under the file cache mutex but the file itself
+    //! is mapped and locked with no mutex held.
     //-----------------------------------------------------------------------------
 
     MLResult    memLock();
 
+    //-----------------------------------------------------------------------------
+    //! @brief Check if a file is locked in memory (global file cache).
+    //!
+    //! @param  fPath   - The path to the file.
+    //!
+    //! @return true if some file set has the file locked, false otherwise.
+    //-----------------------------------------------------------------------------
+
+    static bool isLocked(std::string const& fPath);
+
     //-----------------------------------------------------------------------------
     //! @brief Get number of active files (global count).
     //!
@@ -126,6 +139,7 @@ private:
     int         _refs = 1;             // Protected by cacheMutex
     bool        _isLocked   = false;   // Ditto
     bool        _isReserved = false;   // Ditto
+    bool        _isLocking  = false;   // Ditto, memLock() in progress
     bool        _isFlex;               // Set once at object creation
 };
 
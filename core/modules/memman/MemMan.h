@@ -41,6 +41,8 @@ namespace memman {
 //! previously added and marked FLEXIBLE. Tables marked FLEXIBLE are locked if
 //! there is sufficient memory. Otherwise, the required memory is reserved and
 //! a lock attempt is made when the table is encountered in the future.
+//! Tables marked ADVISE are never locked nor counted against locked memory;
+//! the kernel is only asked to start reading them into the page cache.
 //-----------------------------------------------------------------------------
 
 class TableInfo {
@@ -52,7 +54,8 @@ public:
         NOLOCK   = 0,         //< Item should not be locked
         MUSTLOCK = 1,         //< Item must be locked or declare failure
         FLEXIBLE = 2,         //< Item may  be locked but memory is reserved
-        OPTIONAL = 3          //< Item may  be locked if possible or ignored
+        OPTIONAL = 3,         //< Item may  be locked if possible or ignored
+        ADVISE   = 4          //< Item is read ahead but never locked
     };
 
     LockType theData;         //< Lock options for the table's data
@@ -119,6 +122,22 @@ public:
 
     virtual Handle lock(std::vector<TableInfo> const& tables, int chunk) = 0;
 
+    //-----------------------------------------------------------------------------
+    //! @brief Check if a set of tables is already locked in memory for a chunk.
+    //!
+    //! Files are shared by all handles, so lock() on resident tables needs no
+    //! additional memory and cannot fail with ENOMEM.
+    //!
+    //! @param  tables - Reference to the tables to check. Only tables and
+    //!                  indexes marked MUSTLOCK or FLEXIBLE are checked.
+    //! @param  chunk  - The chunk number associated with the tables.
+    //!
+    //! @return true:  Every file that lock() would lock is already locked.
+    //! @return false: At least one file would need to be locked.
+    //-----------------------------------------------------------------------------
+
+    virtual bool  isResident(std::vector<TableInfo> const& tables, int chunk) = 0;
+
     //-----------------------------------------------------------------------------
     //! @brief Unlock a set of tabes previously locked by the lock() method.
     //!
@@ -157,6 +176,10 @@ public:
         uint32_t numFlexLock;  //!< Number  flexible files that were locked
         uint32_t numLocks;     //!< Number of calls to lock()
         uint32_t numErrors;    //!< Number of calls that failed
+        uint64_t bytesAdvised; //!< Total   number of bytes read ahead
+        uint32_t numAdvised;   //!< Number  advise files encountered
+        uint64_t numMajFaults; //!< Page faults locking read from disk
+        uint64_t numMinFaults; //!< Page faults locking found in cache
     };
 
     virtual Statistics getStatistics() = 0;
@@ -54,6 +54,9 @@ public:
                return HandleType::ISEMPTY;
            }
 
+    bool  isResident(std::vector<TableInfo> const& tables, int chunk) override
+                    {(void)tables; (void)chunk; return false;}
+
     bool  unlock(Handle handle) override {(void)handle; return true;}
 
     void  unlockAll() override {}
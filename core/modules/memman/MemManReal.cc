@@ -33,6 +33,7 @@
 // Qserv Headers
 #include "memman/MemFile.h"
 #include "memman/MemFileSet.h"
+#include "util/Metrics.h"
 
 /******************************************************************************/
 /*                  L o c a l   S t a t i c   O b j e c t s                   */
@@ -47,6 +48,13 @@ std::unordered_map<lsst::qserv::memman::MemMan::Handle,
 
 lsst::qserv::memman::MemMan::Handle handleNum
                              = lsst::qserv::memman::MemMan::HandleType::ISEMPTY;
+
+// Process-wide copies of numLocks and numErrors, see util::Metrics.
+//
+lsst::qserv::util::Counter& numLocksMetric
+                             = lsst::qserv::util::Metrics::get().counter("memman.numLocks");
+lsst::qserv::util::Counter& numErrorsMetric
+                             = lsst::qserv::util::Metrics::get().counter("memman.numErrors");
 }
 
 namespace lsst {
@@ -70,6 +78,10 @@ MemMan::Statistics MemManReal::getStatistics() {
     stats.numLocks     = _numLocks;
     stats.numErrors    = _numErrors;
     stats.numFiles     = MemFile::numFiles();
+    stats.bytesAdvised = _memory.bytesAdvised();
+    stats.numAdvised   = _memory.advNum();
+    stats.numMajFaults = _memory.majFaults();
+    stats.numMinFaults = _memory.minFaults();
 
     // The following requires a lock
     //
@@ -81,6 +93,26 @@ MemMan::Statistics MemManReal::getStatistics() {
     return stats;
 }
 
+/******************************************************************************/
+/*                                a d v i s e                                 */
+/******************************************************************************/
+
+void MemManReal::_advise(std::vector<TableInfo> const& tables, int chunk) {
+
+    // Start reading ahead every file marked ADVISE. Errors are ignored as the
+    // files are not needed for the request to succeed; a missing chunk will
+    // be diagnosed when the query runs.
+    //
+    for (auto&& tab : tables) {
+        if (tab.theData  == TableInfo::LockType::ADVISE) {
+            _memory.memAdvise(_memory.filePath(tab.tableName, chunk, false));
+        }
+        if (tab.theIndex == TableInfo::LockType::ADVISE) {
+            _memory.memAdvise(_memory.filePath(tab.tableName, chunk, true));
+        }
+    }
+}
+
 /******************************************************************************/
 /*                             g e t S t a t u s                              */
 /******************************************************************************/
@@ -109,29 +141,60 @@ MemMan::Status MemManReal::getStatus(Handle handle) {
     return status;
 }
   
+/******************************************************************************/
+/*                            i s R e s i d e n t                             */
+/******************************************************************************/
+
+bool MemManReal::isResident(std::vector<TableInfo> const& tables, int chunk) {
+
+    // Every file that lock() would lock must already be locked by some other
+    // file set. Optional, advise, and unlocked files do not matter.
+    //
+    for (auto&& tab : tables) {
+        if ((tab.theData  == TableInfo::LockType::MUSTLOCK
+        ||   tab.theData  == TableInfo::LockType::FLEXIBLE)
+        &&  !MemFile::isLocked(_memory.filePath(tab.tableName, chunk, false)))
+           return false;
+        if ((tab.theIndex == TableInfo::LockType::MUSTLOCK
+        ||   tab.theIndex == TableInfo::LockType::FLEXIBLE)
+        &&  !MemFile::isLocked(_memory.filePath(tab.tableName, chunk, true)))
+           return false;
+    }
+    return true;
+}
+
 /******************************************************************************/
 /*                                  l o c k                                   */
 /******************************************************************************/
   
 MemMan::Handle MemManReal::lock(std::vector<TableInfo> const& tables, int chunk) {
 
-    int  lockNum, flexNum, retc = 0;
+    int  lockNum, flexNum, advNum, retc = 0;
     bool mustLock;
 
+    _numLocks++;
+    numLocksMetric.add();
+
     // Pass 1: determine the number of files needed in the file set
     //
-    lockNum = flexNum = 0;
+    lockNum = flexNum = advNum = 0;
     for (auto&& tab : tables) {
         if (         tab.theData  == TableInfo::LockType::MUSTLOCK) lockNum++;
             else if (tab.theData  == TableInfo::LockType::FLEXIBLE) flexNum++;
+            else if (tab.theData  == TableInfo::LockType::ADVISE)   advNum++;
         if (         tab.theIndex == TableInfo::LockType::MUSTLOCK) lockNum++;
             else if (tab.theIndex == TableInfo::LockType::FLEXIBLE) flexNum++;
+            else if (tab.theIndex == TableInfo::LockType::ADVISE)   advNum++;
     }
 
     // If we don't need to lock anything then indicate success but return a
-    // a special file handle that indicates the file set is empty.
+    // a special file handle that indicates the file set is empty. Files that
+    // only need to be read ahead are not part of any file set.
     //
-    if (lockNum == 0 && flexNum == 0) return HandleType::ISEMPTY;
+    if (lockNum == 0 && flexNum == 0) {
+        if (advNum) _advise(tables, chunk);
+        return HandleType::ISEMPTY;
+    }
 
     // Allocate an empty file set sized to handle this request
     //
@@ -152,29 +215,41 @@ MemMan::Handle MemManReal::lock(std::vector<TableInfo> const& tables, int chunk)
         }
      }
 
-    // If we ended with no errors then try to memlock the file set. We do this
-    // with a global mutex to make sure we have a predictable view of memory.
+    // If we ended with no errors then try to memlock the file set. Locking
+    // faults in every page and may take a long time, so it is done without
+    // holding the global mutex; each file reserves its memory before it is
+    // locked which keeps the view of memory predictable. The file set is not
+    // visible to anyone else until its handle is returned.
     //
     if (retc == 0) {
-       std::lock_guard<std::mutex> guard(hanMutex);
+       Handle handle = HandleType::INVALID;
+       retc = fileSet->lockAll();
 
-       // Lock all required tables and any flexible tables we can. Upon success
-       // (with global lock held) update statistics, generate a file handle,
-       // add it to the handle cache, and return the handle.
+       // Upon success (with global lock held) update statistics, generate a
+       // file handle and add it to the handle cache.
        //
-       retc = fileSet->lockAll();
        if (retc == 0) {
+          std::lock_guard<std::mutex> guard(hanMutex);
           _numReqdFiles += lockNum;
           _numFlexFiles += flexNum;
           handleNum++;
           hanCache.insert({handleNum, fileSet});
-          return handleNum;
+          handle = handleNum;
+       }
+
+       // Read ahead the advise files only when the request succeeded, as a
+       // failed request will be retried later. Return the handle.
+       //
+       if (retc == 0) {
+          if (advNum) _advise(tables, chunk);
+          return handle;
        }
     }
 
     // If we wind up here we failed to perform the operation; return an error.
     //
     _numErrors++;
+    numErrorsMetric.add();
     delete fileSet;
     errno = retc;
     return HandleType::INVALID;
@@ -46,6 +46,8 @@ public:
 
     Handle lock(std::vector<TableInfo> const& tables, int chunk) override;
 
+    bool   isResident(std::vector<TableInfo> const& tables, int chunk) override;
+
     bool   unlock(Handle handle) override;
 
     void   unlockAll() override;
@@ -65,6 +67,8 @@ public:
 
 private:
 
+    void             _advise(std::vector<TableInfo> const& tables, int chunk);
+
     Memory           _memory;
     std::atomic_uint _numLocks;
     std::atomic_uint _numErrors;
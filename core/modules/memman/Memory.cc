@@ -25,12 +25,57 @@
 #include "memman/Memory.h"
 
 // System Headers
+#include <chrono>
 #include <errno.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+// Qserv Headers
+#include "util/Metrics.h"
+
+/******************************************************************************/
+/*                  L o c a l   S t a t i c   O b j e c t s                   */
+/******************************************************************************/
+
+namespace {
+
+// Process-wide copies of the Memory statistics, see util::Metrics. They are
+// updated with the same deltas as the members of the Memory object, as the
+// members change concurrently and a re-read value could be stale.
+//
+struct MemMetrics {
+    lsst::qserv::util::Metrics& reg = lsst::qserv::util::Metrics::get();
+    lsst::qserv::util::Gauge&     bytesLocked  = reg.gauge("memman.bytesLocked");
+    lsst::qserv::util::Gauge&     bytesReserved= reg.gauge("memman.bytesReserved");
+    lsst::qserv::util::Counter&   bytesAdvised = reg.counter("memman.bytesAdvised");
+    lsst::qserv::util::Counter&   numAdvised   = reg.counter("memman.numAdvised");
+    lsst::qserv::util::Counter&   numFlexLock  = reg.counter("memman.numFlexLock");
+    lsst::qserv::util::Counter&   numMajFaults = reg.counter("memman.numMajFaults");
+    lsst::qserv::util::Counter&   numMinFaults = reg.counter("memman.numMinFaults");
+    lsst::qserv::util::Histogram& lockMicros   = reg.histogram("memman.lockMicros");
+};
+
+MemMetrics& metrics() {
+    static MemMetrics memMetrics;
+    return memMetrics;
+}
+
+// Subtract n from total without going below zero.
+// Returns the amount actually subtracted.
+//
+unsigned long long subClamped(std::atomic_ullong& total, unsigned long long n) {
+    unsigned long long cur = total.load();
+    unsigned long long dec;
+    do {
+        dec = (cur < n ? cur : n);
+    } while (!total.compare_exchange_weak(cur, cur - dec));
+    return dec;
+}
+}
+
 namespace lsst {
 namespace qserv {
 namespace memman {
@@ -83,15 +128,63 @@ std::string Memory::filePath(std::string const& dbTable,
     return fPath;
 }
 
+/******************************************************************************/
+/*                             m e m A d v i s e                              */
+/******************************************************************************/
+
+MemInfo Memory::memAdvise(std::string const& fPath) {
+
+    MemInfo     mInfo;
+    struct stat sBuff;
+    int         fdNum, rc;
+
+    // Open the file read-only, we never write to it nor map it.
+    //
+    fdNum = open(fPath.c_str(), O_RDONLY);
+    if (fdNum < 0 || fstat(fdNum, &sBuff)) {
+        mInfo.setErrCode(errno);
+        if (fdNum >= 0) close(fdNum);
+        return mInfo;
+    }
+
+    // Verify the size of the file
+    //
+    if (sBuff.st_size <= 0) {
+        close(fdNum);
+        mInfo.setErrCode(ESPIPE);
+        return mInfo;
+    }
+
+    // Start the read ahead. This is the file descriptor form of
+    // madvise(MADV_WILLNEED) and does not wait for the I/O to complete.
+    //
+    rc = posix_fadvise(fdNum, 0, 0, POSIX_FADV_WILLNEED);
+    if (rc) {
+        mInfo.setErrCode(rc);
+    } else {
+        mInfo._memSize = static_cast<uint64_t>(sBuff.st_size);
+        _advBytes += mInfo._memSize;
+        _advNum++;
+        metrics().bytesAdvised.add(mInfo._memSize);
+        metrics().numAdvised.add();
+    }
+
+    // Close the file and return result
+    //
+    close(fdNum);
+    return mInfo;
+}
+
 /******************************************************************************/
 /*                               m e m L o c k                                */
 /******************************************************************************/
   
 MemInfo Memory::memLock(std::string const& fPath, bool isFlex) {
 
-    MemInfo     mInfo;
-    struct stat sBuff;
-    int         fdNum;
+    MemInfo       mInfo;
+    struct stat   sBuff;
+    struct rusage ruBeg, ruEnd;
+    int           fdNum;
 
     // We first open the file. we currently open this R/W because we want to
     // disable copy on write operations when we memory map the file.
@@ -118,13 +211,27 @@ MemInfo Memory::memLock(std::string const& fPath, bool isFlex) {
     mInfo._memAddr = mmap(0, mInfo._memSize, PROT_WRITE, MAP_SHARED, fdNum, 0);
 
     // Diagnose any errors or update statistics. If succeeded, try locking it.
+    // Locking faults in every page. Count the faults taken by this thread:
+    // major faults had to be read from disk, minor ones were already cached.
     //
     if (mInfo._memAddr == MAP_FAILED) {
         mInfo.setErrCode(errno);
     } else {
+        bool haveRU = !getrusage(RUSAGE_THREAD, &ruBeg);
+        auto lockBeg = std::chrono::steady_clock::now();
         if (!mlock(mInfo._memAddr, mInfo._memSize)) {
+            MemMetrics& mm = metrics();
+            mm.lockMicros.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - lockBeg).count());
             _lokBytes += mInfo._memSize;
-            if (isFlex) _flexNum++;
+            mm.bytesLocked.add(mInfo._memSize);
+            if (isFlex) {_flexNum++; mm.numFlexLock.add();}
+            if (haveRU && !getrusage(RUSAGE_THREAD, &ruEnd)) {
+                _majFlt += ruEnd.ru_majflt - ruBeg.ru_majflt;
+                _minFlt += ruEnd.ru_minflt - ruBeg.ru_minflt;
+                mm.numMajFaults.add(ruEnd.ru_majflt - ruBeg.ru_majflt);
+                mm.numMinFaults.add(ruEnd.ru_minflt - ruBeg.ru_minflt);
+            }
         } else {
             int rc = (errno == EAGAIN ? ENOMEM : errno);
             munmap( mInfo._memAddr, mInfo._memSize);
@@ -148,14 +255,27 @@ void Memory::memRel(MemInfo& mInfo) {
     //
     if (mInfo._memSize > 0 && mInfo._memAddr != MAP_FAILED) {
         munmap(mInfo._memAddr, mInfo._memSize);
-        if (mInfo._memSize < _lokBytes) {
-            _lokBytes -= mInfo._memSize;
-        } else {
-            _lokBytes = 0;
-        }
+        metrics().bytesLocked.sub(subClamped(_lokBytes, mInfo._memSize));
         mInfo._memSize = 0;
         mInfo._memAddr = MAP_FAILED;
     }
 }
+
+/******************************************************************************/
+/*                             m e m R e s e r v e                            */
+/******************************************************************************/
+
+void Memory::memReserve(uint64_t memSZ) {
+    _rsvBytes += memSZ;
+    metrics().bytesReserved.add(memSZ);
+}
+
+/******************************************************************************/
+/*                             m e m R e s t o r e                            */
+/******************************************************************************/
+
+void Memory::memRestore(uint64_t memSZ) {
+    metrics().bytesReserved.sub(subClamped(_rsvBytes, memSZ));
+}
 }}} // namespace lsst:qserv:memman
 
@@ -136,6 +136,35 @@ public:
 
     uint64_t bytesMax() {return _maxBytes;}
 
+    //-----------------------------------------------------------------------------
+    //! Obtain total number of bytes read ahead by memAdvise().
+    //! This method is MT-safe.
+    //!
+    //! @return The number of bytes advised.
+    //-----------------------------------------------------------------------------
+
+    uint64_t bytesAdvised() {return _advBytes;}
+
+    //-----------------------------------------------------------------------------
+    //! Obtain number of files read ahead by memAdvise().
+    //! This method is MT-safe.
+    //!
+    //! @return The number of files advised.
+    //-----------------------------------------------------------------------------
+
+    uint32_t advNum() {return _advNum;}
+
+    //-----------------------------------------------------------------------------
+    //! Obtain number of page faults taken while locking files. Major faults
+    //! read the page from disk, minor faults found it in the page cache.
+    //! This method is MT-safe.
+    //!
+    //! @return The number of major or minor page faults.
+    //-----------------------------------------------------------------------------
+
+    uint64_t majFaults() {return _majFlt;}
+    uint64_t minFaults() {return _minFlt;}
+
     //-----------------------------------------------------------------------------
     //! @brief Get file information.
     //! This method is MT-safe.
@@ -179,7 +208,8 @@ public:
 
     //-----------------------------------------------------------------------------
     //! @brief Lock a database file in memory.
-    //! This method must be externally serialized, it is not MT-safe.
+    //! This method is MT-safe. Callers must reserve the file's memory first so
+    //! that concurrent calls cannot lock more than the allowed amount.
     //!
     //! @param  fPath  - Path of the database file to be locked in memory.
     //! @param  isFlex - When true this is a flexible file request.
@@ -190,6 +220,20 @@ public:
 
     MemInfo memLock(std::string const& fPath, bool isFlex=false);
 
+    //-----------------------------------------------------------------------------
+    //! @brief Ask the kernel to read a database file into the page cache.
+    //! Nothing is locked or mapped, so the file's pages may be evicted again
+    //! and are not counted as locked or reserved bytes.
+    //! This method is MT-safe.
+    //!
+    //! @param  fPath  - Path of the database file to be read ahead.
+    //!
+    //! @return A MemInfo object corresponding to the file. Use the MemInfo
+    //!         methods to determine if the read ahead was started.
+    //-----------------------------------------------------------------------------
+
+    MemInfo memAdvise(std::string const& fPath);
+
     //-----------------------------------------------------------------------------
     //! @brief Unlock a memory object.
     //! This method must be externally serialized, it is not MT-safe.
@@ -206,7 +250,7 @@ public:
     //! @param  memSZ   - Bytes of memory to reserve.
     //-----------------------------------------------------------------------------
 
-    void    memReserve(uint64_t memSZ) {_rsvBytes += memSZ;}
+    void    memReserve(uint64_t memSZ);
 
     //-----------------------------------------------------------------------------
     //! @brief Restore memory previously reserved.
@@ -215,10 +259,7 @@ public:
     //! @param  memSZ   - Bytes of memory to release.
     //-----------------------------------------------------------------------------
 
-    void    memRestore(uint64_t memSZ) {
-                       if (_rsvBytes <= memSZ) _rsvBytes = 0;
-                          else _rsvBytes -= memSZ;
-                      }
+    void    memRestore(uint64_t memSZ);
 
     //-----------------------------------------------------------------------------
     //! Constructor
@@ -229,7 +270,7 @@ public:
 
     Memory(std::string const& dbDir, uint64_t memSZ)
           : _dbDir(dbDir), _maxBytes(memSZ), _lokBytes(0), _rsvBytes(0),
-            _flexNum(0) {}
+            _advBytes(0), _majFlt(0), _minFlt(0), _flexNum(0), _advNum(0) {}
 
     ~Memory() {}
 
@@ -239,7 +280,11 @@ private:
     uint64_t           _maxBytes;
     std::atomic_ullong _lokBytes;
     std::atomic_ullong _rsvBytes;
+    std::atomic_ullong _advBytes;
+    std::atomic_ullong _majFlt;
+    std::atomic_ullong _minFlt;
     std::atomic_uint   _flexNum;
+    std::atomic_uint   _advNum;
 };
 }}} // namespace lsst:qserv:memman
 #endif  // LSST_QSERV_MEMMAN_MEMORY_H
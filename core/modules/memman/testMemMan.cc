@@ -0,0 +1,155 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Qserv headers
+#include "memman/MemMan.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE MemMan
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::memman::MemMan;
+using lsst::qserv::memman::TableInfo;
+
+namespace {
+
+uint64_t const bigSize   = 64*1024*1024;
+uint64_t const smallSize = 64*1024;
+
+struct TmpDir {
+    TmpDir() {
+        char tmpl[] = "/tmp/testMemMan.XXXXXX";
+        path = ::mkdtemp(tmpl);
+    }
+    ~TmpDir() {
+        std::system(("rm -rf " + path).c_str());
+    }
+    void makeFile(std::string const& name, uint64_t size) {
+        std::ofstream os(path + "/" + name, std::ios::binary);
+        std::string block(4096, 'x');
+        for (uint64_t j = 0; j < size; j += block.size()) os << block;
+    }
+    std::string path;
+};
+
+std::vector<TableInfo> tables(std::string const& name) {
+    return std::vector<TableInfo>{TableInfo(name, TableInfo::LockType::MUSTLOCK,
+                                                  TableInfo::LockType::NOLOCK)};
+}
+
+void checkEmpty(MemMan& memMan) {
+    auto stats = memMan.getStatistics();
+    BOOST_CHECK_EQUAL(stats.numFSets, 0U);
+    BOOST_CHECK_EQUAL(stats.numFiles, 0U);
+    BOOST_CHECK_EQUAL(stats.bytesLocked, 0U);
+    BOOST_CHECK_EQUAL(stats.bytesReserved, 0U);
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+/// A long lock (the prefetch thread faulting in a chunk) must not stop other
+/// threads from unlocking their chunks or reading statistics.
+BOOST_AUTO_TEST_CASE(UnlockDuringLock) {
+    TmpDir tmp;
+    tmp.makeFile("Big_1.MYD", bigSize);
+    tmp.makeFile("Small_2.MYD", smallSize);
+    std::unique_ptr<MemMan> memMan(MemMan::create(4*bigSize, tmp.path));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> bigLocks{0};
+    std::thread prefetch([&]() {
+        for (int j = 0; j < 10; ++j) {
+            auto handle = memMan->lock(tables("Big"), 1);
+            if (handle != MemMan::HandleType::INVALID) ++bigLocks;
+            memMan->unlock(handle);
+        }
+        done = true;
+    });
+
+    int smallLocks = 0;
+    while (!done) {
+        auto handle = memMan->lock(tables("Small"), 2);
+        BOOST_REQUIRE(handle != MemMan::HandleType::INVALID);
+        ++smallLocks;
+        auto stats = memMan->getStatistics();
+        BOOST_CHECK(stats.bytesLocked + stats.bytesReserved <= stats.bytesLockMax);
+        BOOST_CHECK(memMan->unlock(handle));
+    }
+    prefetch.join();
+
+    BOOST_CHECK_EQUAL(bigLocks, 10);
+    BOOST_CHECK(smallLocks > 0);
+    checkEmpty(*memMan);
+}
+
+/// Two threads locking the same chunk share one copy of its memory.
+BOOST_AUTO_TEST_CASE(ConcurrentSameChunk) {
+    TmpDir tmp;
+    tmp.makeFile("Big_1.MYD", bigSize);
+    std::unique_ptr<MemMan> memMan(MemMan::create(4*bigSize, tmp.path));
+
+    MemMan::Handle h1 = MemMan::HandleType::INVALID;
+    MemMan::Handle h2 = MemMan::HandleType::INVALID;
+    std::thread t1([&]() { h1 = memMan->lock(tables("Big"), 1); });
+    std::thread t2([&]() { h2 = memMan->lock(tables("Big"), 1); });
+    t1.join();
+    t2.join();
+    BOOST_REQUIRE(h1 != MemMan::HandleType::INVALID);
+    BOOST_REQUIRE(h2 != MemMan::HandleType::INVALID);
+
+    auto stats = memMan->getStatistics();
+    BOOST_CHECK_EQUAL(stats.numFSets, 2U);
+    BOOST_CHECK_EQUAL(stats.numFiles, 1U);
+    BOOST_CHECK_EQUAL(stats.bytesLocked + stats.bytesReserved, bigSize);
+
+    BOOST_CHECK(memMan->unlock(h1));
+    BOOST_CHECK(memMan->unlock(h2));
+    checkEmpty(*memMan);
+}
+
+/// A chunk larger than the managed memory fails without leaving a reservation.
+BOOST_AUTO_TEST_CASE(TooBig) {
+    TmpDir tmp;
+    tmp.makeFile("Big_1.MYD", bigSize);
+    std::unique_ptr<MemMan> memMan(MemMan::create(bigSize/2, tmp.path));
+
+    auto handle = memMan->lock(tables("Big"), 1);
+    BOOST_CHECK(handle == MemMan::HandleType::INVALID);
+    checkEmpty(*memMan);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
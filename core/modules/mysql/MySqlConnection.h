@@ -38,6 +38,9 @@
 #include "boost/utility.hpp"
 #include <mysql/mysql.h>
 
+// Qserv headers
+#include "util/InstanceCount.h"
+
 namespace lsst {
 namespace qserv {
 namespace mysql {
@@ -97,6 +100,9 @@ private:
     bool _isExecuting; ///< true during mysql_real_query and mysql_use_result
     bool _interrupted; ///< true if cancellation requested
     std::mutex _interruptMutex;
+    /// Reported in the stats.
+    util::InstanceCount _instC{"MySqlConnection",
+                               util::InstanceCount::gauge<MySqlConnection>("MySqlConnection")};
 };
 
 }}} // namespace lsst::qserv::mysql
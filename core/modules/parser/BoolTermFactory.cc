@@ -44,6 +44,7 @@
 #include "parser/SqlSQL2Parser.hpp" // (generated) SqlSQL2TokenTypes
 #include "parser/ValueExprFactory.h"
 #include "query/Predicate.h"
+#include "util/Arena.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.parser.BoolTermFactory");
@@ -180,7 +181,7 @@ BoolTermFactory::newBoolTerm(antlr::RefAST a) {
 /// Construct a new OrTerm from a node
 query::OrTerm::Ptr
 BoolTermFactory::newOrTerm(antlr::RefAST a) {
-    query::OrTerm::Ptr p = std::make_shared<query::OrTerm>();
+    query::OrTerm::Ptr p = util::makeShared<query::OrTerm>();
     multiImport<query::OrTerm> oi(*this, *p);
     matchType matchOr(SqlSQL2TokenTypes::SQL2RW_or);
     applyExcept<multiImport<query::OrTerm>,matchType> ae(oi, matchOr);
@@ -190,7 +191,7 @@ BoolTermFactory::newOrTerm(antlr::RefAST a) {
 /// Construct a new AndTerm from a node
 query::AndTerm::Ptr
 BoolTermFactory::newAndTerm(antlr::RefAST a) {
-    query::AndTerm::Ptr p = std::make_shared<query::AndTerm>();
+    query::AndTerm::Ptr p = util::makeShared<query::AndTerm>();
     multiImport<query::AndTerm> ai(*this, *p);
     matchType matchAnd(SqlSQL2TokenTypes::SQL2RW_and);
     applyExcept<multiImport<query::AndTerm>,matchType> ae(ai, matchAnd);
@@ -208,7 +209,7 @@ BoolTermFactory::newBoolFactor(antlr::RefAST a) {
         LOGS(_log, LOG_LVL_DEBUG, "bool factor: " << ss.str());
     }
 #endif
-    query::BoolFactor::Ptr bf = std::make_shared<query::BoolFactor>();
+    query::BoolFactor::Ptr bf = util::makeShared<query::BoolFactor>();
     bfImport bfi(*this, *bf);
     forEachSibs(a, bfi);
     return bf;
@@ -217,13 +218,13 @@ BoolTermFactory::newBoolFactor(antlr::RefAST a) {
 query::UnknownTerm::Ptr
 BoolTermFactory::newUnknown(antlr::RefAST a) {
     LOGS(_log, LOG_LVL_DEBUG, "unknown term: " << walkTreeString(a));
-    query::UnknownTerm::Ptr p = std::make_shared<query::UnknownTerm>();
+    query::UnknownTerm::Ptr p = util::makeShared<query::UnknownTerm>();
     return p;
 }
 /// Construct an PassTerm
 query::PassTerm::Ptr
 BoolTermFactory::newPassTerm(antlr::RefAST a) {
-    query::PassTerm::Ptr p = std::make_shared<query::PassTerm>();
+    query::PassTerm::Ptr p = util::makeShared<query::PassTerm>();
     p->_text = tokenText(a); // FIXME: Should this be a tree walk?
     return p;
 }
@@ -231,7 +232,7 @@ BoolTermFactory::newPassTerm(antlr::RefAST a) {
 /// Construct an BoolTermFactor
 query::BoolTermFactor::Ptr
 BoolTermFactory::newBoolTermFactor(antlr::RefAST a) {
-    query::BoolTermFactor::Ptr p = std::make_shared<query::BoolTermFactor>();
+    query::BoolTermFactor::Ptr p = util::makeShared<query::BoolTermFactor>();
     p->_term = newBoolTerm(a);
     return p;
 }
@@ -43,6 +43,7 @@
 #include "query/ValueFactor.h" // For ValueFactor
 #include "parser/ParseException.h" //
 #include "parser/SqlSQL2TokenTypes.hpp" // antlr-generated
+#include "util/Arena.h"
 
 
 using antlr::RefAST;
@@ -68,7 +69,7 @@ ValueExprFactory::ValueExprFactory(std::shared_ptr<ColumnRefNodeMap> cMap)
 /// @param first child of VALUE_EXP node.
 std::shared_ptr<query::ValueExpr>
 ValueExprFactory::newExpr(antlr::RefAST a) {
-    std::shared_ptr<query::ValueExpr> expr = std::make_shared<query::ValueExpr>();
+    std::shared_ptr<query::ValueExpr> expr = util::makeShared<query::ValueExpr>();
     while(a.get()) {
         query::ValueExpr::FactorOp newFactorOp;
         RefAST op = a->getNextSibling();
@@ -50,6 +50,7 @@
 #include "query/FuncExpr.h"
 #include "query/ValueExpr.h"   // For ValueExpr
 #include "query/ValueFactor.h" // For ValueFactor
+#include "util/Arena.h"
 
 // namespace modifiers
 using antlr::RefAST;
@@ -153,7 +154,7 @@ ValueFactorFactory::_newColumnFactor(antlr::RefAST t) {
         t = child;
         child = t->getFirstChild();
     }
-    std::shared_ptr<query::ValueFactor> vt = std::make_shared<query::ValueFactor>();
+    std::shared_ptr<query::ValueFactor> vt = util::makeShared<query::ValueFactor>();
     std::shared_ptr<query::FuncExpr> fe;
     RefAST last;
     int tType = t->getType();
@@ -172,7 +173,7 @@ ValueFactorFactory::_newColumnFactor(antlr::RefAST t) {
             ColumnRefNodeMap::Ref r = it->second;
 
             std::shared_ptr<query::ColumnRef> newColumnRef;
-            newColumnRef = std::make_shared<query::ColumnRef>(
+            newColumnRef = util::makeShared<query::ColumnRef>(
                     tokenText(r.db),
                     tokenText(r.table),
                     tokenText(r.column));
@@ -180,7 +181,7 @@ ValueFactorFactory::_newColumnFactor(antlr::RefAST t) {
         }
         return vt;
     case SqlSQL2TokenTypes::FUNCTION_SPEC:
-        fe = std::make_shared<query::FuncExpr>();
+        fe = util::makeShared<query::FuncExpr>();
         last = walkToSiblingBefore(child, SqlSQL2TokenTypes::LEFT_PAREN);
         fe->name = getSiblingStringBounded(child, last);
         last = last->getNextSibling(); // Advance to LEFT_PAREN
@@ -222,7 +223,7 @@ std::shared_ptr<query::ValueFactor>
 ValueFactorFactory::_newSetFctSpec(antlr::RefAST expr) {
     assert(_columnRefNodeMap);
     // ColumnRefNodeMap& cMap = *_columnRefNodeMap; // for gdb
-    std::shared_ptr<query::FuncExpr> fe = std::make_shared<query::FuncExpr>();
+    std::shared_ptr<query::FuncExpr> fe = util::makeShared<query::FuncExpr>();
     RefAST nNode = expr->getFirstChild();
     if (!nNode.get()) {
         throw ParseException("Missing name node of function spec", expr);
@@ -257,7 +258,7 @@ ValueFactorFactory::_newSetFctSpec(antlr::RefAST expr) {
 std::shared_ptr<query::ValueFactor>
 ValueFactorFactory::_newFunctionSpecFactor(antlr::RefAST fspec) {
     assert(_columnRefNodeMap);
-    std::shared_ptr<query::FuncExpr> fe = std::make_shared<query::FuncExpr>();
+    std::shared_ptr<query::FuncExpr> fe = util::makeShared<query::FuncExpr>();
     RefAST nNode = fspec->getFirstChild();
     if (!nNode.get()) {
         throw ParseException("Missing name node of function spec", fspec);
@@ -110,6 +110,22 @@ killQuery(std::string const& query, std::string const& clientId) {
     return ::_czar->killQuery(query, clientId);
 }
 
+std::vector<std::string>
+getStats() {
+    if (not ::_czar) {
+        throw std::runtime_error("czarProxy/getStats(): czar instance not initialized");
+    }
+    return ::_czar->getStats();
+}
+
+std::vector<std::string>
+getWorkerStats(std::string const& hostPort) {
+    if (not ::_czar) {
+        throw std::runtime_error("czarProxy/getWorkerStats(): czar instance not initialized");
+    }
+    return ::_czar->getWorkerStats(hostPort);
+}
+
 void log(std::string const& loggername, std::string const& level,
          std::string const& filename, std::string const& funcname,
          unsigned int lineno, std::string const& message) {
@@ -79,6 +79,21 @@ czar::SubmitResult submitQuery(std::string const& query,
  */
 std::string killQuery(std::string const& query, std::string const& clientId);
 
+/**
+ * Report the state of the czar, for "SHOW QSERV STATS".
+ *
+ * @return one "name value" string per statistic.
+ */
+std::vector<std::string> getStats();
+
+/**
+ * Fetch the statistics of one worker, for "SHOW QSERV STATS FOR WORKER".
+ *
+ * @param hostPort host:port of the xrootd server of the worker.
+ * @return one "name value" string per statistic.
+ */
+std::vector<std::string> getWorkerStats(std::string const& hostPort);
+
 /**
  *  Send message to logging system. level is a string like "DEBUG".
  */
@@ -243,6 +243,14 @@ function queryType()
     end
     ---------------------------------------------------------------------------
 
+    local isStats = function(qU)
+        if string.find(qU, "^SHOW QSERV STATS") then
+            return true
+        end
+        return false
+    end
+    ---------------------------------------------------------------------------
+
     local isIgnored = function(qU)
         -- SET is already in isLocal() so this always returns false for now
         if string.find(qU, "^SET ") then
@@ -271,6 +279,7 @@ function queryType()
         shouldPassToResultDb = shouldPassToResultDb,
         isDisallowed = isDisallowed,
         isKill = isKill,
+        isStats = isStats,
         isIgnored = isIgnored,
         isNotSupported = isNotSupported
     }
@@ -403,6 +412,49 @@ function queryProcessing()
 
     ---------------------------------------------------------------------------
 
+    local showQservStats = function(q, qU)
+        -- "SHOW QSERV STATS FOR WORKER 'host:port'" asks that worker,
+        -- the host name is taken from q to keep its case
+        local worker = nil
+        local _, e = string.find(qU, "^SHOW QSERV STATS FOR WORKER ")
+        if e then
+            worker = string.match(string.sub(q, e + 1), "^'?([^' ;]+)'?")
+        end
+        local ok, stats
+        if worker then
+            ok, stats = pcall(czarProxy.getWorkerStats, worker)
+        else
+            ok, stats = pcall(czarProxy.getStats)
+        end
+        if (not ok) then
+            return err.set(ERR_CZAR_EXCEPTION, "Exception in call to czar method: " .. stats)
+        end
+
+        -- Assemble result, one row per "name value" line
+        local rows = {}
+        for i, line in ipairs(stats) do
+            local name, value = string.match(line, "^(%S+) (%S+)$")
+            rows[i] = {name, value}
+        end
+        proxy.response.type = proxy.MYSQLD_PACKET_OK
+        proxy.response.resultset = {
+           fields = {
+              {
+                 type = proxy.MYSQL_TYPE_STRING,
+                 name = "name",
+              },
+              {
+                 type = proxy.MYSQL_TYPE_STRING,
+                 name = "value",
+              },
+           },
+           rows = rows
+        }
+        return proxy.PROXY_SEND_RESULT
+    end
+
+    ---------------------------------------------------------------------------
+
     local prepForFetchingResults = function(proxy)
         if not self.resultTableName then
             return err.set(ERR_BAD_RES_TNAME, "Invalid result table name")
@@ -440,6 +492,7 @@ function queryProcessing()
         initializeCzar = initializeCzar,
         sendToQserv = sendToQserv,
         killQservQuery = killQservQuery,
+        showQservStats = showQservStats,
         processLocally = processLocally,
         processIgnored = processIgnored,
         prepForFetchingResults = prepForFetchingResults
@@ -474,7 +527,13 @@ function read_query(packet)
         -- check for special queries that can be handled locally
         -- note we make no modifications to proxy.queries,
         -- so the packet will be sent as-is
-        if qType.isLocal(qU) then
+        if qType.isStats(qU) then
+            local statsResult = qProc.showQservStats(q, qU)
+            if statsResult ~= proxy.PROXY_SEND_RESULT then
+                return err.send()
+            end
+            return statsResult
+        elseif qType.isLocal(qU) then
             return qProc.processLocally(qU)
         elseif qType.isIgnored(qU) then
             return qProc.processIgnored(qU)
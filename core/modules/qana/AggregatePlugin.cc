@@ -45,11 +45,11 @@
 #include "query/AggOp.h"
 #include "query/FuncExpr.h"
 #include "query/QueryContext.h"
-#include "query/QueryTemplate.h"
 #include "query/SelectList.h"
 #include "query/SelectStmt.h"
 #include "query/ValueExpr.h"
 #include "query/ValueFactor.h"
+#include "util/Arena.h"
 #include "util/common.h"
 
 namespace {
@@ -62,7 +62,7 @@ namespace qana {
 
 inline query::ValueExprPtr
 newExprFromAlias(std::string const& alias) {
-    std::shared_ptr<query::ColumnRef> cr = std::make_shared<query::ColumnRef>("", "", alias);
+    std::shared_ptr<query::ColumnRef> cr = util::makeShared<query::ColumnRef>("", "", alias);
     std::shared_ptr<query::ValueFactor> vf;
     vf = query::ValueFactor::newColumnRefFactor(cr);
     return query::ValueExpr::newSimple(vf);
@@ -114,7 +114,7 @@ private:
         // constituent ValueFactors, compute the lists in parallel, and
         // then compute the expression result from the parallel
         // results during merging.
-        query::ValueExprPtr mergeExpr = std::make_shared<query::ValueExpr>();
+        query::ValueExprPtr mergeExpr = util::makeShared<query::ValueExpr>();
         query::ValueExpr::FactorOpVector& mergeFactorOps = mergeExpr->getFactorOps();
         query::ValueExpr::FactorOpVector const& factorOps = e.getFactorOps();
         for(query::ValueExpr::FactorOpVector::const_iterator i=factorOps.begin();
@@ -234,10 +234,6 @@ AggregatePlugin::applyPhysical(QueryPlugin::Plan& plan,
                                              *mList.getValueExprList(),
                                              m);
     std::for_each(vlist->begin(), vlist->end(), ca);
-    query::QueryTemplate qt;
-    pList.renderTo(qt);
-    qt.clear();
-    mList.renderTo(qt);
     // Also need to operate on GROUP BY.
     // update context.
     if (plan.stmtOriginal.getDistinct() || m.hasAggregate()) {
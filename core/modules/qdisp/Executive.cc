@@ -64,6 +64,7 @@
 #include "qdisp/QueryResource.h"
 #include "qdisp/ResponseHandler.h"
 #include "qdisp/XrdSsiMocks.h"
+#include "util/Metrics.h"
 
 extern XrdSsiProvider *XrdSsiProviderClient;
 
@@ -71,6 +72,9 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.qdisp.Executive");
 
+/// Jobs of all user queries that have not completed, reported in the czar stats.
+lsst::qserv::util::Gauge& jobsInFlight = lsst::qserv::util::Metrics::get().gauge("qdisp.jobsInFlight");
+
 std::string getErrorText(XrdSsiErrInfo & e) {
     std::ostringstream os;
     int errCode;
@@ -186,9 +190,17 @@ bool Executive::join() {
         std::lock_guard<std::recursive_mutex> lock(_jobsMutex);
         sCount = std::count_if(_jobMap.begin(), _jobMap.end(), successF::f);
     }
+    bool superfluousOk = false;
+    if (_superfluous) {
+        std::lock_guard<std::mutex> lock(_errorsMutex);
+        superfluousOk = _multiError.empty();
+    }
     if (sCount == _requestCount) {
         LOGS(_log, LOG_LVL_DEBUG, "Query execution succeeded: " << _requestCount
              << " jobs dispatched and completed.");
+    } else if (superfluousOk) {
+        LOGS(_log, LOG_LVL_DEBUG, "Query execution succeeded: " << _requestCount
+             << " jobs dispatched, " << sCount << " completed, the rest were not needed.");
     } else {
         LOGS(_log, LOG_LVL_ERROR, "Query execution failed: " << _requestCount
              << " jobs dispatched, but only " << sCount << " jobs completed");
@@ -198,7 +210,7 @@ bool Executive::join() {
     _empty.store(empty);
     LOGS(_log, LOG_LVL_DEBUG, "Flag set to _empty=" << empty << ", sCount=" << sCount
          << ", requestCount=" << _requestCount);
-    return empty;
+    return empty || superfluousOk;
 }
 
 void Executive::markCompleted(int jobId, bool success) {
@@ -206,6 +218,14 @@ void Executive::markCompleted(int jobId, bool success) {
     std::string idStr = qmeta::QueryIdHelper::makeIdStr(_id, jobId);
     LOGS(_log, LOG_LVL_DEBUG, "Executive::markCompleted " << idStr
             << " " << success);
+    if (!success && _superfluous) {
+        // Failures of jobs whose results are no longer needed are expected,
+        // most of them are caused by the squash.
+        LOGS(_log, LOG_LVL_DEBUG, "Executive: ignoring failure of superfluous " << idStr);
+        _unTrack(jobId);
+        squash();
+        return;
+    }
     if (!success) {
         {
             std::lock_guard<std::mutex> lock(_incompleteJobsMutex);
@@ -236,6 +256,8 @@ void Executive::markCompleted(int jobId, bool success) {
         LOGS(_log, LOG_LVL_ERROR, "Executive: requesting squash, cause: "
              << idStr << " failed (code=" << err.getCode() << " " << err.getMsg() << ")");
         squash(); // ask to squash
+    } else if (_superfluous) {
+        squash();
     }
 }
 
@@ -262,6 +284,15 @@ void Executive::squash() {
     LOGS_DEBUG(_id << " Executive::squash done");
 }
 
+void Executive::squashSuperfluous() {
+    if (_superfluous.exchange(true)) {
+        return;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, _id << " Executive::squashSuperfluous remaining jobs not needed");
+    // The job that delivered the last needed rows is still in flight,
+    // markCompleted() squashes the rest when it or any other job completes.
+}
+
 int Executive::getNumInflight() {
     std::unique_lock<std::mutex> lock(_incompleteJobsMutex);
     return _incompleteJobs.size();
@@ -324,6 +355,7 @@ bool Executive::_track(int jobId, std::shared_ptr<JobQuery> const& r) {
         }
         _incompleteJobs[jobId] = r;
     }
+    jobsInFlight.add();
     LOGS(_log, LOG_LVL_DEBUG, "Success TRACKING " << idStr);
     return true;
 }
@@ -338,6 +370,7 @@ void Executive::_unTrack(int jobId) {
         if (i != _incompleteJobs.end()) {
             _incompleteJobs.erase(i);
             untracked = true;
+            jobsInFlight.sub();
             if (_incompleteJobs.empty()) _allJobsComplete.notify_all();
         }
         size = _incompleteJobs.size();
@@ -435,10 +468,37 @@ void Executive::_waitAllUntilEmpty() {
                 lock.lock();
             }
         }
-        _allJobsComplete.wait_for(lock, statePrintDelay);
+        auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(statePrintDelay);
+        if (_onSlow) {
+            auto toSlow = std::chrono::duration_cast<std::chrono::milliseconds>(
+                _created + _slowLimit - std::chrono::steady_clock::now());
+            if (toSlow.count() <= 0) {
+                auto onSlow = std::move(_onSlow);
+                _onSlow = nullptr;
+                lock.unlock();
+                LOGS(_log, LOG_LVL_WARN, _idStr << " still " << count << " in flight after "
+                     << _slowLimit.count() << "s, query is slow");
+                onSlow();
+                lock.lock();
+                continue;
+            }
+            waitTime = std::min(waitTime, toSlow);
+        }
+        _allJobsComplete.wait_for(lock, waitTime);
     }
 }
 
+void Executive::setSlowHandler(std::chrono::seconds limit, std::function<void()> const& onSlow) {
+    std::lock_guard<std::mutex> lock(_incompleteJobsMutex);
+    _slowLimit = limit;
+    _onSlow = onSlow;
+}
+
+void Executive::printState(std::ostream& os) {
+    std::lock_guard<std::mutex> lock(_incompleteJobsMutex);
+    _printState(os);
+}
+
 std::ostream& operator<<(std::ostream& os, Executive::JobMap::value_type const& v) {
     JobStatus::Ptr status = v.second->getStatus();
     os << v.first << ": " << *status;
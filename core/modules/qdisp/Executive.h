@@ -28,6 +28,8 @@
 
 // System headers
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <mutex>
 #include <sstream>
 #include <vector>
@@ -92,6 +94,28 @@ public:
     /// Squash all the jobs.
     void squash();
 
+    /// Squash the remaining jobs because the rows merged so far already
+    /// satisfy the query (e.g. its LIMIT has been reached). The squash is
+    /// deferred until the next job completes, so that it never runs inside
+    /// response processing. Jobs failing after this point are not errors,
+    /// and join() reports success.
+    void squashSuperfluous();
+
+    /// @return true if squashSuperfluous() has been called.
+    bool getSuperfluous() const { return _superfluous; }
+
+    /// Block until all jobs added so far have completed, without
+    /// evaluating the outcome. Used to dispatch jobs in waves.
+    void waitInflight() { _waitAllUntilEmpty(); }
+
+    /// Call 'onSlow' once, from join() or waitInflight(), if jobs are still
+    /// in flight 'limit' after this Executive was created. It is called
+    /// with no lock held, so it may call printState().
+    void setSlowHandler(std::chrono::seconds limit, std::function<void()> const& onSlow);
+
+    /// Write the state of each job in flight to 'os'.
+    void printState(std::ostream& os);
+
     bool getEmpty() { return _empty; }
 
     void setQueryId(qmeta::QueryId id);
@@ -142,6 +166,7 @@ private:
 
     int _requestCount; ///< Count of submitted jobs
     util::Flag<bool> _cancelled {false}; ///< Has execution been cancelled.
+    std::atomic<bool> _superfluous {false}; ///< Remaining jobs are not needed.
 
     // Mutexes
     std::mutex _incompleteJobsMutex; ///< protect incompleteJobs map.
@@ -150,11 +175,16 @@ private:
     mutable std::mutex _errorsMutex;
 
     std::condition_variable _allJobsComplete;
+
+    std::chrono::steady_clock::time_point const _created{std::chrono::steady_clock::now()};
+    std::chrono::seconds _slowLimit{0};
+    std::function<void()> _onSlow; ///< protected by _incompleteJobsMutex
     mutable std::recursive_mutex _jobsMutex;
 
     qmeta::QueryId _id{0}; ///< Unique identifier for this query.
     std::string    _idStr{qmeta::QueryIdHelper::makeIdStr(0, true)};
-    util::InstanceCount _instC{"Executive"};
+    util::InstanceCount _instC{"Executive",
+                               util::InstanceCount::gauge<Executive>("Executive")};
 };
 
 class MarkCompleteFunc {
@@ -164,8 +194,11 @@ public:
     MarkCompleteFunc(Executive* e, int jobId) : _executive(e), _jobId(jobId) {}
     virtual ~MarkCompleteFunc() {}
 
+    /// Report the completion of the job to the Executive. Only the first
+    /// call has an effect, as a cancelled job may also be completed by the
+    /// code that was running it.
     virtual void operator()(bool success) {
-        if (_executive) {
+        if (_executive && !_called.exchange(true)) {
             _executive->markCompleted(_jobId, success);
         }
     }
@@ -173,6 +206,7 @@ public:
 private:
     Executive* _executive;
     int _jobId;
+    std::atomic<bool> _called{false};
 };
 
 }}} // namespace lsst::qserv::qdisp
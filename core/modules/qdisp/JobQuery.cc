@@ -124,7 +124,7 @@ bool JobQuery::cancel() {
             os << getIdStr() <<" cancel before QueryRequest" ;
             LOGS_DEBUG(os.str());
             getDescription().respHandler()->errorFlush(os.str(), -1);
-            _executive->markCompleted(getIdInt(), false);
+            _markCompleteFunc->operator ()(false);
         }
         _jobDescription.respHandler()->processCancel();
         return true;
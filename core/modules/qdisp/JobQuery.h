@@ -129,7 +129,8 @@ protected:
 
     // Cancellation
     std::atomic<bool> _cancelled {false};
-    util::InstanceCount _instC{"JobQuery"};
+    util::InstanceCount _instC{"JobQuery",
+                               util::InstanceCount::gauge<JobQuery>("JobQuery")};
 };
 
 }}} // end namespace
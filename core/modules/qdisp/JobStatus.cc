@@ -56,10 +56,11 @@ JobStatus::Info::Info()
 }
 
 void JobStatus::updateInfo(JobStatus::State s, int code, std::string const& desc) {
-    std::lock_guard<std::mutex> lock(_mutex);
-
     LOGS(_log, LOG_LVL_TRACE, "Updating " << (void*) this << " state to: " << s);
-    _info.stateTime = ::time(NULL);
+    time_t now = ::time(NULL);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _info.stateTime = now;
     _info.state = s;
     _info.stateCode = code;
     _info.stateDesc = desc;
@@ -75,7 +75,8 @@ private:
     XrdSsiSession* _xrdSsiSession {nullptr}; ///< unowned, do not delete.
     std::shared_ptr<JobQuery> _jobQuery;
     std::string const _jobIdStr; ///< for debugging only
-    util::InstanceCount _instC{"QueryResource"};
+    util::InstanceCount _instC{"QueryResource",
+                               util::InstanceCount::gauge<QueryResource>("QueryResource")};
 };
 
 }}} // namespace lsst::qserv::qdisp
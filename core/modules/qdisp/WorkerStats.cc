@@ -0,0 +1,214 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qdisp/WorkerStats.h"
+
+// System headers
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string.h>
+
+// Third-party headers
+#include "XrdSsi/XrdSsiErrInfo.hh"
+#include "XrdSsi/XrdSsiProvider.hh"
+#include "XrdSsi/XrdSsiRequest.hh"
+#include "XrdSsi/XrdSsiService.hh"
+#include "XrdSsi/XrdSsiSession.hh"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "global/ResourceUnit.h"
+
+extern XrdSsiProvider *XrdSsiProviderClient;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qdisp.WorkerStats");
+
+/// The reply of the worker, shared by fetch() and the xrootd callbacks,
+/// which may outlive fetch() when it times out.
+class Reply {
+public:
+    typedef std::shared_ptr<Reply> Ptr;
+
+    void append(char const* buff, int blen) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _data.append(buff, blen);
+    }
+
+    /// Mark the reply complete, with an error unless msg is empty.
+    void finish(std::string const& msg) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _error = msg;
+        _done = true;
+        _cv.notify_all();
+    }
+
+    /// Wait for the reply and return its data.
+    std::string wait(std::chrono::seconds timeout) {
+        std::unique_lock<std::mutex> lock(_mtx);
+        if (!_cv.wait_for(lock, timeout, [this]() { return _done; })) {
+            throw std::runtime_error("no reply");
+        }
+        if (!_error.empty()) {
+            throw std::runtime_error(_error);
+        }
+        return _data;
+    }
+
+private:
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    bool _done {false};
+    std::string _error;
+    std::string _data;
+};
+
+/// Request with an empty payload, the resource alone selects the reply.
+/// Deletes itself once the reply is complete.
+class StatsRequest : public XrdSsiRequest {
+public:
+    StatsRequest(XrdSsiSession* session, Reply::Ptr const& reply)
+        : _session(session), _reply(reply), _buffer(64*1024) {}
+
+    char* GetRequest(int& requestLength) override {
+        requestLength = 0;
+        return &_buffer[0];
+    }
+
+    bool ProcessResponse(XrdSsiRespInfo const& rInfo, bool isOk) override {
+        if (!isOk) {
+            int code = 0;
+            char const* msg = eInfo.Get(code);
+            _done(std::string("request failed: ") + (msg ? msg : "no message from XrdSsi"));
+        } else if (rInfo.rType == XrdSsiRespInfo::isError) {
+            _done(std::string("worker error: ") + rInfo.eMsg);
+        } else if (rInfo.rType != XrdSsiRespInfo::isStream) {
+            _done("unexpected response type");
+        } else if (!GetResponseData(&_buffer[0], _buffer.size())) {
+            _done("GetResponseData failed");
+        }
+        return true;
+    }
+
+    void ProcessResponseData(char* buff, int blen, bool last) override {
+        if (blen < 0) {
+            int code = 0;
+            char const* msg = eInfo.Get(code);
+            _done(std::string("response data error: ") + (msg ? msg : "no message from XrdSsi"));
+            return;
+        }
+        _reply->append(buff, blen);
+        if (last) {
+            _done(std::string());
+        } else if (!GetResponseData(&_buffer[0], _buffer.size())) {
+            _done("GetResponseData failed");
+        }
+    }
+
+private:
+    /// Complete the reply and release this request and its session.
+    void _done(std::string const& msg) {
+        _reply->finish(msg);
+        Finished(!msg.empty());
+        _session->Unprovision();
+        delete this;
+    }
+
+    XrdSsiSession* _session; ///< unowned
+    Reply::Ptr _reply;
+    std::vector<char> _buffer;
+};
+
+/// Resource for the "/stats" unit of the worker. Deletes itself once
+/// provisioning is done.
+class StatsResource : public XrdSsiService::Resource {
+public:
+    StatsResource(std::string const& path, Reply::Ptr const& reply)
+        : Resource(::strdup(path.c_str())), _reply(reply) {}
+
+    ~StatsResource() {
+        std::free(const_cast<char*>(rName));
+    }
+
+    void ProvisionDone(XrdSsiSession* s) override {
+        if (s == nullptr) {
+            int code = 0;
+            char const* msg = eInfo.Get(code);
+            _reply->finish(std::string("provisioning failed: ") + (msg ? msg : "no message from XrdSsi"));
+        } else {
+            s->ProcessRequest(new StatsRequest(s, _reply));
+        }
+        delete this;
+    }
+
+private:
+    Reply::Ptr _reply;
+};
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+std::vector<std::string>
+WorkerStats::fetch(std::string const& hostPort, std::chrono::seconds timeout) {
+    XrdSsiErrInfo eInfo;
+    XrdSsiService* service = XrdSsiProviderClient->GetService(eInfo, hostPort.c_str());
+    if (service == nullptr) {
+        int code = 0;
+        char const* msg = eInfo.Get(code);
+        throw std::runtime_error("WorkerStats " + hostPort + ": no service: "
+                                 + (msg ? msg : "no message from XrdSsi"));
+    }
+
+    ResourceUnit ru;
+    ru.setAsStats();
+    auto reply = std::make_shared<Reply>();
+    LOGS(_log, LOG_LVL_DEBUG, "WorkerStats fetching " << ru.path() << " from " << hostPort);
+    service->Provision(new StatsResource(ru.path(), reply));
+    std::string data;
+    try {
+        data = reply->wait(timeout);
+    } catch (std::runtime_error const& e) {
+        throw std::runtime_error("WorkerStats " + hostPort + ": " + e.what());
+    }
+
+    std::vector<std::string> lines;
+    std::istringstream is(data);
+    std::string line;
+    while (std::getline(is, line)) {
+        if (!line.empty()) lines.push_back(line);
+    }
+    return lines;
+}
+
+}}} // namespace lsst::qserv::qdisp
@@ -0,0 +1,54 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QDISP_WORKERSTATS_H
+#define LSST_QSERV_QDISP_WORKERSTATS_H
+
+// System headers
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+/// WorkerStats fetches the statistics a worker serves on the XrdSsi
+/// resource "/stats" (see xrdsvc::SsiSession), bypassing the redirector.
+class WorkerStats {
+public:
+    /**
+     * Fetch the statistics of one worker.
+     *
+     * @param hostPort host:port of the xrootd server of the worker.
+     * @param timeout longest time to wait for the reply.
+     * @return one "name value" string per statistic, sorted by name.
+     * @throws std::runtime_error if the worker could not be reached, replied
+     *         with an error, or did not reply within timeout.
+     */
+    static std::vector<std::string> fetch(std::string const& hostPort,
+                                          std::chrono::seconds timeout);
+};
+
+}}} // namespace lsst::qserv::qdisp
+
+#endif // LSST_QSERV_QDISP_WORKERSTATS_H
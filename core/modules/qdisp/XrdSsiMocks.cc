@@ -35,6 +35,7 @@
 
 // Local headers
 #include "qdisp/Executive.h"
+#include "qdisp/ResponseHandler.h"
 #include "qdisp/XrdSsiMocks.h"
 
 using namespace std;
@@ -55,14 +56,31 @@ public:
     static std::string const& getPayload(QueryResource& qr) {
         return qr.getJobQuery()->getDescription().payload();
     }
-    static void finish(QueryResource& qr) {
+    static ResponseHandler& getHandler(QueryResource& qr) {
+        return *qr.getJobQuery()->getDescription().respHandler();
+    }
+    /// Mark the job of 'qr' completed. If JobQuery::cancel() has already
+    /// done it, MarkCompleteFunc ignores this call.
+    static void finish(QueryResource& qr, bool success=true) {
         LOGS_DEBUG("QueryResourceDebug::finish");
-        qr.getJobQuery()->getMarkCompleteFunc()->operator ()(true);
+        qr.getJobQuery()->getMarkCompleteFunc()->operator ()(success);
     }
 };
 
 util::FlagNotify<bool> XrdSsiServiceMock::_go(true);
 util::Sequential<int> XrdSsiServiceMock::_count(0);
+std::mutex XrdSsiServiceMock::_responderMtx;
+XrdSsiServiceMock::Responder XrdSsiServiceMock::_responder;
+
+void XrdSsiServiceMock::setResponder(Responder const& responder) {
+    std::lock_guard<std::mutex> lock(_responderMtx);
+    _responder = responder;
+}
+
+XrdSsiServiceMock::Responder XrdSsiServiceMock::_getResponder() {
+    std::lock_guard<std::mutex> lock(_responderMtx);
+    return _responder;
+}
 
 /** Class to fake being a request to xrootd.
  * Fire up thread that sleeps for a bit and then indicates it was successful.
@@ -104,6 +122,24 @@ void XrdSsiServiceMock::mockProvisionTest(QueryResource *qr,
         // call again due to possible race condition where Executive is already deleted.
         return;
     }
+    Responder responder = _getResponder();
+    if (responder) {
+        JobStatus::Ptr status = QueryResourceDebug::getStatus(*qr);
+        status->updateInfo(JobStatus::RESPONSE_DATA);
+        bool success = responder(payload, QueryResourceDebug::getHandler(*qr));
+        if (success) {
+            status->updateInfo(JobStatus::COMPLETE);
+        } else {
+            auto err = QueryResourceDebug::getHandler(*qr).getError();
+            status->updateInfo(JobStatus::MERGE_ERROR, err.getCode(), err.getMsg());
+        }
+        QueryResourceDebug::finish(*qr, success);
+        // As QueryResource::ProvisionDone() does, so that the JobQuery and
+        // its ResponseHandler are not kept alive by qr, which goes with it.
+        auto jobQuery = qr->getJobQuery();
+        jobQuery->freeQueryResource(qr);
+        return;
+    }
     LOGS(_log, LOG_LVL_DEBUG, "XrdSsiServiceMock::mockProvisionTest sleep begin");
     usleep(1000*millisecs);
     LOGS(_log, LOG_LVL_DEBUG, "XrdSsiServiceMock::mockProvisionTest sleep end");
@@ -27,6 +27,11 @@
 #define LSST_QSERV_QDISP_XRDSSIMOCKS_H
 
 
+// System headers
+#include <functional>
+#include <mutex>
+#include <string>
+
 // External headers
 #include "XrdSsi/XrdSsiService.hh"
 #include "XrdSsi/XrdSsiSession.hh"
@@ -42,23 +47,37 @@ namespace qserv {
 namespace qdisp {
 
 class Executive;
+class ResponseHandler;
 
 /** A greatly simplified version of XrdSsiService for testing the Executive class.
  */
 class XrdSsiServiceMock : public XrdSsiService
 {
 public:
+    /// A Responder produces the response of a job from its payload, with the
+    /// ResponseHandler::nextBuffer() and flush() calls QueryRequest makes.
+    /// It returns false if the job failed, after calling errorFlush().
+    typedef std::function<bool(std::string const& payload, ResponseHandler& handler)> Responder;
+
     virtual void Provision(Resource *resP, unsigned short timeOut=0, bool userConn=false);
     XrdSsiServiceMock(Executive *executive) {};
     void setGo(bool go) {
         _go.exchangeNotify(go);
     }
+    /// Respond to the jobs provisioned from now on with 'responder', instead
+    /// of sleeping for the number of milliseconds in their payload. An empty
+    /// Responder restores the sleep.
+    static void setResponder(Responder const& responder);
 protected:
     void mockProvisionTest(QueryResource *resP, unsigned short timeOut);
 public:
     virtual ~XrdSsiServiceMock() {}
     static util::FlagNotify<bool> _go;
     static util::Sequential<int> _count;
+private:
+    static Responder _getResponder();
+    static std::mutex _responderMtx;
+    static Responder _responder;
 };
 
 /** Class used to fake calls to XrdSsiSession::ProcessRequest.
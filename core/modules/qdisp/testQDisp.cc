@@ -256,6 +256,30 @@ BOOST_AUTO_TEST_CASE(Executive) {
     LOGS_DEBUG("Executive test end");
 }
 
+BOOST_AUTO_TEST_CASE(ExecutiveSuperfluous) {
+    LOGS_DEBUG("ExecutiveSuperfluous test start");
+    std::string str = qdisp::Executive::Config::getMockStr();
+    qdisp::Executive::Config::Ptr conf = std::make_shared<qdisp::Executive::Config>(str);
+    std::shared_ptr<qdisp::MessageStore> ms = std::make_shared<qdisp::MessageStore>();
+    qdisp::Executive ex(conf, ms);
+    SequentialInt sequence(0);
+    SequentialInt chunkId(1234);
+    int jobs = qdisp::XrdSsiServiceMock::_count.get() + 3;
+    qdisp::XrdSsiServiceMock::_go.exchangeNotify(false);
+    executiveTest(ex, sequence, chunkId, "0", 3);
+    while (qdisp::XrdSsiServiceMock::_count.get() < jobs) {
+        usleep(10000);
+    }
+    // The jobs failing because of the squash are not errors.
+    ex.squashSuperfluous();
+    BOOST_CHECK(ex.getSuperfluous());
+    ex.squash();
+    qdisp::XrdSsiServiceMock::_go.exchangeNotify(true);
+    BOOST_CHECK(ex.join());
+    BOOST_CHECK(ex.getCancelled());
+    LOGS_DEBUG("ExecutiveSuperfluous test end");
+}
+
 BOOST_AUTO_TEST_CASE(MessageStore) {
     LOGS_DEBUG("MessageStore test start");
     qdisp::MessageStore ms;
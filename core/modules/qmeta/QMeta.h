@@ -31,6 +31,7 @@
 
 // Qserv headers
 #include "qmeta/QInfo.h"
+#include "qmeta/QUsage.h"
 #include "qmeta/types.h"
 
 
@@ -263,6 +264,30 @@ public:
     virtual std::vector<QueryId> getQueriesForTable(std::string const& dbName,
                                                     std::string const& tableName) = 0;
 
+    /**
+     *  @brief Add resource usage of worker Tasks to the query usage.
+     *
+     *  Usage is accumulated, calling this method several times for the
+     *  same query adds up all values.
+     *
+     *  This method will throw if specified query ID does not exist. If the
+     *  usage table could not be created usage is silently not recorded.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     *  @param usage:     Usage to add.
+     */
+    virtual void addQueryUsage(QueryId queryId, QUsage const& usage) = 0;
+
+    /**
+     *  @brief Get resource usage of a query.
+     *
+     *  All values are zero if no usage was recorded for the query.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     *  @return: Usage of the query.
+     */
+    virtual QUsage getQueryUsage(QueryId queryId) = 0;
+
 protected:
 
     // Default constructor
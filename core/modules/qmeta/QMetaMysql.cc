@@ -729,6 +729,87 @@ QMetaMysql::getQueriesForTable(std::string const& dbName,
     return result;
 }
 
+// Add resource usage of worker Tasks to the query usage.
+void
+QMetaMysql::addQueryUsage(QueryId queryId, QUsage const& usage) {
+
+    if (not _haveUsage) {
+        LOGS(_log, LOG_LVL_DEBUG, "QUsage table is missing, usage of query " << queryId
+             << " not recorded");
+        return;
+    }
+
+    std::lock_guard<std::mutex> sync(_dbMutex);
+
+    QMetaTransaction trans(_conn);
+
+    // insert new row or add to existing one
+    std::string query = "INSERT INTO QUsage (queryId, tasks, cpuUs, chunkBytes, memLockWaitUs,"
+            " rowsExamined, rowsReturned, bytesSent) VALUES (";
+    query += boost::lexical_cast<std::string>(queryId);
+    for (auto value: {usage.tasks, usage.cpuUs, usage.chunkBytes, usage.memLockWaitUs,
+                      usage.rowsExamined, usage.rowsReturned, usage.bytesSent}) {
+        query += ", ";
+        query += boost::lexical_cast<std::string>(value);
+    }
+    query += ") ON DUPLICATE KEY UPDATE tasks = tasks + VALUES(tasks), cpuUs = cpuUs + VALUES(cpuUs),"
+            " chunkBytes = chunkBytes + VALUES(chunkBytes),"
+            " memLockWaitUs = memLockWaitUs + VALUES(memLockWaitUs),"
+            " rowsExamined = rowsExamined + VALUES(rowsExamined),"
+            " rowsReturned = rowsReturned + VALUES(rowsReturned),"
+            " bytesSent = bytesSent + VALUES(bytesSent)";
+
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    sql::SqlErrorObject errObj;
+    if (not _conn.runQuery(query, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    trans.commit();
+}
+
+// Get resource usage of a query.
+QUsage
+QMetaMysql::getQueryUsage(QueryId queryId) {
+
+    if (not _haveUsage) return QUsage();
+
+    std::lock_guard<std::mutex> sync(_dbMutex);
+
+    QMetaTransaction trans(_conn);
+
+    // run query
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    std::string query = "SELECT tasks, cpuUs, chunkBytes, memLockWaitUs, rowsExamined, rowsReturned,"
+            " bytesSent FROM QUsage WHERE queryId = ";
+    query += boost::lexical_cast<std::string>(queryId);
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    if (not _conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    QUsage usage;
+    sql::SqlResults::iterator rowIter = results.begin();
+    if (rowIter != results.end()) {
+        // make sure that iterator does not move until we are done with row
+        sql::SqlResults::value_type const& row = *rowIter;
+        usage.tasks = boost::lexical_cast<std::uint64_t>(row[0].first);
+        usage.cpuUs = boost::lexical_cast<std::uint64_t>(row[1].first);
+        usage.chunkBytes = boost::lexical_cast<std::uint64_t>(row[2].first);
+        usage.memLockWaitUs = boost::lexical_cast<std::uint64_t>(row[3].first);
+        usage.rowsExamined = boost::lexical_cast<std::uint64_t>(row[4].first);
+        usage.rowsReturned = boost::lexical_cast<std::uint64_t>(row[5].first);
+        usage.bytesSent = boost::lexical_cast<std::uint64_t>(row[6].first);
+    }
+
+    trans.commit();
+
+    return usage;
+}
+
 // Check that all necessary tables exist or create them
 void
 QMetaMysql::_checkDb() {
@@ -754,6 +835,29 @@ QMetaMysql::_checkDb() {
             throw MissingTableError(ERR_LOC, table);
         }
     }
+
+    // QUsage was added after the other tables, create it in databases which
+    // predate it. Usage is optional, if it cannot be created it is not stored.
+    if (std::find(tables.begin(), tables.end(), "QUsage") == tables.end()) {
+        std::string const query = "CREATE TABLE IF NOT EXISTS QUsage ("
+            "queryId BIGINT NOT NULL, tasks INT NOT NULL DEFAULT 0,"
+            " cpuUs BIGINT UNSIGNED NOT NULL DEFAULT 0,"
+            " chunkBytes BIGINT UNSIGNED NOT NULL DEFAULT 0,"
+            " memLockWaitUs BIGINT UNSIGNED NOT NULL DEFAULT 0,"
+            " rowsExamined BIGINT UNSIGNED NOT NULL DEFAULT 0,"
+            " rowsReturned BIGINT UNSIGNED NOT NULL DEFAULT 0,"
+            " bytesSent BIGINT UNSIGNED NOT NULL DEFAULT 0,"
+            " PRIMARY KEY (queryId),"
+            " CONSTRAINT QUsage_qid FOREIGN KEY (queryId) REFERENCES QInfo (queryId)"
+            " ON DELETE CASCADE ON UPDATE CASCADE)"
+            " ENGINE = InnoDB COMMENT = 'Resources used by worker tasks of a query'";
+        LOGS(_log, LOG_LVL_INFO, "Creating query metadata table QUsage");
+        if (not _conn.runQuery(query, errObj)) {
+            LOGS(_log, LOG_LVL_WARN, "Failed to create table QUsage, query usage will not be"
+                 " recorded: " << errObj.errMsg());
+            _haveUsage = false;
+        }
+    }
 }
 
 }}} // namespace lsst::qserv::qmeta
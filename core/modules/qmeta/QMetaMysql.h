@@ -239,6 +239,29 @@ public:
     virtual std::vector<QueryId> getQueriesForTable(std::string const& dbName,
                                                     std::string const& tableName) override;
 
+    /**
+     *  @brief Add resource usage of worker Tasks to the query usage.
+     *
+     *  Usage is accumulated, calling this method several times for the
+     *  same query adds up all values.
+     *
+     *  This method will throw if specified query ID does not exist.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     *  @param usage:     Usage to add.
+     */
+    virtual void addQueryUsage(QueryId queryId, QUsage const& usage) override;
+
+    /**
+     *  @brief Get resource usage of a query.
+     *
+     *  All values are zero if no usage was recorded for the query.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     *  @return: Usage of the query.
+     */
+    virtual QUsage getQueryUsage(QueryId queryId) override;
+
 protected:
 
     ///  Check that all necessary tables exist
@@ -248,6 +271,7 @@ private:
 
     sql::SqlConnection _conn;
     std::mutex _dbMutex;    ///< Synchronizes access to certain DB operations
+    bool _haveUsage = true; ///< False if QUsage table is missing, set by _checkDb()
 
 };
 
@@ -0,0 +1,72 @@
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QMETA_QUSAGE_H
+#define LSST_QSERV_QMETA_QUSAGE_H
+
+// System headers
+#include <cstdint>
+
+namespace lsst {
+namespace qserv {
+namespace qmeta {
+
+/// @addtogroup qmeta
+
+/**
+ *  @ingroup qmeta
+ *
+ *  @brief Resources used by the worker Tasks of a query.
+ *
+ *  Each worker reports the usage of a Task with its last result message,
+ *  the czar adds them up for the query and stores the sum in QMeta.
+ *
+ *  chunkBytes is reported by every Task which had the chunk tables locked,
+ *  so Tasks sharing a scan of the same chunk each count the same bytes; it
+ *  measures memory held over the tasks rather than distinct bytes read.
+ *  rowsExamined is only sampled for traced queries as it needs two extra
+ *  round trips to mysqld per Task; it is zero for other queries.
+ */
+
+struct QUsage {
+    std::uint64_t tasks = 0;          ///< Number of Tasks which reported usage
+    std::uint64_t cpuUs = 0;          ///< CPU time of the worker threads, microseconds
+    std::uint64_t chunkBytes = 0;     ///< Bytes of chunk tables locked in memory
+    std::uint64_t memLockWaitUs = 0;  ///< Time waiting for the memory lock, microseconds
+    std::uint64_t rowsExamined = 0;   ///< Rows read by mysqld
+    std::uint64_t rowsReturned = 0;   ///< Rows in the results
+    std::uint64_t bytesSent = 0;      ///< Bytes of result messages sent to czar
+
+    QUsage& operator+=(QUsage const& other) {
+        tasks += other.tasks;
+        cpuUs += other.cpuUs;
+        chunkBytes += other.chunkBytes;
+        memLockWaitUs += other.memLockWaitUs;
+        rowsExamined += other.rowsExamined;
+        rowsReturned += other.rowsReturned;
+        bytesSent += other.bytesSent;
+        return *this;
+    }
+};
+
+}}} // namespace lsst::qserv::qmeta
+
+#endif // LSST_QSERV_QMETA_QUSAGE_H
@@ -12,6 +12,7 @@ Access to the qmeta classes
 #include "qmeta/Exceptions.h"
 #include "qmeta/QInfo.h"
 #include "qmeta/QMeta.h"
+#include "qmeta/QUsage.h"
 #include "qmeta/types.h"
 %}
 
@@ -87,4 +88,5 @@ class ConsistencyError(Exception):
 %include "qmeta/types.h"
 %template(QueryIdList) std::vector<lsst::qserv::qmeta::QueryId>;
 %include "qmeta/QInfo.h"
+%include "qmeta/QUsage.h"
 %include "qmeta/QMeta.h"
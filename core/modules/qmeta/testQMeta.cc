@@ -369,4 +369,44 @@ BOOST_AUTO_TEST_CASE(messWithChunks) {
     BOOST_CHECK_THROW(qMeta->finishChunk(qid1, 42), ChunkIdError);
 }
 
+BOOST_AUTO_TEST_CASE(messWithUsage) {
+
+    CzarId cid1 = qMeta->getCzarID("czar:1000");
+    BOOST_CHECK(cid1 != 0U);
+
+    QInfo qinfo(QInfo::SYNC, cid1, "user1", "SELECT * from Object", "SELECT * from Object_{}", "", "");
+    QMeta::TableNames tables;
+    tables.push_back(std::make_pair("TestDB", "Object"));
+    QueryId qid1 = qMeta->registerQuery(qinfo, tables);
+    BOOST_CHECK(qid1 != 0U);
+
+    // nothing recorded yet
+    QUsage usage = qMeta->getQueryUsage(qid1);
+    BOOST_CHECK_EQUAL(usage.tasks, 0U);
+    BOOST_CHECK_EQUAL(usage.cpuUs, 0U);
+
+    QUsage task;
+    task.tasks = 1;
+    task.cpuUs = 1500;
+    task.chunkBytes = 1000000;
+    task.memLockWaitUs = 20;
+    task.rowsExamined = 300;
+    task.rowsReturned = 10;
+    task.bytesSent = 4096;
+    qMeta->addQueryUsage(qid1, task);
+    qMeta->addQueryUsage(qid1, task);
+
+    usage = qMeta->getQueryUsage(qid1);
+    BOOST_CHECK_EQUAL(usage.tasks, 2U);
+    BOOST_CHECK_EQUAL(usage.cpuUs, 3000U);
+    BOOST_CHECK_EQUAL(usage.chunkBytes, 2000000U);
+    BOOST_CHECK_EQUAL(usage.memLockWaitUs, 40U);
+    BOOST_CHECK_EQUAL(usage.rowsExamined, 600U);
+    BOOST_CHECK_EQUAL(usage.rowsReturned, 20U);
+    BOOST_CHECK_EQUAL(usage.bytesSent, 8192U);
+
+    // unknown query
+    BOOST_CHECK_THROW(qMeta->addQueryUsage(99999, task), SqlError);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -92,6 +92,10 @@ void QuerySession::setDefaultDb(std::string const& defaultDb) {
 void QuerySession::analyzeQuery(std::string const& sql) {
     _original = sql;
     _isFinal = false;
+    // The query:: objects of the analysis are allocated together, and
+    // released together, rather than one by one from the heap.
+    _arena = util::Arena::create();
+    util::Arena::Scope arenaScope(_arena);
     _initContext();
     assert(_context.get());
 
@@ -129,6 +133,10 @@ void QuerySession::analyzeQuery(std::string const& sql) {
     }
 }
 
+util::Arena::Stats QuerySession::getArenaStats() const {
+    return _arena ? _arena->getStats() : util::Arena::Stats();
+}
+
 bool QuerySession::needsMerge() const {
     // Aggregate: having an aggregate fct spec in the select list.
     // Stmt itself knows whether aggregation is present. More
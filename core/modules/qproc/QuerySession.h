@@ -47,6 +47,7 @@
 #include "qproc/ChunkSpec.h"
 #include "query/Constraint.h"
 #include "query/typedefs.h"
+#include "util/Arena.h"
 
 
 // Forward declarations
@@ -121,6 +122,9 @@ public:
     std::shared_ptr<IntSet const> getEmptyChunks();
     std::string const& getError() const { return _error; }
 
+    /// @return the allocations of the query:: objects built by analyzeQuery().
+    util::Arena::Stats getArenaStats() const;
+
     std::shared_ptr<query::SelectStmt> getMergeStmt() const;
 
     /// Finalize a query after chunk coverage has been updated
@@ -206,6 +210,10 @@ private:
     ChunkSpecVector _chunks; ///< Chunk coverage
     std::shared_ptr<QueryPluginPtrVector> _plugins; ///< Analysis plugin chain
 
+    /// Arena of the query:: objects built by analyzeQuery(). Each of them
+    /// keeps it alive, so it is released with the last of them.
+    util::Arena::Ptr _arena;
+
 };
 
 /**
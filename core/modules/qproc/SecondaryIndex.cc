@@ -213,13 +213,16 @@ class FakeBackend : public SecondaryIndex::Backend {
 public:
     FakeBackend() {}
     virtual ChunkSpecVector lookup(query::ConstraintVector const& cv) {
+        // As MySqlBackend, so that IndexMap falls back to the spatial
+        // constraints, or to all chunks, for queries without index constraint.
+        if (!_hasSecondary(cv)) {
+            throw SecondaryIndex::NoIndexConstraint();
+        }
         ChunkSpecVector dummy;
-        if (_hasSecondary(cv)) {
-            for(int i=100; i < 103; ++i) {
-                int bogus[] = {1,2,3};
-                std::vector<int> subChunks(bogus, bogus+3);
-                dummy.push_back(ChunkSpec(i, subChunks));
-            }
+        for(int i=100; i < 103; ++i) {
+            int bogus[] = {1,2,3};
+            std::vector<int> subChunks(bogus, bogus+3);
+            dummy.push_back(ChunkSpec(i, subChunks));
         }
         return dummy;
     }
@@ -66,6 +66,8 @@ public:
     std::shared_ptr<proto::TaskMsg> makeMsg(ChunkQuerySpec const& s,
                                             std::string const& chunkResultName,
                                             uint64_t queryId, int jobId);
+    std::int64_t interactiveDeadline{0};
+    bool trace{false};
 private:
     template <class C1, class C2, class C3>
     void addFragment(proto::TaskMsg& m, std::string const& resultName,
@@ -109,6 +111,9 @@ TaskMsgFactory::Impl::makeMsg(ChunkQuerySpec const& s,
     _taskMsg->set_protocol(2);
     _taskMsg->set_queryid(queryId);
     _taskMsg->set_jobid(jobId);
+    if (trace) {
+        _taskMsg->set_trace(true);
+    }
     // scanTables (for shared scans)
     // check if more than 1 db in scanInfo
     std::string db;
@@ -126,6 +131,14 @@ TaskMsgFactory::Impl::makeMsg(ChunkQuerySpec const& s,
     }
 
     _taskMsg->set_scanpriority(s.scanInfo.scanRating);
+    if (s.scanInfo.infoTables.empty()) {
+        _taskMsg->set_priorityclass(proto::TaskMsg::INTERACTIVE);
+        if (interactiveDeadline > 0) {
+            _taskMsg->set_deadlinebudget(interactiveDeadline);
+        }
+    } else {
+        _taskMsg->set_priorityclass(proto::TaskMsg::SCAN);
+    }
 
     // per-chunk
     _taskMsg->set_chunkid(s.chunkId);
@@ -165,6 +178,14 @@ TaskMsgFactory::TaskMsgFactory(uint64_t session)
     : _impl(std::make_shared<Impl>(session, "Asdfasfd" )) {
 }
 
+void TaskMsgFactory::setInteractiveDeadline(std::int64_t budgetMs) {
+    _impl->interactiveDeadline = budgetMs;
+}
+
+void TaskMsgFactory::setTrace(bool trace) {
+    _impl->trace = trace;
+}
+
 void TaskMsgFactory::serializeMsg(ChunkQuerySpec const& s,
                                   std::string const& chunkResultName,
                                   uint64_t queryId, int jobId,
@@ -173,4 +194,16 @@ void TaskMsgFactory::serializeMsg(ChunkQuerySpec const& s,
     m->SerializeToOstream(&os);
 }
 
+bool TaskMsgFactory::resetDeadlineBudget(std::string& msg, std::int64_t budgetMs) {
+    proto::TaskMsg taskMsg;
+    if (!taskMsg.ParseFromString(msg)) {
+        return false;
+    }
+    if (taskMsg.has_deadlinebudget()) {
+        taskMsg.set_deadlinebudget(budgetMs);
+        taskMsg.SerializeToString(&msg);
+    }
+    return true;
+}
+
 }}} // namespace lsst::qserv::qproc
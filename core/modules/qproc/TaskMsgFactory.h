@@ -32,8 +32,10 @@
   */
 
 // System headers
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <string>
 
 namespace lsst {
 namespace qserv {
@@ -46,6 +48,19 @@ class TaskMsgFactory {
 public:
     TaskMsgFactory(uint64_t session);
 
+    /// Set the time within which workers should start tasks that do not
+    /// need a shared scan, in milliseconds after they receive them.
+    /// 0 for no deadline.
+    void setInteractiveDeadline(std::int64_t budgetMs);
+
+    /// Replace the deadline budget of the serialized TaskMsg 'msg', if it
+    /// has one, for a task serialized well before it is dispatched.
+    /// @return false if 'msg' could not be parsed, it is then unchanged.
+    static bool resetDeadlineBudget(std::string& msg, std::int64_t budgetMs);
+
+    /// Ask workers to send back the timed steps of the tasks.
+    void setTrace(bool trace);
+
     /// Construct a TaskMsg and serialize it to a stream
     void serializeMsg(ChunkQuerySpec const& s,
                       std::string const& chunkResultName,
@@ -113,7 +113,7 @@ BOOST_AUTO_TEST_CASE(SecLookupMultipleObjectIdBETWEEN) {
     ConstraintVector cv;
     int const size=5;
     char const* argv[size] = {"LSST", "Object", "objectId", "386942193651348", "386950783579546"};
-    cv.push_back(makeConstraint("sIndexBetWeen", size, argv));
+    cv.push_back(makeConstraint("sIndexBetween", size, argv));
 
     ChunkSpecVector csv = si.lookup(cv);
     std::cout << "SecLookupMultipleObjectIdBETWEEN\n";
@@ -121,6 +121,15 @@ BOOST_AUTO_TEST_CASE(SecLookupMultipleObjectIdBETWEEN) {
               std::ostream_iterator<ChunkSpec>(std::cout, ",\n"));
 }
 
+BOOST_AUTO_TEST_CASE(SecLookupNoIndex) {
+    ConstraintVector cv;
+    int const size = 4;
+    char const* argv[size] = {"0", "0", "1", "1"};
+    cv.push_back(makeConstraint("qserv_areaspec_box", size, argv));
+
+    BOOST_CHECK_THROW(si.lookup(cv), SecondaryIndex::NoIndexConstraint);
+}
+
 #if 0 // TODO
 BOOST_AUTO_TEST_CASE(IndLookupArea) {
     // Lookup area using IndexMap interface
@@ -45,6 +45,7 @@
 #include "query/Predicate.h"
 #include "query/QueryTemplate.h"
 #include "query/ValueExpr.h"
+#include "util/Arena.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.query.BoolTerm");
@@ -187,7 +188,7 @@ bool BoolFactor::_reduceTerms(BoolFactorTerm::PtrVector& newTerms,
                     } else {
                         // still a reduction in the term, replace
                         std::shared_ptr<BoolTermFactor> newBtf;
-                        newBtf = std::make_shared<BoolTermFactor>();
+                        newBtf = util::makeShared<BoolTermFactor>();
                         newBtf->_term = reduced;
                         newTerms.push_back(newBtf);
                         hasReduction = true;
@@ -231,14 +232,14 @@ std::shared_ptr<BoolTerm> BoolFactor::getReduced() {
         hasReduction = true;
     }
     if (hasReduction) {
-        BoolFactor* bf = new BoolFactor();
-        bf->_terms = newTerms;
+        std::shared_ptr<BoolFactor> bf = util::makeShared<BoolFactor>();
+        bf->_terms.swap(newTerms);
 #if 0
         QueryTemplate qt;
         bf->renderTo(qt);
         LOGS(_log, LOG_LVL_DEBUG, "reduced. " << qt.generate());
 #endif
-        return std::shared_ptr<BoolFactor>(bf);
+        return bf;
     } else {
         return std::shared_ptr<BoolTerm>();
     }
@@ -265,68 +266,69 @@ namespace {
 
     template <typename List, class Copy>
     inline void copyTerms(List& dest, List const& src) {
+        dest.reserve(dest.size() + src.size());
         std::transform(src.begin(), src.end(), std::back_inserter(dest), Copy());
     }
 } // anonymous namespace
 
 std::shared_ptr<BoolTerm> OrTerm::clone() const {
-    std::shared_ptr<OrTerm> ot = std::make_shared<OrTerm>();
+    std::shared_ptr<OrTerm> ot = util::makeShared<OrTerm>();
     copyTerms<BoolTerm::PtrVector, deepCopy>(ot->_terms, _terms);
     return ot;
 }
 std::shared_ptr<BoolTerm> AndTerm::clone() const {
-    std::shared_ptr<AndTerm> t = std::make_shared<AndTerm>();
+    std::shared_ptr<AndTerm> t = util::makeShared<AndTerm>();
     copyTerms<BoolTerm::PtrVector, deepCopy>(t->_terms, _terms);
     return t;
 }
 std::shared_ptr<BoolTerm> BoolFactor::clone() const {
-    std::shared_ptr<BoolFactor> t = std::make_shared<BoolFactor>();
+    std::shared_ptr<BoolFactor> t = util::makeShared<BoolFactor>();
     copyTerms<BoolFactorTerm::PtrVector, deepCopy>(t->_terms, _terms);
     return t;
 }
 std::shared_ptr<BoolTerm> UnknownTerm::clone() const {
-    return  std::make_shared<UnknownTerm>(); // TODO what is unknown now?
+    return  util::makeShared<UnknownTerm>(); // TODO what is unknown now?
 }
 BoolFactorTerm::Ptr PassListTerm::clone() const {
-    PassListTerm* p = new PassListTerm;
-    std::copy(_terms.begin(), _terms.end(), std::back_inserter(p->_terms));
-    return BoolFactorTerm::Ptr(p);
+    std::shared_ptr<PassListTerm> p = util::makeShared<PassListTerm>();
+    p->_terms = _terms;
+    return p;
 }
 BoolFactorTerm::Ptr BoolTermFactor::clone() const {
-    BoolTermFactor* p = new BoolTermFactor;
+    std::shared_ptr<BoolTermFactor> p = util::makeShared<BoolTermFactor>();
     if (_term) { p->_term = _term->clone(); }
-    return BoolFactorTerm::Ptr(p);
+    return p;
 }
 // copySyntax
 std::shared_ptr<BoolTerm> OrTerm::copySyntax() const {
-    std::shared_ptr<OrTerm> ot = std::make_shared<OrTerm>();
+    std::shared_ptr<OrTerm> ot = util::makeShared<OrTerm>();
     copyTerms<BoolTerm::PtrVector, syntaxCopy>(ot->_terms, _terms);
     return ot;
 }
 std::shared_ptr<BoolTerm> AndTerm::copySyntax() const {
-    std::shared_ptr<AndTerm> at = std::make_shared<AndTerm>();
+    std::shared_ptr<AndTerm> at = util::makeShared<AndTerm>();
     copyTerms<BoolTerm::PtrVector, syntaxCopy>(at->_terms, _terms);
     return at;
 }
 std::shared_ptr<BoolTerm> BoolFactor::copySyntax() const {
-    std::shared_ptr<BoolFactor> bf = std::make_shared<BoolFactor>();
+    std::shared_ptr<BoolFactor> bf = util::makeShared<BoolFactor>();
     copyTerms<BoolFactorTerm::PtrVector, syntaxCopy>(bf->_terms, _terms);
     return bf;
 }
 BoolFactorTerm::Ptr PassTerm::copySyntax() const {
-    PassTerm* p = new PassTerm;
+    std::shared_ptr<PassTerm> p = util::makeShared<PassTerm>();
     p->_text = _text;
-    return BoolFactorTerm::Ptr(p);
+    return p;
 }
 BoolFactorTerm::Ptr PassListTerm::copySyntax() const {
-    PassListTerm* p = new PassListTerm;
+    std::shared_ptr<PassListTerm> p = util::makeShared<PassListTerm>();
     p->_terms = _terms;
-    return BoolFactorTerm::Ptr(p);
+    return p;
 }
 BoolFactorTerm::Ptr BoolTermFactor::copySyntax() const {
-    BoolTermFactor* p = new BoolTermFactor;
+    std::shared_ptr<BoolTermFactor> p = util::makeShared<BoolTermFactor>();
     if (_term) { p->_term = _term->copySyntax(); }
-    return BoolFactorTerm::Ptr(p);
+    return p;
 }
 
 }}} // namespace lsst::qserv::query
@@ -43,6 +43,7 @@
 #include "query/QueryTemplate.h"
 #include "query/ValueExpr.h"
 #include "query/ValueFactor.h"
+#include "util/Arena.h"
 
 namespace lsst {
 namespace qserv {
@@ -50,7 +51,7 @@ namespace query {
 
 FuncExpr::Ptr
 FuncExpr::newLike(FuncExpr const& src, std::string const& newName) {
-    FuncExpr::Ptr e = std::make_shared<FuncExpr>();
+    FuncExpr::Ptr e = util::makeShared<FuncExpr>();
     e->name = newName;
     e->params = src.params; // Shallow list copy.
     return e;
@@ -58,14 +59,14 @@ FuncExpr::newLike(FuncExpr const& src, std::string const& newName) {
 
 FuncExpr::Ptr
 FuncExpr::newArg1(std::string const& newName, std::string const& arg1) {
-    std::shared_ptr<ColumnRef> cr = std::make_shared<ColumnRef>("","",arg1);
+    std::shared_ptr<ColumnRef> cr = util::makeShared<ColumnRef>("","",arg1);
     return newArg1(newName,
                    ValueExpr::newSimple(ValueFactor::newColumnRefFactor(cr)));
 }
 
 FuncExpr::Ptr
 FuncExpr::newArg1(std::string const& newName, ValueExprPtr ve) {
-    FuncExpr::Ptr e = std::make_shared<FuncExpr>();
+    FuncExpr::Ptr e = util::makeShared<FuncExpr>();
     e->name = newName;
     e->params.push_back(ve);
     return e;
@@ -83,7 +84,7 @@ FuncExpr::findColumnRefs(ColumnRef::Vector& outputRefs) {
 
 std::shared_ptr<FuncExpr>
 FuncExpr::clone() const {
-    FuncExpr::Ptr e = std::make_shared<FuncExpr>();
+    FuncExpr::Ptr e = util::makeShared<FuncExpr>();
     e->name = name;
     cloneValueExprPtrVector(e->params, params);
     return e;
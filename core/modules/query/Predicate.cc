@@ -39,6 +39,7 @@
 #include "query/QueryTemplate.h"
 #include "query/SqlSQL2Tokens.h" // (generated) SqlSQL2Tokens
 #include "query/ValueExpr.h"
+#include "util/Arena.h"
 
 
 namespace lsst {
@@ -183,11 +184,11 @@ int CompPredicate::lookupOp(char const* op) {
 }
 
 BoolFactorTerm::Ptr CompPredicate::clone() const {
-    CompPredicate* p = new CompPredicate;
+    CompPredicate::Ptr p = util::makeShared<CompPredicate>();
     if (left) p->left = left->clone();
     p->op = op;
     if (right) p->right = right->clone();
-    return BoolFactorTerm::Ptr(p);
+    return p;
 }
 
 BoolFactorTerm::Ptr GenericPredicate::clone() const {
@@ -204,8 +205,9 @@ namespace {
 }
 
 BoolFactorTerm::Ptr InPredicate::clone() const {
-    InPredicate::Ptr p  = std::make_shared<InPredicate>();
+    InPredicate::Ptr p  = util::makeShared<InPredicate>();
     if (value) p->value = value->clone();
+    p->cands.reserve(cands.size());
     std::transform(cands.begin(), cands.end(),
                    std::back_inserter(p->cands),
                    valueExprCopy());
@@ -213,7 +215,7 @@ BoolFactorTerm::Ptr InPredicate::clone() const {
 }
 
 BoolFactorTerm::Ptr BetweenPredicate::clone() const {
-    BetweenPredicate::Ptr p = std::make_shared<BetweenPredicate>();
+    BetweenPredicate::Ptr p = util::makeShared<BetweenPredicate>();
     if (value) p->value = value->clone();
     if (minValue) p->minValue = minValue->clone();
     if (maxValue) p->maxValue = maxValue->clone();
@@ -221,14 +223,14 @@ BoolFactorTerm::Ptr BetweenPredicate::clone() const {
 }
 
 BoolFactorTerm::Ptr LikePredicate::clone() const {
-    LikePredicate::Ptr p = std::make_shared<LikePredicate>();
+    LikePredicate::Ptr p = util::makeShared<LikePredicate>();
     if (value) p->value = value->clone();
     if (charValue) p->charValue = charValue->clone();
     return BoolFactorTerm::Ptr(p);
 }
 
 BoolFactorTerm::Ptr NullPredicate::clone() const {
-    NullPredicate::Ptr p = std::make_shared<NullPredicate>();
+    NullPredicate::Ptr p = util::makeShared<NullPredicate>();
     if (value) p->value = value->clone();
     p->hasNot = hasNot;
     return BoolFactorTerm::Ptr(p);
@@ -35,6 +35,7 @@
 #include "query/QueryTemplate.h"
 
 // System headers
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -47,6 +48,7 @@
 #include "global/sqltoken.h" // sqlShouldSeparate
 #include "query/ColumnRef.h"
 #include "query/TableRef.h"
+#include "util/Arena.h"
 
 namespace {
 
@@ -57,7 +59,7 @@ struct SpacedOutput {
     SpacedOutput(std::ostream& os_, std::string sep_=" ")
         : os(os_), sep(sep_) {}
 
-    void operator()(std::shared_ptr<lsst::qserv::query::QueryTemplate::Entry> entry) {
+    void operator()(std::shared_ptr<lsst::qserv::query::QueryTemplate::Entry> const& entry) {
         if (!entry) {
             throw std::invalid_argument("NULL QueryTemplate::Entry");
         }
@@ -87,17 +89,6 @@ namespace lsst {
 namespace qserv {
 namespace query {
 
-struct MappingWrapper {
-    MappingWrapper(QueryTemplate::EntryMapping const& em_,
-                   QueryTemplate& qt_)
-        : em(em_), qt(qt_) {}
-    void operator()(std::shared_ptr<QueryTemplate::Entry> e) {
-        qt.append(em.mapEntry(*e));
-    }
-    QueryTemplate::EntryMapping const& em;
-    QueryTemplate& qt;
-};
-
 ////////////////////////////////////////////////////////////////////////
 // QueryTemplate::Entry subclasses
 ////////////////////////////////////////////////////////////////////////
@@ -148,20 +139,17 @@ std::ostream& operator<<(std::ostream& os, QueryTemplate const& queryTemplate) {
 
 void
 QueryTemplate::append(std::string const& s) {
-    std::shared_ptr<Entry> e = std::make_shared<StringEntry>(s);
-    _entries.push_back(e);
+    _entries.push_back(util::makeShared<StringEntry>(s));
 }
 
 void
 QueryTemplate::append(ColumnRef const& cr) {
-    std::shared_ptr<Entry> e = std::make_shared<ColumnEntry>(cr);
-    _entries.push_back(e);
+    _entries.push_back(util::makeShared<ColumnEntry>(cr));
 }
 
 void
 QueryTemplate::append(TableEntry const& te) {
-    std::shared_ptr<Entry> e = std::make_shared<TableEntry>(te);
-    _entries.push_back(e);
+    _entries.push_back(util::makeShared<TableEntry>(te));
 }
 
 void
@@ -171,9 +159,14 @@ QueryTemplate::append(std::shared_ptr<QueryTemplate::Entry> const& e) {
 
 std::string
 QueryTemplate::generate(EntryMapping const& em) const {
-    QueryTemplate newQt;
-    std::for_each(_entries.begin(), _entries.end(), MappingWrapper(em, newQt));
-    return newQt.sqlFragment();
+    // Render the mapped entries as they come, rather than through a
+    // mapped QueryTemplate, as this runs for every chunk of a query.
+    std::ostringstream oss;
+    SpacedOutput so(oss);
+    for (auto const& entry : _entries) {
+        so(em.mapEntry(*entry));
+    }
+    return oss.str();
 }
 
 void
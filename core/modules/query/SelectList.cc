@@ -58,6 +58,7 @@
 #include "query/QueryTemplate.h"
 #include "query/typedefs.h"
 #include "query/ValueFactor.h"
+#include "util/Arena.h"
 
 namespace lsst {
 namespace qserv {
@@ -122,17 +123,17 @@ SelectList::renderTo(QueryTemplate& qt) const {
 
 }
 std::shared_ptr<SelectList> SelectList::clone() const {
-    std::shared_ptr<SelectList> newS = std::make_shared<SelectList>(*this);
-    newS->_valueExprList = std::make_shared<ValueExprPtrVector>();
+    std::shared_ptr<SelectList> newS = util::makeShared<SelectList>(*this);
+    newS->_valueExprList = util::makeShared<ValueExprPtrVector>();
     cloneValueExprPtrVector(*(newS->_valueExprList), *_valueExprList);
     // For the other fields, default-copied versions are okay.
     return newS;
 }
 
 std::shared_ptr<SelectList> SelectList::copySyntax() {
-    std::shared_ptr<SelectList> newS = std::make_shared<SelectList>(*this);
+    std::shared_ptr<SelectList> newS = util::makeShared<SelectList>(*this);
     // Shallow copy of expr list is okay.
-    newS->_valueExprList = std::make_shared<ValueExprPtrVector>(*_valueExprList);
+    newS->_valueExprList = util::makeShared<ValueExprPtrVector>(*_valueExprList);
     // For the other fields, default-copied versions are okay.
     return newS;
 }
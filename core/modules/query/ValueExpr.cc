@@ -49,6 +49,7 @@
 #include "query/FuncExpr.h"
 #include "query/QueryTemplate.h"
 #include "query/ValueFactor.h"
+#include "util/Arena.h"
 
 namespace lsst {
 namespace qserv {
@@ -92,7 +93,7 @@ ValueExprPtr ValueExpr::newSimple(std::shared_ptr<ValueFactor> vt)  {
     if (!vt) {
         throw std::invalid_argument("Unexpected NULL ValueFactor");
     }
-    std::shared_ptr<ValueExpr> ve = std::make_shared<ValueExpr>();
+    std::shared_ptr<ValueExpr> ve = util::makeShared<ValueExpr>();
     FactorOp t(vt, NONE);
     ve->_factorOps.push_back(t);
     return ve;
@@ -136,7 +137,7 @@ std::shared_ptr<ColumnRef> ValueExpr::copyAsColumnRef() const {
     assert(factor);
     cr = factor->getColumnRef();
     if (cr) {
-        cr = std::make_shared<ColumnRef>(*cr);  // Make a copy
+        cr = util::makeShared<ColumnRef>(*cr);  // Make a copy
     }
     return cr;
 }
@@ -240,7 +241,7 @@ bool ValueExpr::isColumnRef() const {
 
 ValueExprPtr ValueExpr::clone() const {
     // First, make a shallow copy
-    ValueExprPtr expr = std::make_shared<ValueExpr>(*this);
+    ValueExprPtr expr = util::makeShared<ValueExpr>(*this);
     FactorOpVector::iterator ti = expr->_factorOps.begin();
     for(FactorOpVector::const_iterator i=_factorOps.begin();
         i != _factorOps.end(); ++i, ++ti) {
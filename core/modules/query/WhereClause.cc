@@ -44,6 +44,7 @@
 #include "global/Bug.h"
 #include "query/Predicate.h"
 #include "query/QueryTemplate.h"
+#include "util/Arena.h"
 
 namespace {
 
@@ -101,7 +102,7 @@ void findColumnRefs(std::shared_ptr<BoolTerm> t, ColumnRef::Vector& vector) {
 
 std::shared_ptr<ColumnRef::Vector const>
 WhereClause::getColumnRefs() const {
-    std::shared_ptr<ColumnRef::Vector> vector = std::make_shared<ColumnRef::Vector>();
+    std::shared_ptr<ColumnRef::Vector> vector = util::makeShared<ColumnRef::Vector>();
 
     // Idea: Walk the expression tree and add all column refs to the
     // list. We will walk in depth-first order, but the interface spec
@@ -143,13 +144,13 @@ void WhereClause::renderTo(QueryTemplate& qt) const {
 
 std::shared_ptr<WhereClause> WhereClause::clone() const {
     // FIXME
-    std::shared_ptr<WhereClause> newC = std::make_shared<WhereClause>(*this);
+    std::shared_ptr<WhereClause> newC = util::makeShared<WhereClause>(*this);
     // Shallow copy of expr list is okay.
     if (_tree.get()) {
         newC->_tree = _tree->copySyntax();
     }
     if (_restrs.get()) {
-        newC->_restrs = std::make_shared<QsRestrictor::PtrVector>(*_restrs);
+        newC->_restrs = util::makeShared<QsRestrictor::PtrVector>(*_restrs);
     }
     // For the other fields, default-copied versions are okay.
     return newC;
@@ -157,7 +158,7 @@ std::shared_ptr<WhereClause> WhereClause::clone() const {
 }
 
 std::shared_ptr<WhereClause> WhereClause::copySyntax() {
-    std::shared_ptr<WhereClause> newC = std::make_shared<WhereClause>(*this);
+    std::shared_ptr<WhereClause> newC = util::makeShared<WhereClause>(*this);
     // Shallow copy of expr list is okay.
     if (_tree.get()) {
         newC->_tree = _tree->copySyntax();
@@ -176,7 +177,7 @@ WhereClause::prependAndTerm(std::shared_ptr<BoolTerm> t) {
     // FIXME: Should deal with case where AndTerm is not found.
     AndTerm* rootAnd = dynamic_cast<AndTerm*>(insertPos.get());
     if (!rootAnd) {
-        std::shared_ptr<AndTerm> a = std::make_shared<AndTerm>();
+        std::shared_ptr<AndTerm> a = util::makeShared<AndTerm>();
         std::shared_ptr<BoolTerm> oldTree(_tree);
         _tree = a;
         if (oldTree.get()) { // Only add oldTree root if non-NULL
@@ -209,7 +210,7 @@ WhereClause::prependAndTerm(std::shared_ptr<BoolTerm> t) {
 ////////////////////////////////////////////////////////////////////////
 void
 WhereClause::resetRestrs() {
-    _restrs = std::make_shared<QsRestrictor::PtrVector>();
+    _restrs = util::makeShared<QsRestrictor::PtrVector>();
 }
 
 }}} // namespace lsst::qserv::query
@@ -54,17 +54,22 @@
 #include "lsst/log/Log.h"
 
 // Qserv headers
+#include "global/constants.h"
 #include "mysql/LocalInfile.h"
 #include "mysql/MySqlConnection.h"
 #include "proto/WorkerResponse.h"
 #include "proto/ProtoImporter.h"
+#include "query/SelectList.h"
 #include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
 #include "rproc/ProtoRowBuffer.h"
+#include "rproc/TopKFilter.h"
 #include "sql/Schema.h"
 #include "sql/SqlConnection.h"
 #include "sql/SqlResults.h"
 #include "sql/SqlErrorObject.h"
 #include "sql/statement.h"
+#include "util/Metrics.h"
 #include "util/StringHash.h"
 #include "util/WorkQueue.h"
 
@@ -72,6 +77,13 @@ namespace { // File-scope helpers
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.InfileMerger");
 
+// Merging statistics of all user queries, reported in the czar stats.
+lsst::qserv::util::Metrics& metrics = lsst::qserv::util::Metrics::get();
+lsst::qserv::util::Gauge& mergeBacklog = metrics.gauge("rproc.mergeBacklog");
+lsst::qserv::util::Counter& rowsMerged = metrics.counter("rproc.rowsMerged");
+lsst::qserv::util::Counter& mergesDone = metrics.counter("rproc.merges");
+lsst::qserv::util::Histogram& mergeMicros = metrics.histogram("rproc.mergeMicros");
+
 using lsst::qserv::mysql::MySqlConfig;
 using lsst::qserv::rproc::InfileMergerConfig;
 using lsst::qserv::rproc::InfileMergerError;
@@ -140,6 +152,7 @@ public:
     void signalDone(bool success, ActionMerge& a) {
         std::lock_guard<std::mutex> lock(_inflightMutex);
         --_numInflight;
+        mergeBacklog.sub();
         // TODO: do something with the result so we can catch errors.
         if (_numInflight == 0) {
             _inflightZero.notify_all();
@@ -152,6 +165,7 @@ private:
     void _incrementInflight() {
         std::lock_guard<std::mutex> lock(_inflightMutex);
         ++_numInflight;
+        mergeBacklog.add();
     }
 
     bool _setupConnection() {
@@ -219,6 +233,9 @@ bool InfileMerger::Mgr::_doMerge(std::shared_ptr<proto::WorkerResponse>& respons
     auto end = std::chrono::system_clock::now();
     auto mergeDur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
     LOGS(_log, LOG_LVL_DEBUG, "mergeDur=" << mergeDur.count());
+    mergeMicros.record(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    mergesDone.add();
+    rowsMerged.add(response->result.row_size());
     return ret;
 }
 
@@ -245,10 +262,13 @@ bool InfileMerger::Mgr::applyMysql(std::string const& query) {
 InfileMerger::InfileMerger(InfileMergerConfig const& c)
     : _config(c),
       _isFinished(false),
-      _needCreateTable(true) {
+      _needCreateTable(true),
+      _rowLimit(NOTSET) {
     _fixupTargetName();
     if (_config.mergeStmt) {
         _config.mergeStmt->setFromListAsTable(_mergeTable);
+        _topKFilter = TopKFilter::newFromStmt(*_config.mergeStmt);
+        _setupRowLimit();
     }
     _mgr.reset(new Mgr(_config.mySqlConfig, _mergeTable));
 }
@@ -280,6 +300,10 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> response) {
             return false;
         }
     }
+    if (_topKFilter) {
+        int dropped = _topKFilter->filter(response->result);
+        LOGS(_log, LOG_LVL_DEBUG, "TopKFilter dropped " << dropped << " rows");
+    }
     return _importResponse(response);
 }
 
@@ -313,6 +337,11 @@ bool InfileMerger::finalize() {
             LOGS(_log, LOG_LVL_DEBUG, "Failure cleaning up table " << _mergeTable);
         }
     }
+    if (_topKFilter && _topKFilter->isEnabled()) {
+        LOGS(_log, LOG_LVL_DEBUG, "TopKFilter limit=" << _topKFilter->getLimit()
+             << " rowsSeen=" << _topKFilter->getRowsSeen()
+             << " rowsDropped=" << _topKFilter->getRowsDropped());
+    }
     LOGS(_log, LOG_LVL_DEBUG, "Merged " << _mergeTable << " into " << _config.targetTable);
     _isFinished = true;
     return finalizeOk;
@@ -388,8 +417,19 @@ bool InfileMerger::_importResponse(std::shared_ptr<proto::WorkerResponse> respon
     if (response->result.row_size() == 0) {
         // Nothing further, don't bother importing
     } else {
+        int rowCount = response->result.row_size();
         // Delegate merging thread mgmt to mgr
         _mgr->queMerge(response);
+        if (_rowLimit != NOTSET) {
+            std::int64_t merged = (_rowsMerged += rowCount);
+            if (merged >= _rowLimit && !_rowLimitReached.exchange(true)) {
+                LOGS(_log, LOG_LVL_DEBUG, "InfileMerger row limit " << _rowLimit
+                     << " reached with " << merged << " rows");
+                if (_rowLimitCallback) {
+                    _rowLimitCallback();
+                }
+            }
+        }
     }
     return true;
 }
@@ -420,6 +460,9 @@ bool InfileMerger::_setupTable(proto::WorkerResponse const& response) {
 
             s.columns.push_back(scs);
         }
+        if (_topKFilter) {
+            _topKFilter->setSchema(rs);
+        }
         std::string createStmt = sql::formCreateTable(_mergeTable, s);
         // Specifying engine. There is some question about whether InnoDB or MyISAM is the better
         // choice when multiple threads are writing to the result table.
@@ -456,4 +499,25 @@ void InfileMerger::_fixupTargetName() {
         _mergeTable = _config.targetTable;
     }
 }
+/// Determine if the merge statement only truncates the result to its LIMIT,
+/// in which case any _rowLimit rows of the chunk results form a valid answer.
+void InfileMerger::_setupRowLimit() {
+    query::SelectStmt const& stmt = *_config.mergeStmt;
+    if (!stmt.hasLimit() || stmt.hasOrderBy() || stmt.hasGroupBy()
+        || stmt.hasHaving() || stmt.getDistinct()) {
+        return;
+    }
+    auto vList = stmt.getSelectList().getValueExprList();
+    if (!vList) {
+        return;
+    }
+    for (auto const& ve : *vList) {
+        if (ve && ve->hasAggregation()) {
+            return;
+        }
+    }
+    _rowLimit = stmt.getLimit();
+    LOGS(_log, LOG_LVL_DEBUG, "InfileMerger row limit=" << _rowLimit);
+}
+
 }}} // namespace lsst::qserv::rproc
@@ -30,6 +30,9 @@
 /// (see individual class documentation for more information)
 
 // System headers
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -65,6 +68,8 @@ namespace lsst {
 namespace qserv {
 namespace rproc {
 
+class TopKFilter;
+
 /** \typedef InfileMergerError Store InfileMerger error code.
  *
  * \note:
@@ -121,6 +126,17 @@ public:
     /// Check if the object has completed all processing.
     bool isFinished() const;
 
+    /// @return the LIMIT of a query whose merge only truncates rows (no ORDER BY,
+    ///         GROUP BY, DISTINCT or aggregation), lsst::qserv::NOTSET otherwise.
+    int getRowLimit() const { return _rowLimit; }
+    /// Set a function to call once, when the number of merged rows first
+    /// reaches getRowLimit(). It is called from the thread calling merge().
+    void setRowLimitCallback(std::function<void()> const& callback) {
+        _rowLimitCallback = callback;
+    }
+    /// @return true if enough rows have been merged to satisfy getRowLimit().
+    bool isRowLimitReached() const { return _rowLimitReached; }
+
 private:
     int _readHeader(proto::ProtoHeader& header, char const* buffer, int length);
     int _readResult(proto::Result& result, char const* buffer, int length);
@@ -131,6 +147,7 @@ private:
     bool _applySql(std::string const& sql);
     bool _applySqlLocal(std::string const& sql);
     void _fixupTargetName();
+    void _setupRowLimit();
 
     InfileMergerConfig _config; ///< Configuration
     std::shared_ptr<sql::SqlConnection> _sqlConn; ///< SQL connection
@@ -145,6 +162,14 @@ private:
     class Mgr;
     std::unique_ptr<Mgr> _mgr; ///< Delegate merging action object
 
+    /// Drops rows that cannot reach the result of ORDER BY ... LIMIT queries.
+    std::shared_ptr<TopKFilter> _topKFilter;
+
+    int _rowLimit; ///< LIMIT of a truncate-only merge, or NOTSET.
+    std::atomic<std::int64_t> _rowsMerged{0}; ///< Rows queued for merging.
+    std::atomic<bool> _rowLimitReached{false};
+    std::function<void()> _rowLimitCallback;
+
     bool _needCreateTable; ///< Does the target table need creating?
 };
 
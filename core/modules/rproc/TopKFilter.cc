@@ -0,0 +1,244 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/TopKFilter.h"
+
+// System headers
+#include <algorithm>
+#include <cstdlib>
+
+// Third-party headers
+#include "boost/algorithm/string/predicate.hpp"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "query/ColumnRef.h"
+#include "query/OrderByClause.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.TopKFilter");
+
+using lsst::qserv::rproc::TopKFilter;
+
+/// @return the kind of sort key to use for a column of type 'sqlType',
+///         NUL if the type cannot be compared here.
+TopKFilter::Value::Kind kindFromSqlType(std::string const& sqlType) {
+    using boost::algorithm::istarts_with;
+    using boost::algorithm::icontains;
+    if (istarts_with(sqlType, "TINYINT") || istarts_with(sqlType, "SMALLINT")
+        || istarts_with(sqlType, "INT") || istarts_with(sqlType, "BIGINT")) {
+        return icontains(sqlType, "UNSIGNED") ? TopKFilter::Value::UINT
+                                              : TopKFilter::Value::INT;
+    }
+    if (istarts_with(sqlType, "FLOAT") || istarts_with(sqlType, "DOUBLE")
+        || istarts_with(sqlType, "REAL")) {
+        return TopKFilter::Value::REAL;
+    }
+    // DECIMAL would lose precision as a double, strings depend on collation.
+    return TopKFilter::Value::NUL;
+}
+
+/// Compare two values of the same kind, NULL sorting first as in MySQL.
+/// @return <0, 0, >0
+int compareValue(TopKFilter::Value const& a, TopKFilter::Value const& b) {
+    if (a.kind == TopKFilter::Value::NUL || b.kind == TopKFilter::Value::NUL) {
+        return (a.kind != TopKFilter::Value::NUL) - (b.kind != TopKFilter::Value::NUL);
+    }
+    switch(a.kind) {
+    case TopKFilter::Value::INT:  return (a.i > b.i) - (a.i < b.i);
+    case TopKFilter::Value::UINT: return (a.u > b.u) - (a.u < b.u);
+    default:                      return (a.d > b.d) - (a.d < b.d);
+    }
+}
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+TopKFilter::TopKFilter(std::vector<OrderColumn> const& orderColumns, int limit)
+    : _orderColumns(orderColumns), _limit(limit) {
+}
+
+TopKFilter::Ptr TopKFilter::newFromStmt(query::SelectStmt const& mergeStmt) {
+    if (!mergeStmt.hasLimit() || mergeStmt.getLimit() <= 0 || !mergeStmt.hasOrderBy()
+        || mergeStmt.hasGroupBy() || mergeStmt.hasHaving() || mergeStmt.getDistinct()) {
+        return nullptr;
+    }
+    auto vList = mergeStmt.getSelectList().getValueExprList();
+    if (!vList) {
+        return nullptr;
+    }
+    for (auto const& ve : *vList) {
+        if (ve && ve->hasAggregation()) {
+            return nullptr;
+        }
+    }
+    std::vector<OrderColumn> orderColumns;
+    for (auto const& term : mergeStmt.getOrderBy().getTerms()) {
+        auto const& expr = term.getExpr();
+        query::ColumnRef::Ptr cr = expr ? expr->getColumnRef() : nullptr;
+        if (!cr || cr->column.empty()) {
+            return nullptr;
+        }
+        orderColumns.emplace_back(cr->column, term.getOrder() == query::OrderByTerm::DESC);
+    }
+    if (orderColumns.empty()) {
+        return nullptr;
+    }
+    return std::make_shared<TopKFilter>(orderColumns, mergeStmt.getLimit());
+}
+
+bool TopKFilter::setSchema(proto::RowSchema const& rowSchema) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_schemaSet) {
+        return _enabled;
+    }
+    _schemaSet = true;
+    std::vector<ColumnInfo> columns;
+    for (auto const& oc : _orderColumns) {
+        int found = -1;
+        for (int i=0, e=rowSchema.columnschema_size(); i != e; ++i) {
+            if (boost::algorithm::iequals(rowSchema.columnschema(i).name(), oc.name)) {
+                if (found >= 0) {
+                    found = -1; // Ambiguous, give up.
+                    break;
+                }
+                found = i;
+            }
+        }
+        if (found < 0) {
+            LOGS(_log, LOG_LVL_DEBUG, "TopKFilter disabled, no unique column " << oc.name);
+            return _enabled = false;
+        }
+        Value::Kind kind = kindFromSqlType(rowSchema.columnschema(found).sqltype());
+        if (kind == Value::NUL) {
+            LOGS(_log, LOG_LVL_DEBUG, "TopKFilter disabled, unsupported type "
+                 << rowSchema.columnschema(found).sqltype() << " for " << oc.name);
+            return _enabled = false;
+        }
+        columns.push_back(ColumnInfo{found, oc.descending, kind});
+    }
+    _columns.swap(columns);
+    LOGS(_log, LOG_LVL_DEBUG, "TopKFilter enabled limit=" << _limit
+         << " columns=" << _columns.size());
+    return _enabled = true;
+}
+
+int TopKFilter::filter(proto::Result& result) {
+    if (!_enabled) {
+        return 0;
+    }
+    auto rows = result.mutable_row();
+    int kept = 0;
+    {
+        // _columns is only written before _enabled is set, under the same lock.
+        std::lock_guard<std::mutex> lock(_mtx);
+        for (int i=0, e=rows->size(); i != e; ++i) {
+            if (_offer(_makeKey(rows->Get(i)))) {
+                if (kept != i) {
+                    rows->SwapElements(kept, i);
+                }
+                ++kept;
+            }
+        }
+        _rowsSeen += rows->size();
+        _rowsDropped += rows->size() - kept;
+    }
+    int dropped = rows->size() - kept;
+    while (rows->size() > kept) {
+        rows->RemoveLast();
+    }
+    return dropped;
+}
+
+std::int64_t TopKFilter::getRowsSeen() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _rowsSeen;
+}
+
+std::int64_t TopKFilter::getRowsDropped() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _rowsDropped;
+}
+
+/// Must be called with _mtx held.
+TopKFilter::Key TopKFilter::_makeKey(proto::RowBundle const& row) const {
+    Key key(_columns.size());
+    for (unsigned int j=0; j < _columns.size(); ++j) {
+        ColumnInfo const& ci = _columns[j];
+        Value& v = key[j];
+        if (ci.index >= row.column_size()
+            || (ci.index < row.isnull_size() && row.isnull(ci.index))) {
+            continue; // NULL
+        }
+        char const* str = row.column(ci.index).c_str();
+        v.kind = ci.kind;
+        switch(ci.kind) {
+        case Value::INT:  v.i = std::strtoll(str, nullptr, 10); break;
+        case Value::UINT: v.u = std::strtoull(str, nullptr, 10); break;
+        default:          v.d = std::strtod(str, nullptr); break;
+        }
+    }
+    return key;
+}
+
+bool TopKFilter::_less(Key const& a, Key const& b) const {
+    for (unsigned int j=0; j < _columns.size(); ++j) {
+        int c = compareValue(a[j], b[j]);
+        if (c != 0) {
+            return _columns[j].descending ? c > 0 : c < 0;
+        }
+    }
+    return false;
+}
+
+/// Offer a key to the heap. Must be called with _mtx held.
+/// @return true if the row belongs in the current top K.
+bool TopKFilter::_offer(Key&& key) {
+    auto cmp = [this](Key const& a, Key const& b) { return _less(a, b); };
+    if (static_cast<int>(_heap.size()) < _limit) {
+        _heap.push_back(std::move(key));
+        std::push_heap(_heap.begin(), _heap.end(), cmp);
+        return true;
+    }
+    // Ties with the K-th row are dropped: any of them is an equally valid answer.
+    if (!_less(key, _heap.front())) {
+        return false;
+    }
+    std::pop_heap(_heap.begin(), _heap.end(), cmp);
+    _heap.back() = std::move(key);
+    std::push_heap(_heap.begin(), _heap.end(), cmp);
+    return true;
+}
+
+}}} // namespace lsst::qserv::rproc
@@ -0,0 +1,136 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_TOPKFILTER_H
+#define LSST_QSERV_RPROC_TOPKFILTER_H
+
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace proto {
+    class Result;
+    class RowBundle;
+    class RowSchema;
+}
+namespace query {
+    class SelectStmt;
+}
+}} // End of forward declarations
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+/// TopKFilter drops result rows that cannot appear in the result of an
+/// "ORDER BY ... LIMIT K" query before they are loaded into the merge table.
+///
+/// It keeps the sort keys of the best K rows seen so far in a bounded heap.
+/// A row that does not sort strictly before the current K-th key is dropped,
+/// as the merge statement would discard it anyway. Rows that are kept and
+/// later displaced have already been loaded; the merge statement still sorts
+/// and limits, so the filter only needs to be conservative, not exact.
+///
+/// Only ORDER BY terms that are plain columns of numeric type in the result
+/// schema are supported, since MySQL collations make string ordering
+/// impossible to reproduce here. Filtering is disabled otherwise.
+class TopKFilter {
+public:
+    using Ptr = std::shared_ptr<TopKFilter>;
+
+    struct OrderColumn {
+        OrderColumn(std::string const& name_, bool descending_)
+            : name(name_), descending(descending_) {}
+        std::string name;
+        bool descending;
+    };
+
+    TopKFilter(std::vector<OrderColumn> const& orderColumns, int limit);
+    TopKFilter(TopKFilter const&) = delete;
+    TopKFilter& operator=(TopKFilter const&) = delete;
+
+    /// @return a filter for the merge statement, or nullptr if the statement
+    ///         is not a plain ORDER BY ... LIMIT over columns (aggregation,
+    ///         GROUP BY, DISTINCT or expression ORDER BY terms).
+    static Ptr newFromStmt(query::SelectStmt const& mergeStmt);
+
+    /// Resolve the ORDER BY columns against the result schema. Filtering is
+    /// disabled if any column is missing or is not numeric. Only the first
+    /// call has an effect, filter() keeps all rows until it is made.
+    /// Thread-safe.
+    /// @return true if rows will be filtered.
+    bool setSchema(proto::RowSchema const& rowSchema);
+
+    /// Remove rows of 'result' that cannot be part of the top K.
+    /// Thread-safe.
+    /// @return the number of rows removed.
+    int filter(proto::Result& result);
+
+    bool isEnabled() const { return _enabled; }
+    int getLimit() const { return _limit; }
+    std::int64_t getRowsSeen() const;
+    std::int64_t getRowsDropped() const;
+
+    /// A single sort key value. Integers and floating point values are kept
+    /// separately to avoid losing precision on BIGINT columns.
+    struct Value {
+        enum Kind {NUL, INT, UINT, REAL};
+        Kind kind = NUL;
+        std::int64_t i = 0;
+        std::uint64_t u = 0;
+        double d = 0.0;
+    };
+    using Key = std::vector<Value>;
+
+private:
+    struct ColumnInfo {
+        int index;
+        bool descending;
+        Value::Kind kind;
+    };
+
+    Key _makeKey(proto::RowBundle const& row) const;
+    bool _less(Key const& a, Key const& b) const; ///< true if 'a' sorts first.
+    bool _offer(Key&& key);
+
+    std::vector<OrderColumn> _orderColumns;
+    int const _limit;
+    std::atomic<bool> _enabled{false};
+
+    mutable std::mutex _mtx; ///< protects _schemaSet, _columns, _heap and the counters.
+    bool _schemaSet{false};
+    std::vector<ColumnInfo> _columns;
+    std::vector<Key> _heap; ///< Max-heap by sort order, top is the K-th row.
+    std::int64_t _rowsSeen{0};
+    std::int64_t _rowsDropped{0};
+};
+
+}}} // namespace lsst::qserv::rproc
+
+#endif // LSST_QSERV_RPROC_TOPKFILTER_H
@@ -0,0 +1,130 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "rproc/TopKFilter.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE TopKFilter_1
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::proto::Result;
+using lsst::qserv::rproc::TopKFilter;
+
+struct Fixture {
+    Fixture(void) {
+        auto rs = result.mutable_rowschema();
+        addColumn(*rs, "objectId", "BIGINT(20)");
+        addColumn(*rs, "flux", "DOUBLE");
+        addColumn(*rs, "name", "VARCHAR(20)");
+        result.set_continues(false);
+    }
+    ~Fixture(void) { }
+
+    void addColumn(lsst::qserv::proto::RowSchema& rs, std::string const& name,
+                   std::string const& sqlType) {
+        auto cs = rs.add_columnschema();
+        cs->set_name(name);
+        cs->set_hasdefault(false);
+        cs->set_sqltype(sqlType);
+    }
+
+    void addRow(Result& r, int id, std::string const& flux) {
+        auto row = r.add_row();
+        row->add_column(std::to_string(id));
+        row->add_isnull(false);
+        row->add_column(flux);
+        row->add_isnull(flux.empty());
+        row->add_column("n" + std::to_string(id));
+        row->add_isnull(false);
+    }
+
+    std::vector<int> ids(Result const& r) {
+        std::vector<int> v;
+        for (int i=0; i < r.row_size(); ++i) {
+            v.push_back(std::stoi(r.row(i).column(0)));
+        }
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    Result result;
+};
+
+BOOST_FIXTURE_TEST_SUITE(suite, Fixture)
+
+BOOST_AUTO_TEST_CASE(Descending) {
+    TopKFilter f({TopKFilter::OrderColumn("FLUX", true)}, 2);
+    BOOST_CHECK(f.setSchema(result.rowschema()));
+    addRow(result, 1, "1.5");
+    addRow(result, 2, "3.0");
+    addRow(result, 3, "2.0");
+    addRow(result, 4, "0.5");
+    // Row 1 was in the top 2 when it arrived, so it is kept.
+    BOOST_CHECK_EQUAL(f.filter(result), 1);
+    BOOST_CHECK(ids(result) == std::vector<int>({1, 2, 3}));
+
+    // A later chunk only contributes rows beating the current boundary (2.0).
+    Result r2(result);
+    r2.clear_row();
+    addRow(r2, 5, "2.0");
+    addRow(r2, 6, "2.5");
+    addRow(r2, 7, "");
+    BOOST_CHECK_EQUAL(f.filter(r2), 2);
+    BOOST_CHECK(ids(r2) == std::vector<int>({6}));
+    BOOST_CHECK_EQUAL(f.getRowsSeen(), 7);
+    BOOST_CHECK_EQUAL(f.getRowsDropped(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(AscendingMultiColumn) {
+    TopKFilter f({TopKFilter::OrderColumn("flux", false),
+                  TopKFilter::OrderColumn("objectId", true)}, 2);
+    BOOST_CHECK(f.setSchema(result.rowschema()));
+    addRow(result, 13, ""); // NULL sorts first
+    addRow(result, 12, "1.0");
+    addRow(result, 11, "1.0");
+    addRow(result, 10, "1.0");
+    BOOST_CHECK_EQUAL(f.filter(result), 2);
+    BOOST_CHECK(ids(result) == std::vector<int>({12, 13}));
+}
+
+BOOST_AUTO_TEST_CASE(Disabled) {
+    TopKFilter fStr({TopKFilter::OrderColumn("name", false)}, 1);
+    BOOST_CHECK(!fStr.setSchema(result.rowschema()));
+    TopKFilter fMissing({TopKFilter::OrderColumn("ra", false)}, 1);
+    BOOST_CHECK(!fMissing.setSchema(result.rowschema()));
+    addRow(result, 1, "1.0");
+    addRow(result, 2, "2.0");
+    BOOST_CHECK_EQUAL(fStr.filter(result), 0);
+    BOOST_CHECK_EQUAL(result.row_size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
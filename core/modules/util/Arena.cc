@@ -0,0 +1,79 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/Arena.h"
+
+// System headers
+#include <algorithm>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+thread_local Arena* Arena::_current = nullptr;
+
+
+Arena::~Arena() {
+    for (char* block : _blocks) {
+        delete[] block;
+    }
+}
+
+
+void* Arena::allocate(std::size_t bytes, std::size_t align) {
+    ++_stats.allocs;
+    _stats.bytes += bytes;
+    auto aligned = [align](char* p) {
+        return reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(p) + align - 1) & ~(align - 1));
+    };
+    if (_next != nullptr) {
+        char* p = aligned(_next);
+        if (p + bytes <= _end) {
+            _next = p + bytes;
+            return p;
+        }
+    }
+    // Large objects get a block of their own, so that the free space of
+    // the last block is not lost.
+    if (bytes + align > _blockBytes/4) {
+        return aligned(_newBlock(bytes + align));
+    }
+    char* block = _newBlock(_blockBytes);
+    char* p = aligned(block);
+    _next = p + bytes;
+    _end = block + _blockBytes;
+    return p;
+}
+
+
+char* Arena::_newBlock(std::size_t bytes) {
+    _blocks.reserve(_blocks.size() + 1);
+    char* block = new char[bytes];
+    _blocks.push_back(block);
+    ++_stats.blocks;
+    _stats.reserved += bytes;
+    return block;
+}
+
+}}} // namespace lsst::qserv::util
@@ -0,0 +1,157 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_ARENA_H
+#define LSST_QSERV_UTIL_ARENA_H
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// Arena is a monotonic allocator: it hands out memory from large blocks,
+/// never frees it piecemeal, and releases all blocks at once when it is
+/// destroyed. It is meant for the many small objects of a short-lived graph,
+/// such as the query:: objects of one user query, which are otherwise each
+/// allocated, and freed, by the heap.
+///
+/// Objects are put in an arena with makeShared(), while an Arena::Scope is
+/// active in the thread. Each of them holds a reference to the arena, through
+/// the allocator in its shared_ptr control block, so the arena lives until
+/// its last object is destroyed, whichever outlives the other.
+///
+/// An arena is not thread safe: it must be allocated from by one thread at a
+/// time. Its objects may be released by any thread.
+class Arena : public std::enable_shared_from_this<Arena> {
+public:
+    typedef std::shared_ptr<Arena> Ptr;
+
+    static std::size_t const DEFAULT_BLOCK_BYTES = 32*1024;
+
+    static Ptr create(std::size_t blockBytes=DEFAULT_BLOCK_BYTES) {
+        return Ptr(new Arena(blockBytes));
+    }
+
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+    ~Arena();
+
+    /// @return 'bytes' of memory aligned on 'align', a power of two.
+    void* allocate(std::size_t bytes, std::size_t align);
+
+    struct Stats {
+        std::uint64_t allocs{0};   ///< calls to allocate()
+        std::uint64_t bytes{0};    ///< bytes requested from allocate()
+        std::uint64_t blocks{0};   ///< blocks taken from the heap
+        std::uint64_t reserved{0}; ///< bytes of those blocks
+    };
+    Stats getStats() const { return _stats; }
+
+    /// @return the arena of the innermost Scope active in this thread, or
+    ///         nullptr if there is none.
+    static Arena* current() { return _current; }
+
+    /// Scope makes an arena the current one of this thread, until it is
+    /// destroyed. Scopes nest. A Scope of a null arena allocates from the heap.
+    class Scope {
+    public:
+        explicit Scope(Ptr const& arena) : _arena(arena), _previous(_current) {
+            _current = arena.get();
+        }
+        ~Scope() { _current = _previous; }
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+
+    private:
+        Ptr _arena;
+        Arena* _previous;
+    };
+
+private:
+    explicit Arena(std::size_t blockBytes) : _blockBytes(blockBytes) {}
+    char* _newBlock(std::size_t bytes);
+
+    static thread_local Arena* _current;
+
+    std::size_t const _blockBytes;
+    std::vector<char*> _blocks;
+    char* _next{nullptr}; ///< free space of the last block
+    char* _end{nullptr};
+    Stats _stats;
+};
+
+
+/// ArenaAllocator is a standard allocator that allocates from an Arena,
+/// and keeps it alive. deallocate() does nothing.
+template <class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    template <class U> struct rebind { typedef ArenaAllocator<U> other; };
+
+    explicit ArenaAllocator(Arena::Ptr const& arena) : _arena(arena) {}
+    template <class U>
+    ArenaAllocator(ArenaAllocator<U> const& other) : _arena(other.getArena()) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(_arena->allocate(n*sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, std::size_t) {}
+
+    Arena::Ptr const& getArena() const { return _arena; }
+
+private:
+    Arena::Ptr _arena;
+};
+
+template <class T, class U>
+bool operator==(ArenaAllocator<T> const& a, ArenaAllocator<U> const& b) {
+    return a.getArena() == b.getArena();
+}
+
+template <class T, class U>
+bool operator!=(ArenaAllocator<T> const& a, ArenaAllocator<U> const& b) {
+    return !(a == b);
+}
+
+
+/// @return a new T, as std::make_shared, in the current arena of this thread
+///         if there is one.
+template <class T, class... Args>
+std::shared_ptr<T> makeShared(Args&&... args) {
+    Arena* arena = Arena::current();
+    if (arena == nullptr) {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+    return std::allocate_shared<T>(ArenaAllocator<T>(arena->shared_from_this()),
+                                   std::forward<Args>(args)...);
+}
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_ARENA_H
@@ -0,0 +1,274 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/Diagnostics.h"
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <dirent.h>
+#include <execinfo.h>
+#include <fstream>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <thread>
+#include <unistd.h>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.util.Diagnostics");
+
+std::string const reportSuffix = ".txt";
+
+int const maxFrames = 64;
+
+/// Time a thread has to answer the signal before it is reported without stack.
+std::chrono::milliseconds const sampleTimeout(200);
+
+/// Backtrace of one thread, taken by the signal handler on that thread.
+struct StackSample {
+    pid_t tid{0};
+    void* frames[maxFrames];
+    int depth{0};
+    std::atomic<bool> done{false};
+};
+
+/// The sample the signalled thread fills in. The handler and the collector
+/// both take it atomically, so only one of them ever owns it.
+std::atomic<StackSample*> pendingSample{nullptr};
+
+int stackSignal() { return SIGRTMAX - 3; }
+
+pid_t getTid() { return static_cast<pid_t>(::syscall(SYS_gettid)); }
+
+void stackHandler(int) {
+    int const savedErrno = errno;
+    StackSample* sample = pendingSample.load();
+    // A late signal, sent for an earlier sample, must not take this one.
+    if (sample != nullptr && sample->tid == getTid()
+        && pendingSample.compare_exchange_strong(sample, nullptr)) {
+        sample->depth = ::backtrace(sample->frames, maxFrames);
+        sample->done = true;
+    }
+    errno = savedErrno;
+}
+
+void installStackHandler() {
+    // The first backtrace() call loads libgcc, which must not happen in
+    // the signal handler.
+    void* frame;
+    ::backtrace(&frame, 1);
+    struct sigaction action;
+    action.sa_handler = stackHandler;
+    ::sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (::sigaction(stackSignal(), &action, nullptr) != 0) {
+        LOGS(_log, LOG_LVL_WARN, "failed to install stack sampling handler, errno=" << errno);
+    }
+}
+
+std::vector<pid_t> getThreadIds() {
+    std::vector<pid_t> tids;
+    DIR* dir = ::opendir("/proc/self/task");
+    if (dir == nullptr) return tids;
+    while (struct dirent* entry = ::readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            tids.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+        }
+    }
+    ::closedir(dir);
+    std::sort(tids.begin(), tids.end());
+    return tids;
+}
+
+/// @return the name and the scheduling state (R, S, D...) of thread 'tid'.
+std::pair<std::string, char> getThreadInfo(pid_t tid) {
+    std::string const base = "/proc/self/task/" + std::to_string(tid);
+    std::string name;
+    std::ifstream comm(base + "/comm");
+    std::getline(comm, name);
+    std::string stat;
+    std::ifstream statFile(base + "/stat");
+    std::getline(statFile, stat);
+    // The state follows the name, which is in parentheses and may contain spaces.
+    auto pos = stat.rfind(')');
+    char state = (pos != std::string::npos && pos + 2 < stat.size()) ? stat[pos + 2] : '?';
+    return std::make_pair(name, state);
+}
+
+/// Take the backtrace of thread 'tid', by signalling it.
+/// @return false if the thread did not answer in time.
+bool sampleThread(pid_t tid, StackSample& sample) {
+    if (tid == getTid()) {
+        sample.depth = ::backtrace(sample.frames, maxFrames);
+        return true;
+    }
+    sample.tid = tid;
+    pendingSample = &sample;
+    if (::syscall(SYS_tgkill, ::getpid(), tid, stackSignal()) != 0) {
+        pendingSample.exchange(nullptr);
+        return false; // thread exited
+    }
+    auto const end = std::chrono::steady_clock::now() + sampleTimeout;
+    while (!sample.done && std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (pendingSample.exchange(nullptr) == &sample) {
+        return false; // signal blocked, or thread stuck in the kernel
+    }
+    // The handler owns the sample, wait for it to finish.
+    while (!sample.done) {
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/// @return the UTC time, with microseconds, in a form usable in file names.
+std::string timeStamp() {
+    auto const usec = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::time_t const sec = usec / 1000000;
+    struct tm tm;
+    ::gmtime_r(&sec, &tm);
+    char buf[40];
+    std::size_t len = std::strftime(buf, sizeof buf, "%Y%m%dT%H%M%S", &tm);
+    std::snprintf(buf + len, sizeof buf - len, ".%06dZ", static_cast<int>(usec % 1000000));
+    return buf;
+}
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+Diagnostics::Diagnostics(std::string const& dir, unsigned maxFiles)
+    : _dir(dir), _maxFiles(std::max(maxFiles, 1U)) {
+    if (::mkdir(_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        LOGS(_log, LOG_LVL_WARN, "failed to create diagnostics directory " << _dir
+             << ", errno=" << errno);
+    }
+}
+
+std::string Diagnostics::write(std::string const& name, Writer const& writer) {
+    std::string fileName = timeStamp() + "-" + name;
+    std::replace_if(fileName.begin(), fileName.end(),
+                    [](char c) { return c == '/' || c == ' '; }, '_');
+    std::string const path = _dir + "/" + fileName + reportSuffix;
+    // Write under a temporary name, so that a partial report is never
+    // mistaken for a complete one, nor counted by the rotation.
+    std::string const tmpPath = path + ".tmp";
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        writer(out);
+        out.flush();
+        if (!out) {
+            LOGS(_log, LOG_LVL_WARN, "failed to write diagnostics " << tmpPath);
+            ::unlink(tmpPath.c_str());
+            return std::string();
+        }
+    }
+    if (::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOGS(_log, LOG_LVL_WARN, "failed to rename diagnostics " << tmpPath << ", errno=" << errno);
+        ::unlink(tmpPath.c_str());
+        return std::string();
+    }
+    _rotate();
+    LOGS(_log, LOG_LVL_INFO, "wrote diagnostics " << path);
+    return path;
+}
+
+std::vector<std::string> Diagnostics::getReports() const {
+    std::vector<std::string> names;
+    DIR* dir = ::opendir(_dir.c_str());
+    if (dir == nullptr) return names;
+    while (struct dirent* entry = ::readdir(dir)) {
+        std::string const name(entry->d_name);
+        if (name.size() > reportSuffix.size()
+            && name.compare(name.size() - reportSuffix.size(), reportSuffix.size(), reportSuffix) == 0) {
+            names.push_back(name);
+        }
+    }
+    ::closedir(dir);
+    // Names start with the time, so they sort oldest first.
+    std::sort(names.begin(), names.end());
+    std::vector<std::string> paths;
+    for (auto const& name : names) {
+        paths.push_back(_dir + "/" + name);
+    }
+    return paths;
+}
+
+/// precondition: _mtx is held by the current thread.
+void Diagnostics::_rotate() {
+    auto reports = getReports();
+    for (std::size_t j = 0; j + _maxFiles < reports.size(); ++j) {
+        if (::unlink(reports[j].c_str()) != 0) {
+            LOGS(_log, LOG_LVL_WARN, "failed to remove diagnostics " << reports[j]);
+        }
+    }
+}
+
+void Diagnostics::writeThreadStacks(std::ostream& os) {
+    // Only one thread can take samples at a time, there is a single pending sample.
+    static std::mutex sampleMtx;
+    static std::once_flag installed;
+    std::call_once(installed, installStackHandler);
+    std::lock_guard<std::mutex> lock(sampleMtx);
+
+    for (pid_t tid : getThreadIds()) {
+        auto info = getThreadInfo(tid);
+        os << "thread " << tid << " \"" << info.first << "\" state " << info.second << "\n";
+        StackSample sample;
+        if (!sampleThread(tid, sample)) {
+            os << "  (no stack sample)\n";
+            continue;
+        }
+        char** symbols = ::backtrace_symbols(sample.frames, sample.depth);
+        for (int j = 0; j < sample.depth; ++j) {
+            os << "  #" << j << " ";
+            if (symbols != nullptr) {
+                os << symbols[j];
+            } else {
+                os << sample.frames[j];
+            }
+            os << "\n";
+        }
+        std::free(symbols);
+    }
+}
+
+}}} // namespace lsst::qserv::util
@@ -0,0 +1,80 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_DIAGNOSTICS_H
+#define LSST_QSERV_UTIL_DIAGNOSTICS_H
+
+// System headers
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// Diagnostics writes reports on the state of a process, taken when
+/// something goes wrong (e.g. a query is much slower than expected), to a
+/// local directory, so that intermittent stalls can be analyzed after the
+/// fact. Only the most recent reports are kept.
+///
+/// Nothing is done, and nothing costs, until a report is written.
+class Diagnostics {
+public:
+    using Ptr = std::shared_ptr<Diagnostics>;
+    using Writer = std::function<void(std::ostream&)>;
+
+    /// @param dir directory of the reports, created if it does not exist.
+    /// @param maxFiles number of reports kept, the oldest are removed.
+    Diagnostics(std::string const& dir, unsigned maxFiles);
+    Diagnostics(Diagnostics const&) = delete;
+    Diagnostics& operator=(Diagnostics const&) = delete;
+
+    /// Write a report, <dir>/<UTC time>-<name>.txt, with 'writer', then
+    /// remove the oldest reports. Errors are logged, not thrown.
+    /// @return the path of the report, empty if it could not be written.
+    std::string write(std::string const& name, Writer const& writer);
+
+    /// @return the paths of the reports, oldest first.
+    std::vector<std::string> getReports() const;
+
+    std::string const& getDir() const { return _dir; }
+
+    /// Write a sample of the stack of each thread of this process to 'os',
+    /// with the thread name and state. The other threads are interrupted
+    /// by a signal only long enough to take their backtrace.
+    static void writeThreadStacks(std::ostream& os);
+
+private:
+    void _rotate();
+
+    std::string const _dir;
+    unsigned const _maxFiles;
+    std::mutex _mtx; ///< serializes reports and their rotation
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_DIAGNOSTICS_H
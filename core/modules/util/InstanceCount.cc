@@ -5,6 +5,7 @@
 #include "util/InstanceCount.h"
 
 // System Headers
+#include <cstring>
 
 // LSST headers
 #include "lsst/log/Log.h"
@@ -14,6 +15,8 @@ namespace { // File-scope helpers
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.util.InstanceCount");
 
+constexpr char const* PREFIX = "instances."; ///< of the util::Metrics gauges
+
 } // namespace
 
 
@@ -21,63 +24,56 @@ namespace lsst {
 namespace qserv {
 namespace util {
 
-std::map<std::string, int> InstanceCount::_instances;
-std::recursive_mutex InstanceCount::_mx;
+InstanceCount::InstanceCount(char const* className, Gauge& gauge)
+    : _className{className}, _gauge{&gauge} {
+    _increment("con");
+}
 
 
-InstanceCount::InstanceCount(std::string const& className) :_className{className} {
-    _increment("con");
+InstanceCount::InstanceCount(char const* className)
+    : InstanceCount(className, lookup(className)) {
 }
 
 
-InstanceCount::InstanceCount(InstanceCount const& other) : _className{other._className} {
+Gauge& InstanceCount::lookup(char const* className) {
+    return Metrics::get().gauge(std::string(PREFIX) + className);
+}
+
+
+InstanceCount::InstanceCount(InstanceCount const& other)
+    : _className{other._className}, _gauge{other._gauge} {
     _increment("cpy");
 }
 
 
-InstanceCount::InstanceCount(InstanceCount &&origin) : _className{origin._className} {
+InstanceCount::InstanceCount(InstanceCount &&origin)
+    : _className{origin._className}, _gauge{origin._gauge} {
     _increment("mov");
 }
 
 
-void InstanceCount::_increment(std::string const& source) {
-    std::lock_guard<std::recursive_mutex> lg(_mx);
-    std::pair<std::string const, int> entry(_className, 0);
-    auto ret = _instances.insert(entry);
-    auto iter = ret.first;
-    iter->second += 1;
+void InstanceCount::_increment(char const* source) {
+    _gauge->add();
     LOGS(_log, LOG_LVL_DEBUG, "InstanceCount " << source
-         << " " << iter->first << "=" << iter->second);
+         << " " << _className << "=" << _gauge->get());
 }
 
 
 InstanceCount::~InstanceCount() {
-    std::lock_guard<std::recursive_mutex> lg(_mx);
-    auto iter = _instances.find(_className);
-    if (iter != _instances.end()) {
-        iter->second -= 1;
-        LOGS(_log, LOG_LVL_DEBUG, "~InstanceCount " << iter->first << "=" << iter->second << " : " << *this);
-    } else {
-        LOGS(_log, LOG_LVL_ERROR, "~InstanceCount " << _className << " was not found! : " << *this);
-    }
+    _gauge->sub();
+    LOGS(_log, LOG_LVL_DEBUG, "~InstanceCount " << _className << "=" << _gauge->get() << " : " << *this);
 }
 
 
 int InstanceCount::getCount() {
-    std::lock_guard<std::recursive_mutex> lg(_mx);
-    auto iter = _instances.find(_className);
-    if (iter == _instances.end()) {
-        return 0;
-    }
-    return iter->second;
+    return _gauge->get();
 }
 
 
 std::ostream& operator<<(std::ostream &os, InstanceCount const& instanceCount) {
-    std::lock_guard<std::recursive_mutex> lg(instanceCount._mx);
-    for (auto const& entry : instanceCount._instances) {
+    for (auto const& entry : Metrics::get().snapshot(PREFIX)) {
         if (entry.second != 0) {
-            os << entry.first << "=" << entry.second << " ";
+            os << entry.first.substr(std::strlen(PREFIX)) << "=" << entry.second << " ";
         }
     }
     return os;
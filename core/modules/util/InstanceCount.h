@@ -5,20 +5,29 @@
 #define LSST_QSERV_UTIL_INSTANCECOUNT_H
 
 // System headers
-#include <map>
-#include <mutex>
+#include <ostream>
 #include <string>
 
+// Qserv headers
+#include "util/Metrics.h"
+
 
 namespace lsst {
 namespace qserv {
 namespace util {
 
 /// This a utility class to track the number of instances of any class where it is a member.
+/// The counts are the gauges "instances.<className>" of util::Metrics.
+/// Classes created often should pass gauge<T>(), so that the gauge is looked up
+/// once per class rather than once per instance:
+///     util::InstanceCount _instC{"JobQuery", util::InstanceCount::gauge<JobQuery>("JobQuery")};
 //
 class InstanceCount {
 public:
-    InstanceCount(std::string const& className);
+    /// @param className must outlive this object, a string literal.
+    InstanceCount(char const* className, Gauge& gauge);
+    /// Look up the gauge of className in util::Metrics, under its mutex.
+    explicit InstanceCount(char const* className);
     InstanceCount(InstanceCount const& other);
     InstanceCount(InstanceCount &&origin);
     ~InstanceCount();
@@ -27,14 +36,23 @@ public:
 
     int getCount(); //< Return the number of instances of _className.
 
+    /// @return the gauge of className, looked up on the first call for T only.
+    template <typename T>
+    static Gauge& gauge(char const* className) {
+        static Gauge& g = lookup(className);
+        return g;
+    }
+
+    /// @return the gauge of className, looked up in util::Metrics.
+    static Gauge& lookup(char const* className);
+
     friend std::ostream& operator<<(std::ostream &out, InstanceCount const& instanceCount);
 
 private:
-    std::string _className; //< Names of the of which this is a member.
-    static std::map<std::string, int> _instances; //< Map of instances per class name.
-    static std::recursive_mutex _mx; //< Protects _instances.
+    char const* _className; //< Names of the of which this is a member.
+    Gauge* _gauge; //< Number of instances of _className.
 
-    void _increment(std::string const& source);
+    void _increment(char const* source);
 };
 
 }}} // namespace lsst::qserv::util
@@ -0,0 +1,175 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/Metrics.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+////////////////////////////////////////////////////////////////////////
+// Counter
+////////////////////////////////////////////////////////////////////////
+unsigned Counter::_shard() {
+    static std::atomic<unsigned> next{0};
+    thread_local unsigned shard = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return shard;
+}
+
+
+std::uint64_t Counter::get() const {
+    std::uint64_t sum = 0;
+    for (auto const& shard : _shards) {
+        sum += shard.val.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+// Histogram
+////////////////////////////////////////////////////////////////////////
+unsigned Histogram::bucketOf(std::uint64_t val) {
+    if (val < 16) {
+        return val;
+    }
+    unsigned msb = 63 - __builtin_clzll(val);
+    unsigned top = val >> (msb - 3); // 8 to 15
+    return 16 + (msb - 4)*8 + (top - 8);
+}
+
+
+std::uint64_t Histogram::bucketMax(unsigned bucket) {
+    if (bucket < 16) {
+        return bucket;
+    }
+    unsigned msb = (bucket - 16)/8 + 4;
+    std::uint64_t top = (bucket - 16)%8 + 8;
+    return ((top + 1) << (msb - 3)) - 1;
+}
+
+
+void Histogram::record(std::uint64_t val) {
+    _buckets[bucketOf(val)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(val, std::memory_order_relaxed);
+    auto max = _max.load(std::memory_order_relaxed);
+    while (val > max && !_max.compare_exchange_weak(max, val, std::memory_order_relaxed)) {
+    }
+}
+
+
+std::uint64_t Histogram::getPercentile(double fraction) const {
+    std::uint64_t counts[BUCKETS];
+    std::uint64_t total = 0;
+    for (unsigned j = 0; j < BUCKETS; ++j) {
+        counts[j] = _buckets[j].load(std::memory_order_relaxed);
+        total += counts[j];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    auto rank = static_cast<std::uint64_t>(std::ceil(fraction * total));
+    if (rank == 0) rank = 1;
+    std::uint64_t seen = 0;
+    for (unsigned j = 0; j < BUCKETS; ++j) {
+        seen += counts[j];
+        if (seen >= rank) {
+            return std::min(bucketMax(j), getMax());
+        }
+    }
+    return getMax();
+}
+
+
+////////////////////////////////////////////////////////////////////////
+// Metrics
+////////////////////////////////////////////////////////////////////////
+Metrics& Metrics::get() {
+    static Metrics metrics;
+    return metrics;
+}
+
+
+Counter& Metrics::counter(std::string const& name) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto& ptr = _counters[name];
+    if (ptr == nullptr) ptr.reset(new Counter());
+    return *ptr;
+}
+
+
+Gauge& Metrics::gauge(std::string const& name) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto& ptr = _gauges[name];
+    if (ptr == nullptr) ptr.reset(new Gauge());
+    return *ptr;
+}
+
+
+Histogram& Metrics::histogram(std::string const& name) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto& ptr = _histograms[name];
+    if (ptr == nullptr) ptr.reset(new Histogram());
+    return *ptr;
+}
+
+
+Metrics::Snapshot Metrics::snapshot(std::string const& prefix) const {
+    auto matches = [&prefix](std::string const& name) {
+        return name.compare(0, prefix.size(), prefix) == 0;
+    };
+    Snapshot snap;
+    std::lock_guard<std::mutex> lock(_mtx);
+    for (auto const& elem : _counters) {
+        if (matches(elem.first)) snap[elem.first] = elem.second->get();
+    }
+    for (auto const& elem : _gauges) {
+        if (matches(elem.first)) snap[elem.first] = elem.second->get();
+    }
+    for (auto const& elem : _histograms) {
+        if (!matches(elem.first)) continue;
+        Histogram const& hist = *elem.second;
+        snap[elem.first + ".count"] = hist.getCount();
+        snap[elem.first + ".sum"] = hist.getSum();
+        snap[elem.first + ".max"] = hist.getMax();
+        snap[elem.first + ".p50"] = hist.getPercentile(0.5);
+        snap[elem.first + ".p90"] = hist.getPercentile(0.9);
+        snap[elem.first + ".p99"] = hist.getPercentile(0.99);
+    }
+    return snap;
+}
+
+
+void Metrics::write(std::ostream& os, std::string const& prefix) const {
+    for (auto const& elem : snapshot(prefix)) {
+        os << elem.first << " " << elem.second << "\n";
+    }
+}
+
+}}} // namespace lsst::qserv::util
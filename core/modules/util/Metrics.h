@@ -0,0 +1,158 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_METRICS_H
+#define LSST_QSERV_UTIL_METRICS_H
+
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// Counter is a count that only goes up. It is split in shards, each thread
+/// adding to its own shard, so that threads counting the same event do not
+/// contend for the same cache line.
+class Counter {
+public:
+    Counter() = default;
+    Counter(Counter const&) = delete;
+    Counter& operator=(Counter const&) = delete;
+
+    void add(std::uint64_t n=1) {
+        _shards[_shard()].val.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// @return the sum of all shards.
+    std::uint64_t get() const;
+
+private:
+    static unsigned _shard();
+
+    static unsigned const SHARDS = 16;
+    struct Shard {
+        std::atomic<std::uint64_t> val{0};
+        char pad[64 - sizeof(std::atomic<std::uint64_t>)]; ///< one shard per cache line
+    };
+    Shard _shards[SHARDS];
+};
+
+
+/// Gauge is a value that goes up and down, such as a number of instances.
+class Gauge {
+public:
+    Gauge() = default;
+    Gauge(Gauge const&) = delete;
+    Gauge& operator=(Gauge const&) = delete;
+
+    void add(std::int64_t n=1) { _val.fetch_add(n, std::memory_order_relaxed); }
+    void sub(std::int64_t n=1) { _val.fetch_sub(n, std::memory_order_relaxed); }
+    void set(std::int64_t n) { _val.store(n, std::memory_order_relaxed); }
+    std::int64_t get() const { return _val.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> _val{0};
+};
+
+
+/// Histogram counts values, typically latencies in microseconds, in
+/// log-linear buckets: values below 16 are counted exactly, larger ones in
+/// 8 buckets per power of two, so percentiles are within 12.5% of the
+/// recorded values, from 0 to 2^64.
+class Histogram {
+public:
+    Histogram() = default;
+    Histogram(Histogram const&) = delete;
+    Histogram& operator=(Histogram const&) = delete;
+
+    void record(std::uint64_t val);
+
+    std::uint64_t getCount() const { return _count.load(std::memory_order_relaxed); }
+    std::uint64_t getSum() const { return _sum.load(std::memory_order_relaxed); }
+    std::uint64_t getMax() const { return _max.load(std::memory_order_relaxed); }
+
+    /// @return the upper bound of the bucket holding the 'fraction' percentile,
+    ///         such as 0.99, of the recorded values, 0 if none were recorded.
+    std::uint64_t getPercentile(double fraction) const;
+
+    static unsigned bucketOf(std::uint64_t val);
+    static std::uint64_t bucketMax(unsigned bucket);
+
+    static unsigned const BUCKETS = 16 + 60*8;
+
+private:
+    std::atomic<std::uint64_t> _buckets[BUCKETS] = {};
+    std::atomic<std::uint64_t> _count{0};
+    std::atomic<std::uint64_t> _sum{0};
+    std::atomic<std::uint64_t> _max{0};
+};
+
+
+/// Metrics is the process-wide registry of named counters, gauges and histograms.
+///
+/// Looking a metric up by name takes a mutex and may allocate it, so callers
+/// look it up once and keep the reference, which stays valid for the life of
+/// the process. Updating a metric after that neither locks nor allocates.
+///
+/// Names are dot separated, such as "memman.bytesLocked". A name should be
+/// used for one kind of metric only.
+class Metrics {
+public:
+    /// Values of the metrics, by name. A histogram "h" has the values
+    /// h.count, h.sum, h.max, h.p50, h.p90 and h.p99.
+    using Snapshot = std::map<std::string, std::int64_t>;
+
+    /// @return the registry of this process.
+    static Metrics& get();
+
+    Counter& counter(std::string const& name);
+    Gauge& gauge(std::string const& name);
+    Histogram& histogram(std::string const& name);
+
+    /// @return the values of the metrics whose name starts with 'prefix'.
+    Snapshot snapshot(std::string const& prefix=std::string()) const;
+
+    /// Write the values of the metrics whose name starts with 'prefix',
+    /// one "name value" pair per line.
+    void write(std::ostream& os, std::string const& prefix=std::string()) const;
+
+private:
+    Metrics() = default;
+    Metrics(Metrics const&) = delete;
+    Metrics& operator=(Metrics const&) = delete;
+
+    mutable std::mutex _mtx; ///< protects the maps, not the metrics
+    std::map<std::string, std::unique_ptr<Counter>> _counters;
+    std::map<std::string, std::unique_ptr<Gauge>> _gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> _histograms;
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_METRICS_H
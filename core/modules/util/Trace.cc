@@ -0,0 +1,148 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/Trace.h"
+
+// System headers
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+
+/// Write 's' as a JSON string.
+void writeJsonStr(std::ostream& os, std::string const& s) {
+    os << '"';
+    for (char c : s) {
+        switch (c) {
+        case '"':  os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n"; break;
+        case '\t': os << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                os << ' ';
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+}
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+std::int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+void Trace::add(std::string const& name, std::int64_t begin, std::int64_t end, int jobId) {
+    add(Span{name, begin, end, jobId, _where});
+}
+
+
+void Trace::add(Span const& span) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _spans.push_back(span);
+}
+
+
+std::vector<Trace::Span> Trace::getSpans() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _spans;
+}
+
+
+std::string Trace::summaryStr() const {
+    struct Total {
+        int count{0};
+        std::int64_t sum{0};
+        std::int64_t max{0};
+    };
+    std::map<std::string, Total> totals;
+    for (auto const& span : getSpans()) {
+        auto& total = totals[span.name];
+        auto dur = span.end - span.begin;
+        ++total.count;
+        total.sum += dur;
+        total.max = std::max(total.max, dur);
+    }
+    std::ostringstream os;
+    os << _idStr;
+    for (auto const& elem : totals) {
+        os << " " << elem.first << "(n=" << elem.second.count
+           << " ms=" << elem.second.sum / 1000.0 << " max=" << elem.second.max / 1000.0 << ")";
+    }
+    return os.str();
+}
+
+
+void Trace::writeChromeJson(std::ostream& os) const {
+    auto spans = getSpans();
+    std::map<std::string, int> pids;
+    for (auto const& span : spans) {
+        pids.insert(std::make_pair(span.where, static_cast<int>(pids.size())));
+    }
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for (auto const& elem : pids) {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << elem.second
+           << ",\"args\":{\"name\":";
+        writeJsonStr(os, elem.first);
+        os << "}}";
+    }
+    for (auto const& span : spans) {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "{\"name\":";
+        writeJsonStr(os, span.name);
+        os << ",\"cat\":\"qserv\",\"ph\":\"X\",\"ts\":" << span.begin
+           << ",\"dur\":" << std::max<std::int64_t>(0, span.end - span.begin)
+           << ",\"pid\":" << pids[span.where] << ",\"tid\":" << span.jobId + 1
+           << ",\"args\":{\"query\":";
+        writeJsonStr(os, _idStr);
+        os << ",\"jobId\":" << span.jobId << "}}";
+    }
+    os << "\n]}\n";
+}
+
+
+bool Trace::writeChromeJson(std::string const& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    writeChromeJson(out);
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+}}} // namespace lsst::qserv::util
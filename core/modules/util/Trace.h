@@ -0,0 +1,107 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_TRACE_H
+#define LSST_QSERV_UTIL_TRACE_H
+
+// System headers
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// Trace collects the timed steps (spans) of the work done for one user
+/// query, on the czar and on the workers, so that its latency can be
+/// attributed. It can be summarized per step, and written in the Chrome
+/// trace event format, for chrome://tracing or Perfetto.
+///
+/// Times are microseconds since the epoch, so spans measured on different
+/// hosts can be merged, up to the clock skew between the hosts.
+class Trace {
+public:
+    using Ptr = std::shared_ptr<Trace>;
+
+    struct Span {
+        std::string name;
+        std::int64_t begin; ///< microseconds since the epoch
+        std::int64_t end;
+        int jobId;          ///< -1 for steps of the whole query
+        std::string where;  ///< host or component that did the work
+    };
+
+    /// Records a span from its construction to its destruction, if the
+    /// trace is not null.
+    class Scope {
+    public:
+        Scope(Ptr const& trace, std::string const& name, int jobId=-1)
+            : _trace(trace), _name(name), _jobId(jobId), _begin(trace ? now() : 0) {}
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+        ~Scope() { if (_trace) _trace->add(_name, _begin, now(), _jobId); }
+    private:
+        Ptr _trace;
+        std::string _name;
+        int _jobId;
+        std::int64_t _begin;
+    };
+
+    /// @param idStr identifies the query, see qmeta::QueryIdHelper::makeIdStr().
+    /// @param where default place of the spans added.
+    explicit Trace(std::string const& idStr, std::string const& where="czar")
+        : _idStr(idStr), _where(where) {}
+    Trace(Trace const&) = delete;
+    Trace& operator=(Trace const&) = delete;
+
+    /// @return the current time in microseconds since the epoch.
+    static std::int64_t now();
+
+    void add(std::string const& name, std::int64_t begin, std::int64_t end, int jobId=-1);
+    void add(Span const& span);
+
+    std::string const& getIdStr() const { return _idStr; }
+    std::vector<Span> getSpans() const;
+
+    /// @return, for each span name, the number of spans, their total and
+    ///          their longest duration in milliseconds.
+    std::string summaryStr() const;
+
+    /// Write all spans as a Chrome trace. Each place is a process, each job a thread.
+    void writeChromeJson(std::ostream& os) const;
+    /// @return false if 'path' could not be written.
+    bool writeChromeJson(std::string const& path) const;
+
+private:
+    std::string const _idStr;
+    std::string const _where;
+    mutable std::mutex _mtx; ///< protects _spans
+    std::vector<Span> _spans;
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_TRACE_H
@@ -0,0 +1,104 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "util/Arena.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE Arena
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::util::Arena;
+using lsst::qserv::util::makeShared;
+
+namespace {
+
+struct Node {
+    Node(std::string const& name_, std::shared_ptr<Node> const& next_)
+        : name(name_), next(next_) {}
+    std::string name;
+    std::shared_ptr<Node> next;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Alignment) {
+    auto arena = Arena::create(256);
+    for (std::size_t align : {1, 2, 8, 16, 64}) {
+        for (int j = 0; j < 10; ++j) {
+            auto p = reinterpret_cast<std::uintptr_t>(arena->allocate(j + 1, align));
+            BOOST_CHECK_EQUAL(p % align, 0U);
+        }
+    }
+    // Objects larger than a quarter of a block get their own block.
+    void* big = arena->allocate(1000, 8);
+    BOOST_CHECK(big != nullptr);
+    auto stats = arena->getStats();
+    BOOST_CHECK_EQUAL(stats.allocs, 51U);
+    BOOST_CHECK(stats.blocks >= 3U);
+    BOOST_CHECK(stats.reserved >= stats.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(Scopes) {
+    BOOST_CHECK(Arena::current() == nullptr);
+    auto heapNode = makeShared<Node>("heap", nullptr);
+    std::weak_ptr<Arena> weak;
+    std::shared_ptr<Node> list;
+    {
+        auto arena = Arena::create();
+        weak = arena;
+        Arena::Scope scope(arena);
+        BOOST_CHECK_EQUAL(Arena::current(), arena.get());
+        for (int j = 0; j < 100; ++j) {
+            list = makeShared<Node>(std::to_string(j), list);
+        }
+        BOOST_CHECK_EQUAL(arena->getStats().allocs, 100U);
+        {
+            Arena::Scope heap(nullptr);
+            BOOST_CHECK(Arena::current() == nullptr);
+            makeShared<Node>("heap", nullptr);
+        }
+        BOOST_CHECK_EQUAL(Arena::current(), arena.get());
+        BOOST_CHECK_EQUAL(arena->getStats().allocs, 100U);
+    }
+    BOOST_CHECK(Arena::current() == nullptr);
+
+    // The objects keep their arena alive.
+    BOOST_CHECK(!weak.expired());
+    BOOST_CHECK_EQUAL(list->name, "99");
+    BOOST_CHECK_EQUAL(list->next->next->name, "97");
+    list.reset();
+    BOOST_CHECK(weak.expired());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
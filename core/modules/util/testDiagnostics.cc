@@ -0,0 +1,104 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <pthread.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+// Qserv headers
+#include "util/Diagnostics.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE Diagnostics
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::util::Diagnostics;
+
+namespace {
+
+struct TmpDir {
+    TmpDir() {
+        char tmpl[] = "/tmp/testDiagnostics.XXXXXX";
+        path = ::mkdtemp(tmpl);
+    }
+    ~TmpDir() {
+        std::system(("rm -rf " + path).c_str());
+    }
+    std::string path;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Rotation) {
+    TmpDir tmp;
+    Diagnostics diag(tmp.path + "/diag", 3);
+    std::vector<std::string> written;
+    for (int j = 0; j < 5; ++j) {
+        auto path = diag.write("czar-QI=" + std::to_string(j) + ": slow/query",
+                               [j](std::ostream& os) { os << "report " << j << "\n"; });
+        BOOST_REQUIRE(!path.empty());
+        BOOST_CHECK(path.find("slow_query") != std::string::npos);
+        written.push_back(path);
+    }
+    auto reports = diag.getReports();
+    BOOST_REQUIRE_EQUAL(reports.size(), 3U);
+    BOOST_CHECK_EQUAL(reports[0], written[2]);
+    BOOST_CHECK_EQUAL(reports[2], written[4]);
+    std::ifstream in(reports[2]);
+    std::string line;
+    std::getline(in, line);
+    BOOST_CHECK_EQUAL(line, "report 4");
+}
+
+BOOST_AUTO_TEST_CASE(ThreadStacks) {
+    std::atomic<bool> stop{false};
+    std::thread sleeper([&stop]() {
+        ::pthread_setname_np(::pthread_self(), "diagSleeper");
+        while (!stop) {
+            ::usleep(1000);
+        }
+    });
+    ::usleep(20000);
+    std::ostringstream os;
+    Diagnostics::writeThreadStacks(os);
+    stop = true;
+    sleeper.join();
+    auto stacks = os.str();
+    auto pos = stacks.find("\"diagSleeper\"");
+    BOOST_REQUIRE(pos != std::string::npos);
+    // The sleeping thread answered with its stack.
+    BOOST_CHECK(stacks.find("  #0 ", pos) != std::string::npos);
+    BOOST_CHECK(stacks.find("(no stack sample)") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
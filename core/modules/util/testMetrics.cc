@@ -0,0 +1,91 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "util/Metrics.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE Metrics
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::util::Counter;
+using lsst::qserv::util::Histogram;
+using lsst::qserv::util::Metrics;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(CounterThreads) {
+    Counter& counter = Metrics::get().counter("test.counter");
+    BOOST_CHECK_EQUAL(&counter, &Metrics::get().counter("test.counter"));
+    std::vector<std::thread> threads;
+    for (int j = 0; j < 8; ++j) {
+        threads.emplace_back([&counter]() {
+            for (int k = 0; k < 10000; ++k) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thrd : threads) {
+        thrd.join();
+    }
+    BOOST_CHECK_EQUAL(counter.get(), 80000U);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramBuckets) {
+    for (std::uint64_t val : {0ULL, 15ULL, 16ULL, 17ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+        auto bucket = Histogram::bucketOf(val);
+        BOOST_CHECK(bucket < Histogram::BUCKETS);
+        BOOST_CHECK(val <= Histogram::bucketMax(bucket));
+        BOOST_CHECK(bucket == 0 || val > Histogram::bucketMax(bucket - 1));
+    }
+    Histogram& hist = Metrics::get().histogram("test.latency");
+    for (std::uint64_t val = 1; val <= 1000; ++val) {
+        hist.record(val);
+    }
+    BOOST_CHECK_EQUAL(hist.getCount(), 1000U);
+    BOOST_CHECK_EQUAL(hist.getMax(), 1000U);
+    auto p50 = hist.getPercentile(0.5);
+    BOOST_CHECK(p50 >= 500 && p50 <= 500*1.125);
+    BOOST_CHECK_EQUAL(hist.getPercentile(1.0), 1000U);
+}
+
+BOOST_AUTO_TEST_CASE(Export) {
+    Metrics::get().gauge("test.gauge").set(-3);
+    auto snap = Metrics::get().snapshot("test.");
+    BOOST_CHECK_EQUAL(snap["test.gauge"], -3);
+    BOOST_CHECK_EQUAL(snap["test.latency.count"], 1000);
+    BOOST_CHECK(snap.find("test.latency.p99") != snap.end());
+    std::ostringstream os;
+    Metrics::get().write(os, "test.g");
+    BOOST_CHECK_EQUAL(os.str(), "test.gauge -3\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,71 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <sstream>
+#include <string>
+
+// Qserv headers
+#include "util/Trace.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE Trace
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::util::Trace;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Spans) {
+    auto trace = std::make_shared<Trace>("QI=7:");
+    {
+        Trace::Scope scope(trace, "submit");
+    }
+    {
+        Trace::Scope none(nullptr, "ignored");
+    }
+    trace->add("merge", 1000, 3000, 2);
+    trace->add("merge", 5000, 9000, 3);
+    trace->add(Trace::Span{"mysql", 2000, 2500, 2, "worker\"1"});
+    auto spans = trace->getSpans();
+    BOOST_REQUIRE_EQUAL(spans.size(), 4U);
+    BOOST_CHECK_EQUAL(spans[0].name, "submit");
+    BOOST_CHECK(spans[0].begin <= spans[0].end);
+    BOOST_CHECK_EQUAL(spans[0].where, "czar");
+
+    auto summary = trace->summaryStr();
+    BOOST_CHECK(summary.find("merge(n=2 ms=6 max=4)") != std::string::npos);
+
+    std::ostringstream os;
+    trace->writeChromeJson(os);
+    auto json = os.str();
+    BOOST_CHECK(json.find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK(json.find("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                          "\"args\":{\"name\":\"worker\\\"1\"}}") != std::string::npos);
+    BOOST_CHECK(json.find("{\"name\":\"merge\",\"cat\":\"qserv\",\"ph\":\"X\",\"ts\":5000,"
+                          "\"dur\":4000,\"pid\":0,\"tid\":4,") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
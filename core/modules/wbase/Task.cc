@@ -31,6 +31,9 @@
 // Class header
 #include "wbase/Task.h"
 
+// System headers
+#include <algorithm>
+
 // Third-party headers
 #include "boost/regex.hpp"
 
@@ -38,6 +41,7 @@
 #include "lsst/log/Log.h"
 
 // Qserv headers
+#include "global/debugUtil.h"
 #include "proto/TaskMsgDigest.h"
 #include "proto/worker.pb.h"
 #include "wbase/Base.h"
@@ -114,6 +118,24 @@ Task::Task(Task::TaskMsgPtr const& t, SendChannel::Ptr const& sc)
     }
     _scanInfo.scanRating = msg->scanpriority();
     _scanInfo.sortTablesSlowestFirst();
+
+    // Older czars do not send a class, tasks without scan tables are interactive.
+    if (msg->has_priorityclass()) {
+        _interactive = msg->priorityclass() == proto::TaskMsg::INTERACTIVE;
+    } else {
+        _interactive = _scanInfo.infoTables.empty();
+    }
+    // Only interactive Tasks have a deadline. It is relative to the time
+    // the Task was received, on this worker's clock.
+    if (_interactive && msg->has_deadlinebudget()) {
+        _hasDeadline = true;
+        _deadline = std::chrono::steady_clock::now()
+                  + std::chrono::milliseconds(std::max<std::int64_t>(msg->deadlinebudget(), 0));
+    }
+    if (msg->trace()) {
+        _trace = std::make_shared<util::Trace>(_idStr, getHostname());
+        _received = util::Trace::now();
+    }
 }
 
 Task::~Task() {
@@ -174,6 +196,26 @@ void Task::endTime() {
     LOGS(_log, LOG_LVL_DEBUG, _idStr << " processing sec=" << duration.count());
 }
 
+
+std::chrono::milliseconds Task::getRunTime() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(_endTime - _startTime);
+}
+
+
+void Task::startMemLock() {
+    if (_memLockStart == 0) {
+        _memLockStart = util::Trace::now();
+    }
+}
+
+
+void Task::endMemLock(std::uint64_t bytes) {
+    if (_memLockStart != 0) {
+        _memLockWait = util::Trace::now() - _memLockStart;
+    }
+    _chunkBytes = bytes;
+}
+
 std::ostream& operator<<(std::ostream& os, Task const& t) {
     proto::TaskMsg& m = *t.msg;
     os << "Task: "
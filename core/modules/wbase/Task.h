@@ -28,6 +28,7 @@
 // System headers
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -41,7 +42,9 @@
 #include "proto/ScanTableInfo.h"
 #include "qmeta/types.h"
 #include "util/EventThread.h"
+#include "util/Metrics.h"
 #include "util/threadSafe.h"
+#include "util/Trace.h"
 
 // Forward declarations
 namespace lsst {
@@ -151,8 +154,44 @@ public:
     static IdSet allIds; // set of all task jobId numbers that are not complete.
     std::string getIdStr() {return _idStr;}
 
+    /// @return true if this is an interactive Task and the czar sent a
+    ///         deadline budget for it.
+    bool hasDeadline() const { return _hasDeadline; }
+    /// @return the deadline for starting this Task, the time it was received
+    ///         plus the budget, only meaningful if hasDeadline().
+    std::chrono::steady_clock::time_point getDeadline() const { return _deadline; }
+    /// @return true if the Task is expected to finish quickly, rather than
+    ///         being part of a shared scan.
+    bool isInteractive() const { return _interactive; }
+
     void startTime();
     void endTime();
+    /// @return the time between startTime() and endTime().
+    std::chrono::milliseconds getRunTime() const;
+    /// Record the time spent in mysql, excluding the time sending results.
+    void setMysqlTime(std::chrono::microseconds t) { _mysqlUs = t.count(); }
+    /// @return the time spent in mysql, zero if the queries did not run.
+    std::chrono::microseconds getMysqlTime() const { return std::chrono::microseconds(_mysqlUs); }
+
+    /// Record bytes of result data sent for this Task.
+    void addResultBytes(std::uint64_t bytes) { _resultBytes += bytes; }
+    std::uint64_t getResultBytes() const { return _resultBytes; }
+
+    /// @return the trace of this Task's steps, nullptr unless the czar asked for it.
+    util::Trace::Ptr const& getTrace() const { return _trace; }
+    /// @return the time this Task was received, in microseconds since the epoch.
+    std::int64_t getReceived() const { return _received; }
+
+    /// Called by the scheduler before each attempt to lock the chunk tables
+    /// of this Task in memory.
+    void startMemLock();
+    /// Called by the scheduler once the tables are locked, 'bytes' of them.
+    void endMemLock(std::uint64_t bytes);
+    /// @return microseconds from the first attempt to lock the chunk tables
+    ///         of this Task to the lock.
+    std::int64_t getMemLockWait() const { return _memLockWait; }
+    /// @return bytes of chunk tables locked in memory for this Task.
+    std::uint64_t getChunkBytes() const { return _chunkBytes; }
 
 private:
     QueryId  const    _qId{0}; //< queryId from czar
@@ -167,12 +206,26 @@ private:
 
     std::chrono::system_clock::time_point _startTime;
     std::chrono::system_clock::time_point _endTime;
+    std::atomic<std::uint64_t> _resultBytes{0};
+    std::atomic<std::int64_t> _mysqlUs{0};
+
+    bool _hasDeadline{false};
+    std::chrono::steady_clock::time_point _deadline;
+    bool _interactive{false};
+    util::Trace::Ptr _trace;
+    std::int64_t _received{0};
+    std::int64_t _memLockStart{0}; ///< first attempt to lock, set by the scheduler thread
+    std::atomic<std::int64_t> _memLockWait{0};
+    std::atomic<std::uint64_t> _chunkBytes{0};
 };
 
 /// MsgProcessor implementations handle incoming Task objects.
 struct MsgProcessor {
     virtual ~MsgProcessor() {}
     virtual void processTask(std::shared_ptr<wbase::Task> const& task) = 0;
+
+    /// Add the state of the processor to 'stats', see util::Metrics.
+    virtual void addStats(util::Metrics::Snapshot& stats) {}
 };
 
 }}} // namespace lsst::qserv::wbase
@@ -32,6 +32,7 @@
 
 // Qserv headers
 #include "mysql/MySqlConfig.h"
+#include "util/ConfigStoreError.h"
 #include "wsched/BlendScheduler.h"
 
 namespace {
@@ -59,7 +60,17 @@ WorkerConfig::WorkerConfig(const util::ConfigStore& configStore)
       _priorityFast(configStore.getInt("scheduler.priority_fast", 3)),
       _maxReserveSlow(configStore.getInt("scheduler.reserve_slow", 2)),
       _maxReserveMed(configStore.getInt("scheduler.reserve_med", 2)),
-      _maxReserveFast(configStore.getInt("scheduler.reserve_fast", 2)) {
+      _maxReserveFast(configStore.getInt("scheduler.reserve_fast", 2)),
+      _scanPrefetch(configStore.getInt("scheduler.prefetch", 1) != 0),
+      _relaxReserve(configStore.getInt("scheduler.relax_reserve", 0) != 0),
+      _tuneInterval(configStore.getInt("scheduler.tune_interval", 0)),
+      _scanStatsFile(configStore.get("scheduler.scan_stats_file", "")),
+      _diagDir(configStore.get("diagnostics.dir", "")),
+      _slowTaskSec(configStore.getInt("diagnostics.slow_task", 600)),
+      _diagMaxFiles(configStore.getInt("diagnostics.max_files", 20)) {
+    if (_diagMaxFiles < 1) {
+        throw util::InvalidIntegerValue("diagnostics.max_files", std::to_string(_diagMaxFiles));
+    }
 }
 
 std::ostream& operator<<(std::ostream &out, WorkerConfig const& workerConfig) {
@@ -76,6 +87,14 @@ std::ostream& operator<<(std::ostream &out, WorkerConfig const& workerConfig) {
     out << " Reserved threads fast=" << workerConfig._maxReserveFast
          << " med=" << workerConfig._maxReserveMed << " slow=" << workerConfig._maxReserveSlow;
 
+    out << " prefetch=" << workerConfig._scanPrefetch;
+    out << " relaxReserve=" << workerConfig._relaxReserve;
+    out << " tuneInterval=" << workerConfig._tuneInterval;
+    out << " scanStatsFile=" << workerConfig._scanStatsFile;
+    out << " diagDir=" << workerConfig._diagDir;
+    out << " slowTaskSec=" << workerConfig._slowTaskSec;
+    out << " diagMaxFiles=" << workerConfig._diagMaxFiles;
+
     return out;
 }
 
@@ -102,6 +102,62 @@ public:
         return _maxReserveSlow;
     }
 
+    /* Get whether shared scans lock the next chunk in the background
+     *
+     * @return true if the tables of the next chunk are prefetched
+     */
+    bool getScanPrefetch() const {
+        return _scanPrefetch;
+    }
+
+    /* Get whether idle schedulers lend their reserved thread to busy ones
+     *
+     * @return true if thread reservations are relaxed when threads are idle
+     */
+    bool getRelaxReserve() const {
+        return _relaxReserve;
+    }
+
+    /* Get the interval between adjustments of scheduler limits to the load
+     *
+     * @return interval in seconds, 0 if limits are not adjusted
+     */
+    int getTuneInterval() const {
+        return _tuneInterval;
+    }
+
+    /* Get the file where measured shared scan costs are kept
+     *
+     * @return path of the file, empty if scan costs are not measured
+     */
+    std::string const& getScanStatsFile() const {
+        return _scanStatsFile;
+    }
+
+    /* Get the directory diagnostics of slow Tasks are written to
+     *
+     * @return path of the directory, empty if slow Tasks are not diagnosed
+     */
+    std::string const& getDiagDir() const {
+        return _diagDir;
+    }
+
+    /* Get the time after which a running Task is slow
+     *
+     * @return number of seconds, 0 if slow Tasks are not diagnosed
+     */
+    int getSlowTaskSec() const {
+        return _slowTaskSec;
+    }
+
+    /* Get the number of diagnostics reports kept
+     *
+     * @return number of reports, at least 1
+     */
+    unsigned int getDiagMaxFiles() const {
+        return _diagMaxFiles;
+    }
+
     /* Get selected memory management implementation
      *
      * @return class name implementing selected memory management
@@ -186,6 +242,15 @@ private:
     unsigned int const _maxReserveSlow;
     unsigned int const _maxReserveMed;
     unsigned int const _maxReserveFast;
+
+    bool const _scanPrefetch;
+    bool const _relaxReserve;
+    int const _tuneInterval;
+    std::string const _scanStatsFile;
+
+    std::string const _diagDir;
+    int const _slowTaskSec;
+    int const _diagMaxFiles;
 };
 
 }}} // namespace qserv::core::wconfig
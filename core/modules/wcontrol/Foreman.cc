@@ -25,11 +25,13 @@
 #include "wcontrol/Foreman.h"
 
 // System headers
+#include <algorithm>
 #include <cassert>
 #include <deque>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <sstream>
 #include <thread>
 #include <utility>
 
@@ -67,6 +69,14 @@ Foreman::~Foreman() {
     // It will take significant effort to have xrootd shutdown cleanly and this will never get called
     // until that happens.
     _pool->endAll();
+    if (_diagThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_runningMtx);
+            _stopDiag = true;
+        }
+        _stopCv.notify_all();
+        _diagThread.join();
+    }
 }
 
 /// Put the task on the scheduler to be run later.
@@ -82,6 +92,7 @@ void Foreman::processTask(std::shared_ptr<wbase::Task> const& task) {
                 task->sendChannel->sendError("Unsupported wire protocol", 1);
             }
         } else {
+            RunningGuard running(*this, task);
             auto qr = wdb::QueryRunner::newQueryRunner(task, _chunkResourceMgr, _mySqlConfig);
             qr->runQuery();
         }
@@ -91,4 +102,75 @@ void Foreman::processTask(std::shared_ptr<wbase::Task> const& task) {
     _scheduler->queCmd(task);
 }
 
+
+void Foreman::addStats(util::Metrics::Snapshot& stats) {
+    stats["wcontrol.poolThreads"] = _pool->size();
+    _scheduler->addStats(stats);
+}
+
+
+void Foreman::setDiagnostics(util::Diagnostics::Ptr const& diagnostics, std::chrono::seconds slowTask) {
+    _diagnostics = diagnostics;
+    _slowTask = slowTask;
+    _diagThread = std::thread(&Foreman::_checkSlowTasks, this);
+}
+
+
+void Foreman::_taskStarted(wbase::Task::Ptr const& task) {
+    if (_diagnostics == nullptr) return;
+    std::lock_guard<std::mutex> lock(_runningMtx);
+    _running[task] = Running{std::chrono::steady_clock::now(), false};
+}
+
+
+void Foreman::_taskFinished(wbase::Task::Ptr const& task) {
+    if (_diagnostics == nullptr) return;
+    std::lock_guard<std::mutex> lock(_runningMtx);
+    _running.erase(task);
+}
+
+
+/// Look for Tasks running longer than _slowTask, until the Foreman is destroyed.
+void Foreman::_checkSlowTasks() {
+    // Check often enough to catch a slow Task within a tenth of the limit.
+    auto const interval = std::max(std::chrono::seconds(1), _slowTask / 10);
+    std::unique_lock<std::mutex> lock(_runningMtx);
+    while (!_stopDiag) {
+        _stopCv.wait_for(lock, interval);
+        auto const now = std::chrono::steady_clock::now();
+        std::string idStr;
+        std::ostringstream slowTasks;
+        for (auto& entry : _running) {
+            Running& running = entry.second;
+            if (running.reported || now - running.start < _slowTask) continue;
+            running.reported = true;
+            if (idStr.empty()) idStr = entry.first->getIdStr();
+            slowTasks << std::chrono::duration_cast<std::chrono::seconds>(now - running.start).count()
+                      << "s " << *entry.first << "\n";
+        }
+        if (idStr.empty()) continue;
+        lock.unlock();
+        LOGS(_log, LOG_LVL_WARN, idStr << " running for more than " << _slowTask.count()
+             << "s, writing diagnostics");
+        _writeDiagnostics(idStr, slowTasks.str());
+        lock.lock();
+    }
+}
+
+
+void Foreman::_writeDiagnostics(std::string const& idStr, std::string const& slowTasks) {
+    _diagnostics->write("worker-" + idStr, [this, &slowTasks](std::ostream& os) {
+        os << "Tasks running for more than " << _slowTask.count() << "s:\n" << slowTasks;
+        // Metrics include the memory manager state, addStats() the scheduler queues.
+        auto stats = util::Metrics::get().snapshot();
+        addStats(stats);
+        os << "\n== statistics\n";
+        for (auto const& entry : stats) {
+            os << entry.first << " " << entry.second << "\n";
+        }
+        os << "\n== threads\n";
+        util::Diagnostics::writeThreadStacks(os);
+    });
+}
+
 }}} // namespace
@@ -26,11 +26,18 @@
 
 // System headers
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 // Qserv headers
 #include "mysql/MySqlConfig.h"
+#include "util/Diagnostics.h"
 #include "util/EventThread.h"
+#include "util/Metrics.h"
 #include "wbase/Base.h"
 #include "wbase/Task.h"
 
@@ -60,6 +67,9 @@ public:
     /// nothing should be harmless, but some Schedulers may work better if cancelled
     /// tasks are removed.
     virtual void taskCancelled(wbase::Task *task) { return; }
+
+    /// Add queue depths, Tasks in flight and active chunks to 'stats'.
+    virtual void addStats(util::Metrics::Snapshot& stats) { return; }
 };
 
 /// Foreman is used to maintain a thread pool and schedule Tasks for the thread pool.
@@ -75,12 +85,51 @@ public:
 
     void processTask(std::shared_ptr<wbase::Task> const& task) override;
 
+    void addStats(util::Metrics::Snapshot& stats) override;
+
+    /// Write diagnostics to 'diagnostics' when Tasks have been running for
+    /// longer than 'slowTask': the slow Tasks, the statistics of the worker
+    /// and the stacks of its threads. Each Task is reported once. Must be
+    /// called before Tasks are processed.
+    void setDiagnostics(util::Diagnostics::Ptr const& diagnostics, std::chrono::seconds slowTask);
+
 private:
+    void _taskStarted(wbase::Task::Ptr const& task);
+    void _taskFinished(wbase::Task::Ptr const& task);
+
+    /// Keeps a Task in _running while it runs, including when it throws.
+    class RunningGuard {
+    public:
+        RunningGuard(Foreman& foreman, wbase::Task::Ptr const& task)
+            : _foreman(foreman), _task(task) { _foreman._taskStarted(_task); }
+        ~RunningGuard() { _foreman._taskFinished(_task); }
+        RunningGuard(RunningGuard const&) = delete;
+        RunningGuard& operator=(RunningGuard const&) = delete;
+    private:
+        Foreman& _foreman;
+        wbase::Task::Ptr _task;
+    };
+
+    void _checkSlowTasks();
+    void _writeDiagnostics(std::string const& idStr, std::string const& slowTasks);
+
+    struct Running {
+        std::chrono::steady_clock::time_point start;
+        bool reported;
+    };
 
     std::shared_ptr<wdb::ChunkResourceMgr> _chunkResourceMgr;
     util::ThreadPool::Ptr _pool;
     Scheduler::Ptr _scheduler;
     mysql::MySqlConfig const _mySqlConfig;
+
+    util::Diagnostics::Ptr _diagnostics; ///< nullptr unless slow Tasks are diagnosed
+    std::chrono::seconds _slowTask{0};
+    std::mutex _runningMtx; ///< protects _running and _stopDiag
+    std::condition_variable _stopCv;
+    std::map<wbase::Task::Ptr, Running> _running; ///< Tasks running on the pool threads
+    bool _stopDiag{false};
+    std::thread _diagThread; ///< checks for slow Tasks
 };
 
 }}}  // namespace lsst::qserv::wcontrol
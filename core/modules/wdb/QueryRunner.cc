@@ -34,8 +34,10 @@
 // System headers
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <sys/resource.h>
 
 // Third-party headers
 #include <mysql/mysql.h>
@@ -61,12 +63,23 @@
 #include "util/MultiError.h"
 #include "util/StringHash.h"
 #include "util/threadSafe.h"
+#include "util/Trace.h"
 #include "wbase/Base.h"
 #include "wbase/SendChannel.h"
 #include "wdb/ChunkResource.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.QueryRunner");
+
+/// @return the CPU time, user and system, used by the calling thread, in microseconds.
+std::int64_t threadCpuUs() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return 0;
+    }
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL
+        + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
 }
 
 namespace lsst {
@@ -138,10 +151,24 @@ bool QueryRunner::runQuery() {
         return false;
     }
 
+    auto const& trace = _task->getTrace();
+    if (trace != nullptr) {
+        trace->add("queued", _task->getReceived(), util::Trace::now());
+    }
+    _cpuStart = threadCpuUs();
     _setDb();
     LOGS(_log, LOG_LVL_DEBUG, "Exec in flight for Db=" << _dbName);
-    bool connOk = _initConnection();
+    bool connOk;
+    {
+        util::Trace::Scope scope(trace, "connect");
+        connOk = _initConnection();
+    }
     if (!connOk) { return false; }
+    // Reading the status counters costs two round trips to mysqld, only
+    // traced queries pay for them.
+    if (trace != nullptr) {
+        _handlerReadsStart = _getHandlerReads();
+    }
 
     if (_task->msg->has_protocol()) {
         switch(_task->msg->protocol()) {
@@ -223,6 +250,7 @@ bool QueryRunner::_fillRows(MYSQL_RES* result, int numFields) {
             }
         }
         size += rawRow->ByteSize();
+        ++_rowsReturned;
 
         // Each element needs to be mysql-sanitized
         if (size > proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT) {
@@ -231,7 +259,9 @@ bool QueryRunner::_fillRows(MYSQL_RES* result, int numFields) {
                 return false;
             }
             LOGS(_log, LOG_LVL_DEBUG, "Large message size=" << size << ", splitting message");
+            auto sendBegin = std::chrono::steady_clock::now();
             _transmit(false);
+            _sendTime += std::chrono::steady_clock::now() - sendBegin;
             size = 0;
             _initMsg();
         }
@@ -246,6 +276,21 @@ void QueryRunner::_transmit(bool last) {
     LOGS(_log, LOG_LVL_DEBUG, "_transmit last=" << last << " " << _task->getIdStr());
     std::string resultString;
     _result->set_continues(!last);
+    auto const& trace = _task->getTrace();
+    // The spans travel in the last message, so the "transmit" span of that
+    // message cannot be among them: it is dropped. The czar sees that time
+    // as the end of its own "wait" span.
+    if (last && trace != nullptr) {
+        for (auto const& span : trace->getSpans()) {
+            auto ts = _result->add_tracespan();
+            ts->set_name(span.name);
+            ts->set_begin(span.begin);
+            ts->set_end(span.end);
+        }
+    }
+    if (last) {
+        _fillUsage();
+    }
     if (!_multiError.empty()) {
         std::string chunkId = std::to_string(_task->msg->chunkid());
         std::string msg = "Error(s) in result for chunk #" + chunkId + ": " + _multiError.toOneLineString();
@@ -253,16 +298,52 @@ void QueryRunner::_transmit(bool last) {
         LOGS(_log, LOG_LVL_ERROR, msg);
     }
     _result->SerializeToString(&resultString);
+    util::Trace::Scope scope(trace, "transmit");
     _transmitHeader(resultString);
     LOGS(_log, LOG_LVL_DEBUG, "_transmit last=" << last << " " << _task->getIdStr()
          << " resultString=" << util::prettyCharList(resultString, 5));
     if (!_cancelled) {
+        _task->addResultBytes(resultString.size());
         _task->sendChannel->sendStream(resultString.data(), resultString.size(), last);
     } else {
         LOGS(_log, LOG_LVL_DEBUG, "_transmit cancelled");
     }
 }
 
+/// @return the sum of the Handler_read_* status counters of the MySQL
+///         session, the rows mysqld read for it, or -1 on error.
+std::int64_t QueryRunner::_getHandlerReads() {
+    if (!_mysqlConn || !_mysqlConn->queryUnbuffered("SHOW SESSION STATUS LIKE 'Handler_read%'")) {
+        return -1;
+    }
+    std::int64_t reads = 0;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(_mysqlConn->getResult()))) {
+        if (row[1]) { reads += std::strtoll(row[1], nullptr, 10); }
+    }
+    _mysqlConn->freeResult();
+    return reads;
+}
+
+/// Fill the resources used by the Task in the last Result message.
+void QueryRunner::_fillUsage() {
+    proto::TaskUsage* usage = _result->mutable_usage();
+    usage->set_cpuus(threadCpuUs() - _cpuStart);
+    usage->set_chunkbytes(_task->getChunkBytes());
+    usage->set_memlockwaitus(_task->getMemLockWait());
+    if (_handlerReadsStart >= 0 && !_cancelled) {
+        // The difference includes the rows read by the first status query
+        // itself, a small constant.
+        std::int64_t reads = _getHandlerReads();
+        if (reads >= 0) {
+            usage->set_rowsexamined(reads - _handlerReadsStart);
+        }
+    }
+    usage->set_rowsreturned(_rowsReturned);
+    usage->set_bytessent(_task->getResultBytes());
+    LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " usage " << usage->ShortDebugString());
+}
+
 /// Transmit the protoHeader
 void QueryRunner::_transmitHeader(std::string& msg) {
     LOGS(_log, LOG_LVL_DEBUG, "_transmitHeader");
@@ -329,6 +410,8 @@ bool QueryRunner::_dispatchChannel() {
         throw Bug("QueryRunner: No fragments to execute in TaskMsg");
     }
     ChunkResourceRequest req(_chunkResourceMgr, m);
+    auto const& trace = _task->getTrace();
+    auto mysqlBegin = std::chrono::steady_clock::now();
 
     try {
         for(int i=0; i < m.fragment_size(); ++i) {
@@ -336,9 +419,15 @@ bool QueryRunner::_dispatchChannel() {
                 break;
             }
             proto::TaskMsg_Fragment const& fragment(m.fragment(i));
+            auto subchunkBegin = trace ? util::Trace::now() : 0;
             ChunkResource cr(req.getResourceFragment(i));
+            if (trace != nullptr) {
+                trace->add("subchunks", subchunkBegin, util::Trace::now());
+            }
             // Use query fragment as-is, funnel results.
             for(int qi=0, qe=fragment.query_size(); qi != qe; ++qi) {
+                // Includes the transmit spans of the results sent meanwhile.
+                util::Trace::Scope scope(trace, "mysql");
                 MYSQL_RES* res = _primeResult(fragment.query(qi));
                 if (!res) {
                     erred = true;
@@ -363,6 +452,8 @@ bool QueryRunner::_dispatchChannel() {
         util::Error worker_err(e.errNo(), e.errMsg());
         _multiError.push_back(worker_err);
     }
+    _task->setMysqlTime(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - mysqlBegin - _sendTime));
     if (!_cancelled) {
         // Send results.
         _transmit(true);
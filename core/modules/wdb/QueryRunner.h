@@ -35,6 +35,8 @@
 
 // System headers
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 
 // Qserv headers
@@ -87,6 +89,8 @@ private:
     void _initMsg();
     void _transmit(bool last);
     void _transmitHeader(std::string& msg);
+    std::int64_t _getHandlerReads();
+    void _fillUsage();
 
     ///< Actual task
     wbase::Task::Ptr _task;
@@ -102,6 +106,13 @@ private:
 
     std::shared_ptr<proto::ProtoHeader> _protoHeader;
     std::shared_ptr<proto::Result> _result;
+
+    // Resources used by the Task, see proto::TaskUsage.
+    std::int64_t _cpuStart{0}; ///< CPU time of the thread when the Task started
+    std::int64_t _handlerReadsStart{-1};
+    std::uint64_t _rowsReturned{0};
+    /// Time sending results while the queries run, not counted as mysql time.
+    std::chrono::steady_clock::duration _sendTime{0};
 };
 
 }}} // namespace
@@ -35,6 +35,7 @@
 // System headers
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <mutex>
 #include <sstream>
@@ -49,6 +50,8 @@
 #include "wcontrol/Foreman.h"
 #include "wsched/GroupScheduler.h"
 #include "wsched/ScanScheduler.h"
+#include "wsched/ScanStats.h"
+#include "wsched/SchedulerTuner.h"
 
 template <class Sched>
 inline Sched* other(Sched* notThis, Sched* a, Sched* b) {
@@ -120,19 +123,69 @@ void BlendScheduler::_sortScanSchedulers() {
 }
 
 
+/// Queue a Task. This is called from XrdSsi threads and should not wait
+/// for pool threads that are busy looking for a Task.
 void BlendScheduler::queCmd(util::Command::Ptr const& cmd) {
     wbase::Task::Ptr task = std::dynamic_pointer_cast<wbase::Task>(cmd);
     if (task == nullptr || task->msg == nullptr) {
         throw Bug("BlendScheduler::queueTaskAct: null task");
     }
     LOGS(_log, LOG_LVL_DEBUG, "BlendScheduler::queCmd " << task->getIdStr());
+    {
+        std::lock_guard<std::mutex> lock(_intakeMtx);
+        _intake.push_back(task);
+    }
+    ++_intakeSize;
+    _signal();
+}
 
-    std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
-    // Check for scan tables
+
+/// Record that a Task may have become ready and wake a waiting thread.
+/// If another thread holds _mx and nothing is waiting, that thread, or the
+/// next one to call getCmd, will see the change, so there is no need to wait
+/// for _mx. A thread about to wait re-checks _events after incrementing
+/// _sleepers, so either it sees this change or this sees it in _sleepers.
+void BlendScheduler::_signal() {
+    ++_events;
+    std::unique_lock<std::mutex> lock(util::CommandQueue::_mx, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        if (_sleepers == 0) return;
+        lock.lock();
+    }
+    _drainIntake();
+    lock.unlock();
+    util::CommandQueue::_cv.notify_one();
+}
+
+
+/// Give all Tasks in _intake to their sub-schedulers.
+/// Precondition util::CommandQueue::_mx must be locked.
+void BlendScheduler::_drainIntake() {
+    if (_intakeSize == 0) return;
+    std::vector<wbase::Task::Ptr> tasks;
+    {
+        std::lock_guard<std::mutex> lock(_intakeMtx);
+        tasks.swap(_intake);
+        _intakeSize -= tasks.size();
+    }
+    for (auto const& task : tasks) {
+        _queTask(task);
+    }
+}
+
+
+/// Place 'task' on the appropriate sub-scheduler.
+/// Precondition util::CommandQueue::_mx must be locked.
+void BlendScheduler::_queTask(wbase::Task::Ptr const& task) {
+    // Interactive Tasks, and any without scan tables, go to the group scheduler.
     SchedulerBase* s = nullptr;
     auto const& scanTables = task->getScanInfo().infoTables;
-    if (scanTables.size() > 0) {
+    if (!task->isInteractive() && scanTables.size() > 0) {
         int scanPriority = task->getScanInfo().scanRating;
+        if (_scanStats != nullptr) {
+            // Tables that have been measured to be slower than rated go to a slower lane.
+            scanPriority = _scanStats->adjustRating(*task, scanPriority);
+        }
         if (LOG_CHECK_LVL(_log, LOG_LVL_DEBUG)) {
             std::ostringstream ss;
             ss << "Blend chose scan for priority=" << scanPriority << " : ";
@@ -163,13 +216,13 @@ void BlendScheduler::queCmd(util::Command::Ptr const& cmd) {
         s = _group.get();
     }
     {
-        std::lock_guard<std::mutex> guard(_mapMutex);
-        _map[task.get()] = s;
+        auto& shard = _mapShard(task.get());
+        std::lock_guard<std::mutex> guard(shard.mtx);
+        shard.map[task.get()] = s;
     }
     LOGS(_log, LOG_LVL_DEBUG, "Blend queCmd " << task->getIdStr());
     s->queCmd(task);
     _infoChanged = true;
-    notify(true);
 }
 
 void BlendScheduler::commandStart(util::Command::Ptr const& cmd) {
@@ -202,29 +255,47 @@ void BlendScheduler::commandFinish(util::Command::Ptr const& cmd) {
     } else {
         LOGS(_log, LOG_LVL_ERROR, "BlendScheduler::commandFinish scheduler not found " << t->getIdStr());
     }
+    // Only the time in mysql measures the scan, sending results depends on the czar.
+    if (_scanStats != nullptr && !t->getScanInfo().infoTables.empty() && !t->getCancelled()
+        && t->getMysqlTime().count() > 0) {
+        _scanStats->record(*t, t->getMysqlTime().count() / 1.0e6, t->getResultBytes());
+    }
     LOGS(_log, LOG_LVL_DEBUG, "BlendScheduler::commandFinish " << t->getIdStr());
+    if (_tuner != nullptr && _tuner->due()) {
+        // Measure without _mx, it is only needed to change the limits.
+        auto sample = _tuner->measure(_schedulers, _schedMaxThreads);
+        std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+        _tuner->apply(_schedulers, sample);
+    }
     _infoChanged = true;
     _logChunkStatus();
 
-    // TODO: DM-4943 Add check to only call notify if resources were actually freed by commandFinish()
-    notify(true);
-
+    // TODO: DM-4943 Add check to only signal if resources were actually freed by commandFinish()
+    _signal();
 }
 
 /// @return ptr to scheduler that is tracking p
 wcontrol::Scheduler* BlendScheduler::lookup(wbase::Task::Ptr p, bool erase) {
-    std::lock_guard<std::mutex> guard(_mapMutex);
-    auto i = _map.find(p.get());
-    if (i == _map.end()) {
+    auto& shard = _mapShard(p.get());
+    std::lock_guard<std::mutex> guard(shard.mtx);
+    auto i = shard.map.find(p.get());
+    if (i == shard.map.end()) {
         LOGS(_log, LOG_LVL_ERROR, "lookup failed to find scheduler " << p->getIdStr());
         return nullptr;
     }
     auto val = i->second;
-    if (erase) _map.erase(i);
+    if (erase) shard.map.erase(i);
     return val;
 }
 
 
+BlendScheduler::MapShard& BlendScheduler::_mapShard(wbase::Task* task) {
+    // Tasks are heap allocated, the low bits carry no information.
+    auto bits = reinterpret_cast<std::uintptr_t>(task) >> 4;
+    return _mapShards[(bits ^ (bits >> 7)) % _mapShards.size()];
+}
+
+
 bool BlendScheduler::ready() {
     std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
     return _ready();
@@ -236,6 +307,7 @@ bool BlendScheduler::ready() {
 bool BlendScheduler::_ready() {
     std::ostringstream os;
     bool ready = false;
+    _drainIntake();
 
     if (_flagReorderScans) {
         _flagReorderScans = false;
@@ -243,16 +315,20 @@ bool BlendScheduler::_ready() {
     }
 
     // Get the total number of threads schedulers want reserved
-    int availableThreads = calcAvailableTheads();
     bool changed = _infoChanged.exchange(false);
-    for (auto sched : _schedulers) {
-        availableThreads = sched->applyAvailableThreads(availableThreads);
-        ready = sched->ready();
-        if (changed && LOG_CHECK_LVL(_log, LOG_LVL_DEBUG)) {
-            os << sched->getName() << "(r=" << ready << " sz=" << sched->getSize()
-               << " fl=" << sched-> getInFlight() << " avail=" << availableThreads << ") ";
+    for (bool relaxed : {false, true}) {
+        if (relaxed && (ready || !_relaxReserve)) break;
+        int availableThreads = calcAvailableTheads(relaxed);
+        for (auto sched : _schedulers) {
+            availableThreads = sched->applyAvailableThreads(availableThreads);
+            ready = sched->ready();
+            if (changed && LOG_CHECK_LVL(_log, LOG_LVL_DEBUG)) {
+                os << sched->getName() << "(r=" << ready << " sz=" << sched->getSize()
+                   << " fl=" << sched-> getInFlight() << " avail=" << availableThreads
+                   << (relaxed ? " relaxed" : "") << ") ";
+            }
+            if (ready) break;
         }
-        if (ready) break;
     }
     if (changed) {
         LOGS(_log, LOG_LVL_DEBUG, getName() << "_ready() " << os.str());
@@ -263,26 +339,41 @@ bool BlendScheduler::_ready() {
 util::Command::Ptr BlendScheduler::getCmd(bool wait) {
     std::unique_lock<std::mutex> lock(util::CommandQueue::_mx);
     if (wait) {
-        util::CommandQueue::_cv.wait(lock, [this](){return _ready();});
+        while (true) {
+            auto events = _events.load();
+            if (_ready()) break;
+            ++_sleepers;
+            if (events == _events) { // nothing changed since _ready() was evaluated
+                util::CommandQueue::_cv.wait(lock);
+            }
+            --_sleepers;
+        }
+    } else {
+        _drainIntake();
     }
 
     // Try to get a command from the schedulers
     util::Command::Ptr cmd;
-    int availableThreads = calcAvailableTheads();
-    for (auto const& sched : _schedulers) {
-        availableThreads = sched->applyAvailableThreads(availableThreads);
-        cmd = sched->getCmd(false); // no wait
-        if (cmd != nullptr) {
-            LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() using cmd from " << sched->getName());
-            wbase::Task::Ptr task = std::dynamic_pointer_cast<wbase::Task>(cmd);
-            break;
+    for (bool relaxed : {false, true}) {
+        if (relaxed && (cmd != nullptr || !_relaxReserve)) break;
+        int availableThreads = calcAvailableTheads(relaxed);
+        for (auto const& sched : _schedulers) {
+            availableThreads = sched->applyAvailableThreads(availableThreads);
+            cmd = sched->getCmd(false); // no wait
+            if (cmd != nullptr) {
+                LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() using cmd from " << sched->getName()
+                     << (relaxed ? " relaxed" : ""));
+                break;
+            }
+            // adjMax = _getAdjustedMaxThreads(adjMax, sched->getInFlight()); // DM-4943 possible alternate method
+            LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() nothing from " << sched->getName() << " avail=" << availableThreads);
         }
-        // adjMax = _getAdjustedMaxThreads(adjMax, sched->getInFlight()); // DM-4943 possible alternate method
-        LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() nothing from " << sched->getName() << " avail=" << availableThreads);
     }
     if (cmd != nullptr) {
         _infoChanged = true;
         _logChunkStatus();
+        // More Tasks may be ready, let the next waiting thread check.
+        if (_sleepers > 0) util::CommandQueue::_cv.notify_one();
     }
     // returning nullptr is acceptable.
     return cmd;
@@ -300,10 +391,16 @@ int BlendScheduler::_getAdjustedMaxThreads(int oldAdjMax, int inFlight) {
 }
 
 /// @return the number of threads that are not reserved by any sub-scheduler.
-int BlendScheduler::calcAvailableTheads() {
+/// If 'relaxed' is true, sub-schedulers with no queued Tasks only reserve
+/// threads for the Tasks they are running, not one to start the next Task.
+int BlendScheduler::calcAvailableTheads(bool relaxed) {
     int reserve = 0;
     for (auto sched : _schedulers) {
-        reserve += sched->desiredThreadReserve();
+        int desired = sched->desiredThreadReserve();
+        if (relaxed && sched->getSize() == 0) {
+            desired = std::min(desired, sched->getInFlight());
+        }
+        reserve += desired;
     }
     int available = _schedMaxThreads - reserve;
     if (available < 0) {
@@ -312,10 +409,10 @@ int BlendScheduler::calcAvailableTheads() {
     return available;
 }
 
-/// Returns the number of Tasks queued in all sub-schedulers.
+/// Returns the number of Tasks queued in all sub-schedulers and not yet handed to one.
 std::size_t BlendScheduler::getSize() const {
     std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
-    std::size_t sz = 0;
+    std::size_t sz = _intakeSize;
     for (auto sched : _schedulers) {
         sz += sched->getSize();
     }
@@ -332,6 +429,18 @@ int BlendScheduler::getInFlight() const {
     return inFlight;
 }
 
+/// Add the Tasks not yet given to a scheduler and the stats of each scheduler.
+void BlendScheduler::addStats(util::Metrics::Snapshot& stats) {
+    std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+    stats["wsched." + getName() + ".intake"] = _intakeSize;
+    for (auto const& sched : _schedulers) {
+        sched->addStats(stats);
+    }
+    if (_tuner != nullptr) {
+        _tuner->addStats(stats);
+    }
+}
+
 void BlendScheduler::_logChunkStatus() {
     if (LOG_CHECK_LVL(_log, LOG_LVL_DEBUG)) {
         std::string str;
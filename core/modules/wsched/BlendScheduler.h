@@ -24,7 +24,11 @@
 #define LSST_QSERV_WSCHED_BLENDSCHEDULER_H
 
 // System headers
-#include <map>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 // Qserv headers
 #include "wsched/SchedulerBase.h"
@@ -35,6 +39,8 @@ namespace qserv {
 namespace wsched {
     class GroupScheduler;
     class ScanScheduler;
+    class ScanStats;
+    class SchedulerTuner;
 }}} // End of forward declarations
 
 
@@ -74,6 +80,17 @@ namespace wsched {
 /// Secondly, the ScanScheduler schedulers are only allowed to advance to a new chunk
 /// if resources are available to read the chunk into memory, or if the sub-scheduler
 /// has no Tasks inFlight.
+///
+/// When the reservations leave threads idle while Tasks are queued on other
+/// sub-schedulers, setRelaxReserve(true) lets those Tasks use the threads
+/// reserved for sub-schedulers that have nothing queued.
+///
+/// Locking: util::CommandQueue::_mx is only held by pool threads looking for a Task
+/// (getCmd, ready). Each sub-scheduler has its own mutex. queCmd, called from XrdSsi
+/// threads, appends to _intake and only hands the Task to a sub-scheduler itself when
+/// _mx is free; otherwise the thread holding _mx does it before looking for a Task.
+/// Threads that have to wait for a Task are woken one at a time (see _signal()),
+/// and a woken thread that gets a Task wakes the next one.
 class BlendScheduler : public wsched::SchedulerBase {
 public:
     using Ptr = std::shared_ptr<BlendScheduler>;
@@ -98,16 +115,42 @@ public:
     int getInFlight() const override;
     bool ready() override;
     int applyAvailableThreads(int tempMax) override { return tempMax;} //< does nothing
+    void wakeUp() override { _signal(); }
+    void addStats(util::Metrics::Snapshot& stats) override;
 
     void setFlagReorderScans() { _flagReorderScans = true; }
+    /// Use measured scan times to choose ScanScheduler lanes, and record them.
+    /// Must be called before any Task is queued.
+    void setScanStats(std::shared_ptr<ScanStats> const& scanStats) { _scanStats = scanStats; }
     wcontrol::Scheduler* lookup(wbase::Task::Ptr p, bool erase=false);
-    int calcAvailableTheads();
+    int calcAvailableTheads(bool relaxed=false);
+
+    /// If true, when no sub-scheduler can start a Task within the thread
+    /// reservations, sub-schedulers with nothing queued lend the thread they
+    /// keep reserved to the others. A Task arriving on such a sub-scheduler
+    /// may then have to wait for a running Task to finish.
+    void setRelaxReserve(bool relax) { _relaxReserve = relax; }
+
+    /// Let 'tuner' adjust the thread reservations and active chunk limits of
+    /// the sub-schedulers as Tasks finish. Must be called before any Task is queued.
+    void setTuner(std::shared_ptr<SchedulerTuner> const& tuner) { _tuner = tuner; }
 
 private:
     int _getAdjustedMaxThreads(int oldAdjMax, int inFlight);
     bool _ready();
     void _sortScanSchedulers();
     void _logChunkStatus();
+    void _drainIntake();
+    void _queTask(wbase::Task::Ptr const& task);
+    void _signal();
+
+    /// Map of Tasks to the sub-scheduler tracking them, sharded so that
+    /// commandStart and commandFinish from many threads rarely collide.
+    struct MapShard {
+        std::mutex mtx;
+        std::unordered_map<wbase::Task*, SchedulerBase*> map;
+    };
+    MapShard& _mapShard(wbase::Task* task);
 
     int _schedMaxThreads; //< maximum number of threads that can run.
 
@@ -116,11 +159,19 @@ private:
     std::shared_ptr<ScanScheduler> _scanFast;
     std::vector<SchedulerBase::Ptr> _schedulers;
     bool _lastCmdFromScan{false};
-    std::map<wbase::Task*, SchedulerBase*> _map;
-    std::mutex _mapMutex;
+    std::shared_ptr<ScanStats> _scanStats;
+    std::shared_ptr<SchedulerTuner> _tuner;
+    std::array<MapShard, 16> _mapShards;
+
+    std::mutex _intakeMtx; //< protects _intake
+    std::vector<wbase::Task::Ptr> _intake; //< Tasks not yet given to a sub-scheduler.
+    std::atomic<int> _intakeSize{0};
+    std::atomic<std::uint64_t> _events{0}; //< Count of changes that may make a Task ready.
+    std::atomic<int> _sleepers{0}; //< Threads waiting, or about to wait, on _cv.
 
     std::atomic<bool> _flagReorderScans{false};
     std::atomic<bool> _infoChanged{true}; //< Used to limit debug logging.
+    std::atomic<bool> _relaxReserve{false};
 };
 
 }}} // namespace lsst::qserv::wsched
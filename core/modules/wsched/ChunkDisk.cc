@@ -35,6 +35,7 @@
 
 // Qserv headers
 #include "util/IterableFormatter.h"
+#include "util/Trace.h"
 
 /// ChunkDisk is a data structure that tracks a queue of pending tasks
 /// for a disk, and the state of a chunkId-ordered scan on a disk
@@ -65,6 +66,17 @@
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wsched.ChunkDisk");
+
+/// @return the tables MemMan needs to lock for 'task'.
+std::vector<lsst::qserv::memman::TableInfo> tablesForTask(lsst::qserv::wbase::Task& task,
+        lsst::qserv::memman::TableInfo::LockType lckOptTbl,
+        lsst::qserv::memman::TableInfo::LockType lckOptIdx) {
+    std::vector<lsst::qserv::memman::TableInfo> tblVect;
+    for (auto const& tbl : task.getScanInfo().infoTables) {
+        tblVect.emplace_back(tbl.db + "/" + tbl.table, lckOptTbl, lckOptIdx);
+    }
+    return tblVect;
+}
 }
 
 namespace lsst {
@@ -125,6 +137,9 @@ void ChunkDisk::enqueue(wbase::Task::Ptr const& a) {
 /// The purpose here is that the best time to change priority or switch to doing
 /// something else is when all the Tasks for the current chunkId have finished.
 bool ChunkDisk::nextTaskDifferentChunkId() {
+    if (_residentTask != nullptr) {
+        return _residentTask->getChunkId() != _lastChunk;
+    }
     auto const& topTask = _activeTasks.top();
     if (topTask == nullptr) return true; // going to switch to pending, new chunkId
     return topTask->getChunkId() != _lastChunk;
@@ -132,6 +147,11 @@ bool ChunkDisk::nextTaskDifferentChunkId() {
 
 
 /// Return true if this disk is ready to provide a Task from its queue.
+void ChunkDisk::setChunkFilter(std::function<bool(int)> const& mayStart) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    _mayStartChunk = mayStart;
+}
+
 bool ChunkDisk::ready(bool useFlexibleLock) {
     std::lock_guard<std::mutex> lock(_queueMutex);
     return _ready(useFlexibleLock);
@@ -151,6 +171,9 @@ bool ChunkDisk::_ready(bool useFlexibleLock) {
         }
     };
 
+    // A Task whose tables another scheduler keeps resident was already granted.
+    if (_residentTask != nullptr) { return true; }
+
     // If the current queue is empty and the pending is not,
     // Switch to the pending queue.
     if (_activeTasks.empty() && !_pendingTasks.empty()) {
@@ -166,20 +189,29 @@ bool ChunkDisk::_ready(bool useFlexibleLock) {
         memman::TableInfo::LockType lckOptTbl = memman::TableInfo::LockType::MUSTLOCK;
         memman::TableInfo::LockType lckOptIdx = memman::TableInfo::LockType::NOLOCK;
         if (useFlexibleLock) lckOptTbl = memman::TableInfo::LockType::FLEXIBLE;
-        auto scanInfo = task-> getScanInfo();
         auto chunkId = task->getChunkId();
-        std::vector<memman::TableInfo> tblVect;
-        for (auto const& tbl : scanInfo.infoTables) {
-            memman::TableInfo ti(tbl.db + "/" + tbl.table, lckOptTbl, lckOptIdx);
-            tblVect.push_back(ti);
+        // Don't wait on the disk while the tables are being read in the background.
+        if (_prefetchBusy(chunkId)) {
+            return false;
         }
+        std::vector<memman::TableInfo> tblVect = tablesForTask(*task, lckOptTbl, lckOptIdx);
         // If tblVect is empty, we should get the empty handle
+        auto lockBegin = task->getTrace() ? util::Trace::now() : 0;
+        task->startMemLock();
         memman::MemMan::Handle handle = _memMan->lock(tblVect, chunkId);
+        if (task->getTrace() != nullptr && handle != memman::MemMan::HandleType::INVALID) {
+            task->getTrace()->add("memLock", lockBegin, util::Trace::now());
+        }
         if (handle == 0) {
             switch (errno) {
             case ENOMEM:
                 logMemManRes(true, "ENOMEM", tblVect);
-                return false;
+                // Memory held for a chunk further along the scan is better used now.
+                if (_prefetchRelease()) {
+                    LOGS(_log, LOG_LVL_DEBUG, "ChunkDisk released prefetch for chunk " << chunkId);
+                }
+                // Meanwhile, run a later chunk whose tables are already locked.
+                return _takeResident(lckOptTbl, lckOptIdx);
             case ENOENT:
                 LOGS(_log, LOG_LVL_ERROR, "_memMgr->lock errno=ENOENT chunk not found " << task->getIdStr());
                 // Not sure if this is the best course of action, but it should just need one
@@ -195,15 +227,75 @@ bool ChunkDisk::_ready(bool useFlexibleLock) {
             }
         }
         task->setMemHandle(handle);
+        task->endMemLock(_memMan->getStatus(handle).bytesLock);
         logMemManRes(false, "got handle", tblVect);
         // Once the chunk has been granted, everything equal and below must go on pending.
         // Otherwise there's a risk of a Task with lower or same chunkId getting in front
         // of this one and needing the resources this Task has been promised.
+        bool newChunk = (_lastChunk != chunkId);
         _lastChunk = chunkId;
+        if (newChunk) {
+            _prefetchUsed(chunkId);
+            _queuePrefetch();
+        }
     }
     return true;
 }
 
+/// Precondition: _queueMutex must be locked.
+/// The Task at the top of _activeTasks could not get memory. If the tables of
+/// a later chunk in _activeTasks are already locked, by this or another
+/// scheduler, locking them again costs nothing, so grant that Task instead.
+/// Only the RESIDENT_PROBE lowest chunks after the top are checked, with one
+/// Task standing for each chunk, as residency checks take the memman mutex.
+/// _lastChunk is left alone so that the scan order is unchanged.
+/// @return true if a Task was granted and set aside in _residentTask.
+bool ChunkDisk::_takeResident(memman::TableInfo::LockType lckOptTbl,
+                              memman::TableInfo::LockType lckOptIdx) {
+    using TaskIter = std::vector<wbase::Task::Ptr>::iterator;
+    int topChunk = _activeTasks.top()->getChunkId();
+    std::vector<TaskIter> probe; // sorted by chunkId, one per chunkId
+    for (auto iter = _activeTasks._tasks.begin(); iter != _activeTasks._tasks.end(); ++iter) {
+        int chunkId = (*iter)->getChunkId();
+        if (chunkId == topChunk) continue;
+        auto pos = std::lower_bound(probe.begin(), probe.end(), chunkId,
+            [](TaskIter const& t, int id) { return (*t)->getChunkId() < id; });
+        if (pos != probe.end() && (**pos)->getChunkId() == chunkId) continue;
+        if (pos == probe.end() && probe.size() >= RESIDENT_PROBE) continue;
+        probe.insert(pos, iter);
+        if (probe.size() > RESIDENT_PROBE) probe.pop_back();
+    }
+    auto best = _activeTasks._tasks.end();
+    for (auto const& iter : probe) {
+        int chunkId = (*iter)->getChunkId();
+        if (_mayStartChunk && !_mayStartChunk(chunkId)) continue;
+        auto tblVect = tablesForTask(**iter, lckOptTbl, lckOptIdx);
+        if (!tblVect.empty() && _memMan->isResident(tblVect, chunkId)) {
+            best = iter;
+            break;
+        }
+    }
+    if (best == _activeTasks._tasks.end()) {
+        return false;
+    }
+    auto task = *best;
+    auto tblVect = tablesForTask(*task, lckOptTbl, lckOptIdx);
+    task->startMemLock();
+    memman::MemMan::Handle handle = _memMan->lock(tblVect, task->getChunkId());
+    if (handle == memman::MemMan::HandleType::INVALID) {
+        return false; // The other scheduler just released them.
+    }
+    task->setMemHandle(handle);
+    task->endMemLock(_memMan->getStatus(handle).bytesLock);
+    _activeTasks._tasks.erase(best);
+    _activeTasks.heapify();
+    _residentTask = task;
+    ++_residentHits;
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkDisk resident chunk=" << task->getChunkId()
+         << " ahead of chunk=" << topChunk << " hits=" << _residentHits);
+    return true;
+}
+
 /// Return a Task that is ready to run, if available.
 wbase::Task::Ptr ChunkDisk::getTask(bool useFlexibleLock) {
     LOGS(_log, LOG_LVL_DEBUG, "ChunkDisk::getTask start");
@@ -212,6 +304,13 @@ wbase::Task::Ptr ChunkDisk::getTask(bool useFlexibleLock) {
         LOGS(_log, LOG_LVL_DEBUG, "ChunkDisk denying task");
         return nullptr;
     }
+    if (_residentTask != nullptr) {
+        wbase::Task::Ptr task;
+        std::swap(task, _residentTask);
+        LOGS(_log, LOG_LVL_DEBUG, "ChunkDisk getTask resident chunk=" << task->getChunkId()
+             << " " << task->getIdStr());
+        return task;
+    }
     // Check the chunkId.
     auto task = _activeTasks.pop();
     int chunkId = task->getChunkId();
@@ -239,12 +338,175 @@ bool ChunkDisk::empty() const {
 
 /// Precondition: _queueMutex must be locked
 bool ChunkDisk::_empty() const {
-    return _activeTasks.empty() && _pendingTasks.empty();
+    return _activeTasks.empty() && _pendingTasks.empty() && _residentTask == nullptr;
 }
 
 std::size_t ChunkDisk::getSize() const {
     std::lock_guard<std::mutex> lock(_queueMutex);
-    return _activeTasks._tasks.size() + _pendingTasks._tasks.size();
+    return _activeTasks._tasks.size() + _pendingTasks._tasks.size() + (_residentTask ? 1 : 0);
+}
+
+ChunkDisk::~ChunkDisk() {
+    setPrefetch(false, nullptr);
+}
+
+void ChunkDisk::setPrefetch(bool enable, std::function<void()> const& notifyFunc) {
+    std::thread oldThread;
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMtx);
+        _prefetchNotify = notifyFunc;
+        if (enable == _prefetchEnabled) {
+            return;
+        }
+        _prefetchEnabled = enable;
+        if (enable) {
+            _prefetchStop = false;
+            _prefetchThread = std::thread(&ChunkDisk::_prefetchLoop, this);
+            return;
+        }
+        _prefetchStop = true;
+        _prefetchCv.notify_all();
+        std::swap(oldThread, _prefetchThread);
+    }
+    if (oldThread.joinable()) {
+        oldThread.join();
+    }
+    _prefetchRelease();
+}
+
+/// @return true if the tables for 'chunkId' are being locked in the background.
+bool ChunkDisk::_prefetchBusy(int chunkId) {
+    std::lock_guard<std::mutex> lock(_prefetchMtx);
+    return _pfChunk == chunkId && _pfState == PrefetchState::LOCKING && !_pfStale;
+}
+
+/// A Task on 'chunkId' has its own handle now, so a prefetch handle for the
+/// same chunk is no longer needed. The files stay locked through the Task's
+/// handle, as MemMan shares locked files between handles.
+void ChunkDisk::_prefetchUsed(int chunkId) {
+    std::lock_guard<std::mutex> lock(_prefetchMtx);
+    if (_pfChunk != chunkId) {
+        return;
+    }
+    if (_pfState == PrefetchState::DONE && _pfHandle != memman::MemMan::HandleType::INVALID) {
+        ++_pfHits;
+        LOGS(_log, LOG_LVL_DEBUG, "ChunkDisk prefetch used chunk=" << chunkId << " hits=" << _pfHits);
+        _memMan->unlock(_pfHandle);
+    }
+    _pfHandle = memman::MemMan::HandleType::INVALID;
+    _pfState = PrefetchState::NONE;
+    _pfChunk = -1;
+}
+
+/// Drop the current prefetch, unlocking whatever it holds.
+/// @return true if memory was released, or will be when the lock in progress completes.
+bool ChunkDisk::_prefetchRelease() {
+    std::lock_guard<std::mutex> lock(_prefetchMtx);
+    bool released = false;
+    switch (_pfState) {
+    case PrefetchState::LOCKING:
+        _pfStale = true;
+        return true;
+    case PrefetchState::DONE:
+        if (_pfHandle != memman::MemMan::HandleType::INVALID) {
+            _memMan->unlock(_pfHandle);
+            released = true;
+        }
+        break;
+    default:
+        break;
+    }
+    _pfHandle = memman::MemMan::HandleType::INVALID;
+    _pfState = PrefetchState::NONE;
+    _pfChunk = -1;
+    return released;
+}
+
+/// Precondition: _queueMutex must be locked.
+/// Ask the prefetch thread to lock the tables of the chunk the scan will
+/// reach after _lastChunk.
+void ChunkDisk::_queuePrefetch() {
+    // Find the lowest chunkId above the current one, wrapping around to
+    // the pending queue at the end of the scan.
+    wbase::Task::Ptr next;
+    for (auto const& t : _activeTasks._tasks) {
+        if (t->getChunkId() > _lastChunk && (!next || t->getChunkId() < next->getChunkId())) {
+            next = t;
+        }
+    }
+    if (!next) {
+        next = _pendingTasks.top();
+    }
+    std::lock_guard<std::mutex> lock(_prefetchMtx);
+    if (!_prefetchEnabled || !next || next->getChunkId() == _pfChunk) {
+        return;
+    }
+    if (_pfState == PrefetchState::LOCKING) {
+        _pfStale = true; // The thread unlocks it when done, then picks up the new request.
+    } else if (_pfState == PrefetchState::DONE && _pfHandle != memman::MemMan::HandleType::INVALID) {
+        _memMan->unlock(_pfHandle);
+    }
+    _pfHandle = memman::MemMan::HandleType::INVALID;
+    _pfChunk = next->getChunkId();
+    _pfTables = tablesForTask(*next, memman::TableInfo::LockType::MUSTLOCK,
+                              memman::TableInfo::LockType::NOLOCK);
+    if (_pfState != PrefetchState::LOCKING) {
+        _pfState = PrefetchState::QUEUED;
+    }
+    _prefetchCv.notify_one();
+}
+
+/// Body of the prefetch thread. Only locks ahead while at most half of the
+/// MemMan memory is in use, so that prefetching never keeps a scan on another
+/// disk or scheduler from reading its current chunk. Otherwise the tables are
+/// only read ahead.
+void ChunkDisk::_prefetchLoop() {
+    std::unique_lock<std::mutex> lock(_prefetchMtx);
+    while (!_prefetchStop) {
+        if (_pfState != PrefetchState::QUEUED) {
+            _prefetchCv.wait(lock);
+            continue;
+        }
+        int chunkId = _pfChunk;
+        std::vector<memman::TableInfo> tables = _pfTables;
+        _pfState = PrefetchState::LOCKING;
+        _pfStale = false;
+        lock.unlock();
+
+        memman::MemMan::Handle handle = memman::MemMan::HandleType::INVALID;
+        auto stats = _memMan->getStatistics();
+        if (!tables.empty() && (stats.bytesLocked + stats.bytesReserved) * 2 <= stats.bytesLockMax) {
+            handle = _memMan->lock(tables, chunkId);
+        } else if (!tables.empty()) {
+            // Too little memory to lock ahead, so only have the kernel start
+            // reading the files. Nothing is held, there is no handle to keep.
+            for (auto& tbl : tables) {
+                tbl.theData = memman::TableInfo::LockType::ADVISE;
+            }
+            _memMan->lock(tables, chunkId);
+        }
+        LOGS(_log, LOG_LVL_DEBUG, "ChunkDisk prefetch chunk=" << chunkId << " handle=" << handle);
+
+        lock.lock();
+        if (_pfStale || _pfChunk != chunkId) {
+            // Not wanted anymore, a newer request may be waiting in _pfChunk.
+            if (handle != memman::MemMan::HandleType::INVALID) {
+                _memMan->unlock(handle);
+            }
+            _pfState = (_pfChunk != chunkId && _pfChunk >= 0) ? PrefetchState::QUEUED
+                                                               : PrefetchState::NONE;
+            _pfStale = false;
+            continue;
+        }
+        _pfHandle = handle;
+        _pfState = PrefetchState::DONE;
+        auto notifyFunc = _prefetchNotify;
+        lock.unlock();
+        if (notifyFunc) {
+            notifyFunc();
+        }
+        lock.lock();
+    }
 }
 
 }}} // namespace lsst::qserv::wsched
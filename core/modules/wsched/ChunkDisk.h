@@ -32,8 +32,11 @@
 
 // System headers
 #include <algorithm>
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 // Qserv headers
@@ -54,6 +57,19 @@ public:
     ChunkDisk(memman::MemMan::Ptr const& memMan) : _memMan{memMan} {}
     ChunkDisk(ChunkDisk const&) = delete;
     ChunkDisk& operator=(ChunkDisk const&) = delete;
+    ~ChunkDisk();
+
+    /// Enable or disable locking the tables of the next chunk in the queue on a
+    /// background thread while Tasks on the current chunk run.
+    /// @param notifyFunc is called, without any ChunkDisk mutex held, whenever
+    ///        a prefetch completes so that waiting schedulers check again.
+    void setPrefetch(bool enable, std::function<void()> const& notifyFunc);
+
+    /// Set the check made before a Task of another chunk is granted ahead of
+    /// the top of the queue because its tables are resident, so that a
+    /// scheduler can apply its own limits, such as the number of active chunks.
+    /// By default any chunk may be started.
+    void setChunkFilter(std::function<bool(int chunkId)> const& mayStart);
 
     // Queue management
     void enqueue(wbase::Task::Ptr const& a);
@@ -95,6 +111,16 @@ public:
 private:
     bool _empty() const;
     bool _ready(bool useFlexibleLock);
+    bool _takeResident(memman::TableInfo::LockType lckOptTbl,
+                       memman::TableInfo::LockType lckOptIdx);
+
+    // Prefetch helpers, see setPrefetch().
+    enum class PrefetchState {NONE, QUEUED, LOCKING, DONE};
+    bool _prefetchBusy(int chunkId);
+    void _prefetchUsed(int chunkId);
+    bool _prefetchRelease();
+    void _queuePrefetch();
+    void _prefetchLoop();
 
     mutable std::mutex _queueMutex;
     MinHeap _activeTasks;
@@ -103,6 +129,25 @@ private:
     memman::MemMan::Ptr _memMan;
     mutable std::mutex _inflightMutex;
     bool _resourceStarved{false};
+    wbase::Task::Ptr _residentTask; ///< Granted out of order, its tables were resident.
+    int _residentHits{0}; ///< Number of Tasks granted out of order.
+    std::function<bool(int)> _mayStartChunk; ///< See setChunkFilter().
+    static std::size_t const RESIDENT_PROBE = 4; ///< Chunks _takeResident() checks.
+
+    // Prefetch of the next chunk. Lock order is _queueMutex before _prefetchMtx,
+    // and the prefetch thread never takes _queueMutex.
+    std::mutex _prefetchMtx;
+    std::condition_variable _prefetchCv;
+    std::thread _prefetchThread;
+    std::function<void()> _prefetchNotify;
+    bool _prefetchEnabled{false};
+    bool _prefetchStop{false};
+    PrefetchState _pfState{PrefetchState::NONE};
+    int _pfChunk{-1}; ///< chunkId being prefetched.
+    std::vector<memman::TableInfo> _pfTables; ///< tables to lock for _pfChunk.
+    memman::MemMan::Handle _pfHandle{memman::MemMan::HandleType::INVALID};
+    bool _pfStale{false}; ///< Result of the lock in progress is not wanted anymore.
+    int _pfHits{0}; ///< Number of chunks whose tables were prefetched before use.
 };
 
 }}} // namespace
@@ -33,6 +33,7 @@
 #include "wsched/GroupScheduler.h"
 
 // System headers
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 #include <sstream>
@@ -46,6 +47,17 @@
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wsched.GroupScheduler");
+
+using lsst::qserv::wsched::GroupQueue;
+
+/// Heap order for GroupScheduler::_deadlineQueue, earliest deadline at the front.
+/// Groups with equal deadlines are kept in the order they were created.
+bool laterDeadline(GroupQueue::Ptr const& a, GroupQueue::Ptr const& b) {
+    if (a->getDeadline() != b->getDeadline()) {
+        return a->getDeadline() > b->getDeadline();
+    }
+    return a->getSeq() > b->getSeq();
+}
 }
 
 namespace lsst {
@@ -53,12 +65,17 @@ namespace qserv {
 namespace wsched {
 
 
+constexpr std::int64_t GroupQueue::NO_CHUNK_KEY;
+
 GroupQueue::GroupQueue(int maxAccepted, wbase::Task::Ptr const& task) : _maxAccepted{maxAccepted} {
     assert(task != nullptr);
     _hasChunkId = task->msg->has_chunkid();
     if (_hasChunkId) {
         _chunkId = task->msg->chunkid();
     }
+    _hasDeadline = task->hasDeadline();
+    _deadline = task->getDeadline();
+    _created = std::chrono::steady_clock::now();
     assert(queTask(task));
 }
 
@@ -83,6 +100,10 @@ bool GroupQueue::queTask(wbase::Task::Ptr const& task) {
     return false;
 }
 
+std::int64_t GroupQueue::keyFor(wbase::Task::Ptr const& task) {
+    return task->msg->has_chunkid() ? task->msg->chunkid() : NO_CHUNK_KEY;
+}
+
 /// Get a command off the queue. If no message is available, wait until one is.
 wbase::Task::Ptr GroupQueue::getTask() {
     auto task = _tasks.front();
@@ -103,25 +124,67 @@ void GroupScheduler::queCmd(util::Command::Ptr const& cmd) {
         return;
     }
     std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
-    // Start at the front of the queue looking for a group to accept the task.
-    bool queued = false;
-    for(auto iter = _queue.begin(), end = _queue.end(); iter != end && !queued; ++iter) {
-        GroupQueue::Ptr group = *iter;
-        if (group->queTask(t)) {
-            queued = true;
+    if (t->hasDeadline()) {
+        _queDeadlineTask(t);
+    } else {
+        // Only the newest group for a chunk can have room, older ones are full.
+        auto key = GroupQueue::keyFor(t);
+        auto iter = _openGroups.find(key);
+        if (iter != _openGroups.end() && iter->second->queTask(t)) {
+            if (iter->second->isFull()) {
+                _openGroups.erase(iter);
+            }
+        } else {
+            // No group for this chunk can take the task, need to make a new group.
+            auto group = std::make_shared<GroupQueue>(_maxGroupSize, t);
+            _queue.push_back(group);
+            if (group->isFull()) {
+                _openGroups.erase(key);
+            } else {
+                _openGroups[key] = group;
+            }
         }
     }
-    if (!queued) {
-        // Wasn't inserted into an existing group, need to make a new group.
-        auto group = std::make_shared<GroupQueue>(_maxGroupSize, t);
-        _queue.push_back(group);
-    }
     auto uqCount = _incrCountForUserQuery(t->getQueryId());
-    LOGS(_log, LOG_LVL_WARN, getName() << " queCmd " << t->getIdStr()
+    LOGS(_log, LOG_LVL_DEBUG, getName() << " queCmd " << t->getIdStr()
          << " uqCount=" << uqCount);
     util::CommandQueue::_cv.notify_all();
 }
 
+/// Queue a Task with a deadline. It may join the newest group for its chunk
+/// if that group's deadline is not later, otherwise it starts a new group.
+/// Precondition: _mx must be locked.
+void GroupScheduler::_queDeadlineTask(wbase::Task::Ptr const& t) {
+    auto key = GroupQueue::keyFor(t);
+    auto iter = _openDeadlineGroups.find(key);
+    if (iter != _openDeadlineGroups.end()
+        && iter->second->getDeadline() <= t->getDeadline() && iter->second->queTask(t)) {
+        if (iter->second->isFull()) {
+            _openDeadlineGroups.erase(iter);
+        }
+        return;
+    }
+    auto group = std::make_shared<GroupQueue>(_maxGroupSize, t);
+    group->setSeq(++_deadlineSeq);
+    _deadlineQueue.push_back(group);
+    std::push_heap(_deadlineQueue.begin(), _deadlineQueue.end(), laterDeadline);
+    if (group->isFull()) {
+        _openDeadlineGroups.erase(key);
+    } else {
+        _openDeadlineGroups[key] = group;
+    }
+}
+
+
+/// @return true if the next Task should come from _deadlineQueue.
+/// Precondition: _mx must be locked and at least one queue must not be empty.
+bool GroupScheduler::_useDeadlineQueue() {
+    if (_deadlineQueue.empty()) return false;
+    if (_queue.empty()) return true;
+    return _deadlineQueue.front()->getDeadline() <= _queue.front()->getCreated() + _agingLimit;
+}
+
+
 /// Return a Task from the front of the queue. If no message is available, wait until one is.
 util::Command::Ptr GroupScheduler::getCmd(bool wait)  {
     std::unique_lock<std::mutex> lock(util::CommandQueue::_mx);
@@ -130,10 +193,30 @@ util::Command::Ptr GroupScheduler::getCmd(bool wait)  {
     } else if (!_ready()) {
         return nullptr;
     }
-    auto group = _queue.front();
+    bool useDeadline = _useDeadlineQueue();
+    auto group = useDeadline ? _deadlineQueue.front() : _queue.front();
+    auto& openGroups = useDeadline ? _openDeadlineGroups : _openGroups;
     auto task = group->getTask();
     if (group->isEmpty()) {
-        _queue.pop_front();
+        if (useDeadline) {
+            std::pop_heap(_deadlineQueue.begin(), _deadlineQueue.end(), laterDeadline);
+            _deadlineQueue.pop_back();
+        } else {
+            _queue.pop_front();
+        }
+        // A group that is not full may still be open, new Tasks for the
+        // chunk must go into a new group.
+        auto iter = openGroups.find(group->getKey());
+        if (iter != openGroups.end() && iter->second == group) {
+            openGroups.erase(iter);
+        }
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (task->hasDeadline() && task->getDeadline() < now) {
+        ++_deadlineMisses;
+        LOGS(_log, LOG_LVL_WARN, getName() << " deadline missed by "
+             << std::chrono::duration_cast<std::chrono::milliseconds>(now - task->getDeadline()).count()
+             << "ms " << task->getIdStr() << " misses=" << _deadlineMisses);
     }
     ++_inFlight; // Considered inFlight as soon as it's off the queue.
     _decrCountForUserQuery(task->getQueryId());
@@ -155,7 +238,19 @@ GroupScheduler::GroupScheduler(std::string const& name, int maxThreads, int maxR
 
 bool GroupScheduler::empty() {
     std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
-    return _queue.empty();
+    return _queue.empty() && _deadlineQueue.empty();
+}
+
+
+void GroupScheduler::addStats(util::Metrics::Snapshot& stats) {
+    SchedulerBase::addStats(stats);
+    stats["wsched." + getName() + ".deadlineMisses"] = _deadlineMisses;
+}
+
+
+void GroupScheduler::setAgingLimit(std::chrono::milliseconds agingLimit) {
+    std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+    _agingLimit = agingLimit;
 }
 
 /// Returns true when a Task is ready to run.
@@ -167,14 +262,14 @@ bool GroupScheduler::ready() {
 /// Precondition: _mx must be locked.
 bool GroupScheduler::_ready() {
     // GroupScheduler is not limited by resource availability.
-    return !_queue.empty() && _inFlight < maxInFlight();
+    return (!_queue.empty() || !_deadlineQueue.empty()) && _inFlight < maxInFlight();
 }
 
 
 /// Return the number of groups (not Tasks) in the queue.
 std::size_t GroupScheduler::getSize() const {
     std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
-    return _queue.size();
+    return _queue.size() + _deadlineQueue.size();
 }
 
 }}} // namespace lsst::qserv::wsched
@@ -23,6 +23,14 @@
 #ifndef LSST_QSERV_WSCHED_GROUPSCHEDULER_H
 #define LSST_QSERV_WSCHED_GROUPSCHEDULER_H
 
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
 // Qserv headers
 #include "util/EventThread.h"
 #include "wsched/SchedulerBase.h"
@@ -42,10 +50,32 @@ public:
     wbase::Task::Ptr getTask();
     wbase::Task::Ptr peekTask();
     bool isEmpty() { return _tasks.empty(); }
+    /// @return true if the group will not accept any more Tasks.
+    bool isFull() const { return _accepted >= _maxAccepted; }
+    /// @return the key used to index open groups, see keyFor().
+    std::int64_t getKey() const { return _hasChunkId ? _chunkId : NO_CHUNK_KEY; }
+
+    /// @return the key of the group that would accept 'task'. Tasks without
+    ///         a chunk id share NO_CHUNK_KEY, which is outside the int32 range.
+    static std::int64_t keyFor(wbase::Task::Ptr const& task);
+    static constexpr std::int64_t NO_CHUNK_KEY = INT64_MIN;
+
+    /// The deadline of the group is the deadline of its first Task, see
+    /// GroupScheduler::queCmd().
+    bool hasDeadline() const { return _hasDeadline; }
+    std::chrono::steady_clock::time_point getDeadline() const { return _deadline; }
+    std::chrono::steady_clock::time_point getCreated() const { return _created; }
+    /// Order of creation, breaks ties between equal deadlines.
+    void setSeq(std::uint64_t seq) { _seq = seq; }
+    std::uint64_t getSeq() const { return _seq; }
 
 protected:
     bool _hasChunkId{false};
     int _chunkId{0};
+    bool _hasDeadline{false};
+    std::chrono::steady_clock::time_point _deadline;
+    std::chrono::steady_clock::time_point _created;
+    std::uint64_t _seq{0};
     int _maxAccepted{1}; ///< maximum number of commands to accept in this object.
     int _accepted{0}; ///< number of commands accepted.
     std::deque<wbase::Task::Ptr> _tasks;
@@ -54,6 +84,15 @@ protected:
 /// GroupScheduler -- A scheduler that is a cross between FIFO and shared scan.
 /// Tasks are ordered as they come in, except that queries for the
 /// same chunks are grouped together.
+/// Groups are kept in a FIFO. At most one group per chunk can still accept
+/// Tasks (the newest one), and it is found through _openGroups, so queuing
+/// and dequeuing are O(1) no matter how many groups are waiting.
+///
+/// Tasks with a deadline from the czar are kept apart, in groups ordered
+/// earliest deadline first. A Task only joins a group with an earlier or
+/// equal deadline, so a group's deadline is that of its first Task. Groups
+/// without a deadline age: the FIFO front is treated as if its deadline were
+/// its creation time plus the aging limit, so deadline Tasks cannot starve it.
 class GroupScheduler : public SchedulerBase {
 public:
     typedef std::shared_ptr<GroupScheduler> Ptr;
@@ -72,12 +111,29 @@ public:
     // SchedulerBase overrides
     bool ready() override;
     std::size_t getSize() const override;
+    void addStats(util::Metrics::Snapshot& stats) override;
 
+    /// Set how long a group without a deadline may be passed over by groups
+    /// with a deadline.
+    void setAgingLimit(std::chrono::milliseconds agingLimit);
+    /// @return the number of Tasks started after their deadline.
+    int getDeadlineMisses() const { return _deadlineMisses; }
 
 private:
     bool _ready();
+    void _queDeadlineTask(wbase::Task::Ptr const& task);
+    bool _useDeadlineQueue();
 
     std::deque<GroupQueue::Ptr> _queue;
+    /// Groups in _queue that are not full, by GroupQueue::getKey().
+    std::unordered_map<std::int64_t, GroupQueue::Ptr> _openGroups;
+    /// Groups of Tasks with deadlines, a heap with the earliest deadline at the front.
+    std::vector<GroupQueue::Ptr> _deadlineQueue;
+    /// Groups in _deadlineQueue that are not full, by GroupQueue::getKey().
+    std::unordered_map<std::int64_t, GroupQueue::Ptr> _openDeadlineGroups;
+    std::uint64_t _deadlineSeq{0};
+    std::chrono::milliseconds _agingLimit{std::chrono::seconds(60)};
+    std::atomic<int> _deadlineMisses{0};
     int _maxGroupSize{1};
 };
 
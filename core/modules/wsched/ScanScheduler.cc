@@ -60,6 +60,12 @@ ScanScheduler::ScanScheduler(std::string const& name, int maxThreads, int maxRes
     : SchedulerBase{name, maxThreads, maxReserve, priority},
       _memMan{memMan}, _minRating{minRating}, _maxRating{maxRating} {
     _disk = std::make_shared<ChunkDisk>(_memMan);
+    // Tasks granted out of order, while _mx is held, must respect the same
+    // limits that _ready() applies to the top of the queue.
+    _disk->setChunkFilter([this](int chunkId) {
+        if (_inFlight >= maxInFlight()) return false;
+        return isChunkActive(chunkId) || getActiveChunkCount() < getMaxActiveChunks();
+    });
     assert(_minRating <= _maxRating);
 }
 
@@ -205,6 +211,18 @@ void ScanScheduler::queCmd(util::Command::Ptr const& cmd) {
 }
 
 
+void ScanScheduler::setPrefetch(bool enable) {
+    _disk->setPrefetch(enable, [this]() {
+        // Tasks on the prefetched chunk may be able to start now.
+        if (_blendScheduler != nullptr) {
+            _blendScheduler->wakeUp();
+        } else {
+            wakeUp();
+        }
+    });
+}
+
+
 void ScanScheduler::logMemManStats() {
     auto s = _memMan->getStatistics();
     LOGS(_log, LOG_LVL_DEBUG, "bMax=" << s.bytesLockMax
@@ -216,6 +234,10 @@ void ScanScheduler::logMemManStats() {
          << " FlxF=" << s.numFlexFiles
          << " FlxLck=" << s.numFlexLock
          << " lckCalls=" << s.numLocks
+         << " bAdvised=" << s.bytesAdvised
+         << " advF=" << s.numAdvised
+         << " majFlt=" << s.numMajFaults
+         << " minFlt=" << s.numMinFaults
          << " errs=" << s.numErrors);
 }
 
@@ -80,6 +80,10 @@ public:
 
     void logMemManStats();
 
+    /// Lock the tables of the next chunk on a background thread while
+    /// Tasks on the current chunk run. See ChunkDisk::setPrefetch().
+    void setPrefetch(bool enable);
+
 private:
     bool _ready();
     std::shared_ptr<ChunkDisk> _disk; //< Constrains access to files.
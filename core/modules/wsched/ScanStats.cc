@@ -0,0 +1,212 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wsched/ScanStats.h"
+
+// System headers
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/ScanTableInfo.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wsched.ScanStats");
+
+/// Weight of a new measurement in the moving averages.
+double const ALPHA = 0.2;
+
+char const* const FILE_HEADER = "# qserv scan stats v1: tables chunk count sec bytes";
+}
+
+namespace lsst {
+namespace qserv {
+namespace wsched {
+
+int const ScanStats::TABLE_CHUNK;
+
+ScanStats::ScanStats(std::string const& path, double fastMaxSec, double mediumMaxSec)
+    : _path(path), _fastMaxSec(fastMaxSec), _mediumMaxSec(mediumMaxSec) {
+    if (!_path.empty()) {
+        load();
+    }
+}
+
+
+ScanStats::~ScanStats() {
+    if (!_path.empty() && _unsaved > 0) {
+        save();
+    }
+}
+
+
+std::string ScanStats::tableKey(wbase::Task& task) {
+    std::vector<std::string> names;
+    for (auto const& tbl : task.getScanInfo().infoTables) {
+        names.push_back(tbl.db + "." + tbl.table);
+    }
+    std::sort(names.begin(), names.end());
+    std::string key;
+    for (auto const& name : names) {
+        if (!key.empty()) key += ",";
+        key += name;
+    }
+    return key;
+}
+
+
+void ScanStats::_update(Entry& entry, double sec, double bytes) {
+    if (entry.count == 0) {
+        entry.sec = sec;
+        entry.bytes = bytes;
+    } else {
+        entry.sec += ALPHA * (sec - entry.sec);
+        entry.bytes += ALPHA * (bytes - entry.bytes);
+    }
+    ++entry.count;
+}
+
+
+void ScanStats::record(wbase::Task& task, double sec, std::uint64_t bytes) {
+    auto tables = tableKey(task);
+    if (tables.empty()) return;
+    bool doSave = false;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _update(_entries[Key(tables, TABLE_CHUNK)], sec, bytes);
+        if (++_unsaved >= SAVE_INTERVAL && !_path.empty()) {
+            doSave = true;
+        }
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "ScanStats " << tables << " chunk=" << task.getChunkId()
+         << " sec=" << sec << " bytes=" << bytes);
+    if (doSave) {
+        save();
+    }
+}
+
+
+double ScanStats::estimateSec(wbase::Task& task) {
+    auto tables = tableKey(task);
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _entries.find(Key(tables, TABLE_CHUNK));
+    if (iter != _entries.end() && iter->second.count >= MIN_TABLE_SAMPLES) {
+        return iter->second.sec;
+    }
+    return -1.0;
+}
+
+
+int ScanStats::adjustRating(wbase::Task& task, int scanRating) {
+    double est = estimateSec(task);
+    if (est < 0) return scanRating;
+    int rating;
+    if (est > _mediumMaxSec) {
+        rating = proto::ScanInfo::Rating::SLOW;
+    } else if (est > _fastMaxSec) {
+        rating = proto::ScanInfo::Rating::MEDIUM;
+    } else {
+        rating = std::min(scanRating, static_cast<int>(proto::ScanInfo::Rating::FAST));
+    }
+    if (rating != scanRating) {
+        LOGS(_log, LOG_LVL_DEBUG, "ScanStats " << task.getIdStr() << " estimated sec=" << est
+             << " scanRating " << scanRating << " -> " << rating);
+    }
+    return rating;
+}
+
+
+ScanStats::Entry ScanStats::getTableEntry(wbase::Task& task) {
+    auto tables = tableKey(task);
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _entries.find(Key(tables, TABLE_CHUNK));
+    return iter == _entries.end() ? Entry() : iter->second;
+}
+
+
+bool ScanStats::load() {
+    std::ifstream in(_path);
+    if (!in) {
+        LOGS(_log, LOG_LVL_INFO, "ScanStats no file to load " << _path);
+        return false;
+    }
+    std::map<Key, Entry> entries;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream is(line);
+        Key key;
+        Entry entry;
+        if (!(is >> key.first >> key.second >> entry.count >> entry.sec >> entry.bytes)) {
+            LOGS(_log, LOG_LVL_WARN, "ScanStats ignoring bad line in " << _path << ": " << line);
+            continue;
+        }
+        if (key.second != TABLE_CHUNK) continue; // per chunk entries are no longer used
+        entries[key] = entry;
+    }
+    std::lock_guard<std::mutex> lock(_mtx);
+    _entries.swap(entries);
+    _unsaved = 0;
+    LOGS(_log, LOG_LVL_INFO, "ScanStats loaded " << _entries.size() << " entries from " << _path);
+    return true;
+}
+
+
+/// Write to a temporary file and rename it, so a crash never leaves a partial file.
+bool ScanStats::save() {
+    std::lock_guard<std::mutex> saveLock(_saveMtx);
+    std::map<Key, Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        entries = _entries;
+        _unsaved = 0;
+    }
+    std::string tmpPath = _path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        out << FILE_HEADER << "\n";
+        for (auto const& elem : entries) {
+            out << elem.first.first << " " << elem.first.second << " " << elem.second.count
+                << " " << elem.second.sec << " " << elem.second.bytes << "\n";
+        }
+        out.flush();
+        if (!out) {
+            LOGS(_log, LOG_LVL_WARN, "ScanStats failed to write " << tmpPath);
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), _path.c_str()) != 0) {
+        LOGS(_log, LOG_LVL_WARN, "ScanStats failed to rename " << tmpPath << " to " << _path);
+        return false;
+    }
+    return true;
+}
+
+}}} // namespace lsst::qserv::wsched
@@ -0,0 +1,115 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WSCHED_SCANSTATS_H
+#define LSST_QSERV_WSCHED_SCANSTATS_H
+
+// System headers
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+// Qserv headers
+#include "wbase/Task.h"
+
+namespace lsst {
+namespace qserv {
+namespace wsched {
+
+/// ScanStats keeps measured mysql times and result sizes of shared scan Tasks,
+/// per set of scanned tables, as exponentially weighted moving averages. The
+/// BlendScheduler uses them to move Tasks on tables whose measured cost does
+/// not match their CSS scanRating to the ScanScheduler lane that fits it.
+/// Routing is per table set, never per chunk, so that all Tasks scanning the
+/// same tables stay in one lane and keep sharing the scan.
+///
+/// If a file path is given, measurements are loaded from it on construction
+/// and written back periodically and on destruction, so they survive restarts.
+class ScanStats {
+public:
+    using Ptr = std::shared_ptr<ScanStats>;
+
+    /// Measured cost of a table set.
+    struct Entry {
+        int count{0};     ///< number of measurements
+        double sec{0};    ///< average run time in seconds
+        double bytes{0};  ///< average result size in bytes
+    };
+
+    /// @param path file to load from and save to, empty for no persistence.
+    /// @param fastMaxSec Tasks estimated to take longer than this go to at
+    ///                   least the MEDIUM lane.
+    /// @param mediumMaxSec Tasks estimated to take longer than this go to the
+    ///                     SLOW lane.
+    explicit ScanStats(std::string const& path,
+                       double fastMaxSec=30.0, double mediumMaxSec=300.0);
+    ScanStats(ScanStats const&) = delete;
+    ScanStats& operator=(ScanStats const&) = delete;
+    ~ScanStats();
+
+    /// Record the mysql time and result size of a finished scan Task.
+    void record(wbase::Task& task, double sec, std::uint64_t bytes);
+
+    /// @return the estimated mysql time of 'task' in seconds, the average for
+    ///         its tables once it has MIN_TABLE_SAMPLES samples, -1 if unknown.
+    ///         Each new sample moves the average, so an estimate falls again
+    ///         when the tables get faster.
+    double estimateSec(wbase::Task& task);
+
+    /// @return the rating of the lane the estimated time of 'task' calls for,
+    ///         raised or lowered from 'scanRating', or 'scanRating' if there is
+    ///         no estimate. A Task estimated to be fast keeps a lower rating.
+    int adjustRating(wbase::Task& task, int scanRating);
+
+    Entry getTableEntry(wbase::Task& task);
+
+    bool load();  ///< @return false if the file could not be read.
+    bool save();  ///< @return false if the file could not be written.
+
+    /// @return the key for the set of tables scanned by 'task', "" if none.
+    static std::string tableKey(wbase::Task& task);
+
+    static int const TABLE_CHUNK = -1; ///< chunk id of table averages in the file
+    static int const MIN_TABLE_SAMPLES = 3; ///< samples needed to use a table average
+    static int const SAVE_INTERVAL = 100; ///< save after this many records
+
+private:
+    using Key = std::pair<std::string, int>; ///< (tableKey, TABLE_CHUNK)
+
+    static void _update(Entry& entry, double sec, double bytes);
+
+    std::string const _path;
+    double const _fastMaxSec;
+    double const _mediumMaxSec;
+
+    std::mutex _mtx; ///< protects _entries and _unsaved
+    std::map<Key, Entry> _entries;
+    int _unsaved{0};
+    std::mutex _saveMtx; ///< serializes writes of _path
+};
+
+}}} // namespace lsst::qserv::wsched
+
+#endif // LSST_QSERV_WSCHED_SCANSTATS_H
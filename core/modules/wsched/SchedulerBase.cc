@@ -100,6 +100,7 @@ void SchedulerBase::_incrChunkTaskCount(int chunkId) {
 
 
 void SchedulerBase::_decrChunkTaskCount(int chunkId) {
+    ++_tasksFinished;
     // Decrement the count for this user query and remove the entry if count is 0.
     std::lock_guard<std::mutex> lock(_countsMutex);
     auto iter = _chunkTasks.find(chunkId);
@@ -118,6 +119,12 @@ int SchedulerBase::getActiveChunkCount() {
 }
 
 
+bool SchedulerBase::isChunkActive(int chunkId) {
+    std::lock_guard<std::mutex> lock(_countsMutex);
+    return _chunkTasks.find(chunkId) != _chunkTasks.end();
+}
+
+
 std::string SchedulerBase::chunkStatusStr() {
     std::ostringstream os;
     std::lock_guard<std::mutex> lock(_countsMutex);
@@ -131,4 +138,19 @@ std::string SchedulerBase::chunkStatusStr() {
 }
 
 
+void SchedulerBase::addStats(util::Metrics::Snapshot& stats) {
+    std::string prefix = "wsched." + getName() + ".";
+    stats[prefix + "queued"] = getSize();
+    stats[prefix + "inFlight"] = getInFlight();
+    stats[prefix + "maxActiveChunks"] = getMaxActiveChunks();
+    stats[prefix + "maxReserve"] = getMaxReserve();
+    stats[prefix + "tasksFinished"] = getTasksFinished();
+    std::lock_guard<std::mutex> lock(_countsMutex);
+    stats[prefix + "activeChunks"] = _chunkTasks.size();
+    for (auto const& entry : _userQueryCounts) {
+        stats[prefix + "query." + std::to_string(entry.first)] = entry.second;
+    }
+}
+
+
 }}} // namespace lsst::qserv::wsched
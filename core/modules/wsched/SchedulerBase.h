@@ -26,6 +26,8 @@
 #define LSST_QSERV_WSCHED_SCHEDULERBASE_H
 
 // System headers
+#include <atomic>
+#include <cstdint>
 
 // Qserv headers
 #include "wcontrol/Foreman.h"
@@ -61,7 +63,11 @@ public:
     virtual bool ready()=0; //< @return true if the scheduler is ready to provide a Task.
     int getUserQueriesInQ(); //< @return number of UserQueries in the queue.
     int getActiveChunkCount(); //< @return number of chunks being queried.
+    bool isChunkActive(int chunkId); //< @return true if chunkId is being queried.
     int getMaxActiveChunks() const { return _maxActiveChunks; }
+    void setMaxActiveChunks(int maxActiveChunks) { _maxActiveChunks = maxActiveChunks; }
+    /// @return the number of Tasks that have finished since this scheduler was created.
+    std::uint64_t getTasksFinished() const { return _tasksFinished; }
 
     /// Methods for altering priority.
     // Hooks for changing this schedulers priority/reserved threads.
@@ -70,6 +76,7 @@ public:
     void applyPriority();           ///< Apply _priorityNext
     void setPriorityDefault();      ///< Return to default priority next chunk
     int getMaxReserve() { return _maxReserve; }
+    int getMaxReserveDefault() { return _maxReserveDefault; }
     virtual void setMaxReserve(int maxReserve) { _maxReserve = maxReserve; }
     void restoreMaxReserve() { setMaxReserve(_maxReserveDefault); }
 
@@ -78,7 +85,7 @@ public:
     /// @return (availableThreads - (The number of threads beyond our reserve that we are using.))
     virtual int applyAvailableThreads(int availableThreads) {
         _maxThreadsAdj = availableThreads + desiredThreadReserve();
-        int remainingThreads = availableThreads - std::max(0, _inFlight - _maxReserve);
+        int remainingThreads = availableThreads - std::max(0, _inFlight - _maxReserve.load());
         return remainingThreads;
     }
 
@@ -89,7 +96,7 @@ public:
     /// do not get interrupted, or in the case of 1 Task, a second Task can be started right away.
     /// If 3 or more Tasks are running it still asks for 2 to be reserved.
     virtual int desiredThreadReserve() {
-        return std::min(_inFlight + 1, _maxReserve);
+        return std::min(_inFlight + 1, _maxReserve.load());
     }
 
     /// Return maximum number of Tasks this scheduler can have inFlight.
@@ -97,6 +104,17 @@ public:
 
     std::string chunkStatusStr(); //< @return a string
 
+    /// Add "wsched.<name>.*" values: queued and in flight Tasks, active chunks,
+    /// limits, and the number of queued Tasks of each user query.
+    void addStats(util::Metrics::Snapshot& stats) override;
+
+    /// Wake threads waiting for a command after resources changed outside of
+    /// queCmd() and commandFinish(), e.g. when a prefetch completes.
+    virtual void wakeUp() {
+        std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+        notify(true);
+    }
+
 protected:
     /// Increment the _userQueryCounts entry for queryId, creating it if needed.
     /// Precondition util::CommandQueue::_mx must be locked.
@@ -111,7 +129,9 @@ protected:
     void _decrChunkTaskCount(int chunkId); //< Decrease the count of Tasks working on this chunk.
 
     std::string const _name{}; //< Name of this scheduler.
-    int _maxReserve{1};    //< Number of threads this scheduler would like to have reserved for its use.
+    /// Number of threads this scheduler would like to have reserved for its use.
+    /// Atomic, as a SchedulerTuner may change it.
+    std::atomic<int> _maxReserve{1};
     int _maxReserveDefault{1};
     int _maxThreads{1};    //< Maximum number of threads for this scheduler to have inFlight.
     int _maxThreadsAdj{1}; //< Maximum number of threads to have inFlight adjusted for available pool.
@@ -132,7 +152,9 @@ private:
     std::mutex _countsMutex; //< Protects _userQueryCounts and _chunkTasks.
     // TODO: Decide to keep or remove _maxActiveChunks and related code. This depends primarily
     //       on 'everything' scheduler limits/needs.
-    int _maxActiveChunks{20}; //< Limit the number of chunks this scheduler can work on at one time.
+    /// Limit the number of chunks this scheduler can work on at one time.
+    std::atomic<int> _maxActiveChunks{20};
+    std::atomic<std::uint64_t> _tasksFinished{0}; //< Number of Tasks finished.
 };
 
 }}} // namespace lsst::qserv::wsched
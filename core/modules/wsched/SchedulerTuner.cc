@@ -0,0 +1,259 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wsched/SchedulerTuner.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wsched.SchedulerTuner");
+
+/// Number of steps a reservation is not raised again after a raise was undone.
+int const HOLD_STEPS = 5;
+}
+
+namespace lsst {
+namespace qserv {
+namespace wsched {
+
+constexpr double SchedulerTuner::MEM_LOW;
+constexpr double SchedulerTuner::MEM_HIGH;
+constexpr double SchedulerTuner::IO_HIGH;
+constexpr double SchedulerTuner::IO_LOW;
+
+
+SchedulerTuner::SchedulerTuner(memman::MemMan::Ptr const& memMan, std::chrono::milliseconds interval)
+    : _memMan(memMan), _interval(interval),
+      _next((Clock::now() + interval).time_since_epoch().count()), _last(Clock::now()) {
+    _ioWait(); // Start the I/O wait measurement.
+}
+
+
+bool SchedulerTuner::due() {
+    auto now = Clock::now().time_since_epoch().count();
+    auto next = _next.load();
+    if (now < next) return false;
+    auto after = (Clock::now() + _interval).time_since_epoch().count();
+    return _next.compare_exchange_strong(next, after);
+}
+
+
+void SchedulerTuner::setDefaults(std::string const& name, int maxActiveChunks, int maxReserve) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    Lane& lane = _lane(name);
+    lane.defaultActiveChunks = maxActiveChunks;
+    lane.defaultReserve = maxReserve;
+}
+
+
+/// Precondition: _mtx must be locked.
+SchedulerTuner::Lane& SchedulerTuner::_lane(std::string const& name) {
+    for (auto& lane : _lanes) {
+        if (lane.name == name) return lane;
+    }
+    _lanes.emplace_back();
+    _lanes.back().name = name;
+    return _lanes.back();
+}
+
+
+/// Precondition: _mtx must be locked.
+/// @return the fraction of CPU time spent waiting on I/O since the last call,
+///         0 if /proc/stat cannot be read.
+double SchedulerTuner::_ioWait() {
+    std::ifstream in("/proc/stat");
+    std::string cpu;
+    std::uint64_t val, total = 0, ioWait = 0;
+    if (!(in >> cpu) || cpu != "cpu") return 0.0;
+    // user nice system idle iowait irq softirq steal
+    for (int j = 0; j < 8 && in >> val; ++j) {
+        total += val;
+        if (j == 4) ioWait = val;
+    }
+    double frac = 0.0;
+    if (total > _cpuTotal && ioWait >= _cpuIoWait) {
+        frac = static_cast<double>(ioWait - _cpuIoWait) / (total - _cpuTotal);
+    }
+    _cpuTotal = total;
+    _cpuIoWait = ioWait;
+    return frac;
+}
+
+
+SchedulerTuner::Sample SchedulerTuner::measure(std::vector<SchedulerBase::Ptr> const& scheds,
+                                               int poolThreads) {
+    Sample sample;
+    sample.poolThreads = poolThreads;
+    if (_memMan != nullptr) {
+        auto stats = _memMan->getStatistics();
+        if (stats.bytesLockMax > 0) {
+            auto used = std::min(stats.bytesLockMax, stats.bytesLocked + stats.bytesReserved);
+            sample.memHeadroom = static_cast<double>(stats.bytesLockMax - used) / stats.bytesLockMax;
+        }
+    }
+    std::lock_guard<std::mutex> lock(_mtx);
+    sample.ioWait = _ioWait();
+    auto now = Clock::now();
+    double sec = std::chrono::duration<double>(now - _last).count();
+    _last = now;
+    for (auto const& sched : scheds) {
+        LaneSample ls;
+        ls.name = sched->getName();
+        ls.queued = sched->getSize();
+        ls.inFlight = sched->getInFlight();
+        ls.activeChunks = sched->getActiveChunkCount();
+        Lane& lane = _lane(ls.name);
+        if (lane.defaultReserve == 0) {
+            lane.defaultActiveChunks = sched->getMaxActiveChunks();
+            lane.defaultReserve = sched->getMaxReserveDefault();
+        }
+        auto finished = sched->getTasksFinished();
+        if (sec > 0) ls.tasksPerSec = (finished - lane.finished) / sec;
+        lane.finished = finished;
+        sample.lanes.push_back(ls);
+    }
+    return sample;
+}
+
+
+void SchedulerTuner::apply(std::vector<SchedulerBase::Ptr> const& scheds, Sample& sample) {
+    for (std::size_t j = 0; j < scheds.size(); ++j) {
+        sample.lanes[j].maxActiveChunks = scheds[j]->getMaxActiveChunks();
+        sample.lanes[j].maxReserve = scheds[j]->getMaxReserve();
+    }
+    auto settings = step(sample);
+    for (std::size_t j = 0; j < scheds.size(); ++j) {
+        scheds[j]->setMaxActiveChunks(settings[j].maxActiveChunks);
+        scheds[j]->setMaxReserve(settings[j].maxReserve);
+    }
+}
+
+
+std::vector<SchedulerTuner::Setting> SchedulerTuner::step(Sample const& sample) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    bool pressure = sample.memHeadroom < MEM_LOW || sample.ioWait > IO_HIGH;
+    bool room = sample.memHeadroom > MEM_HIGH && sample.ioWait < IO_LOW;
+    int reserveSum = 0;
+    for (auto const& ls : sample.lanes) {
+        reserveSum += ls.maxReserve;
+    }
+    int reserveBudget = sample.poolThreads / 2;
+    ++_steps;
+    _lastMemHeadroom = sample.memHeadroom;
+    _lastIoWait = sample.ioWait;
+
+    std::ostringstream os;
+    os << "memHeadroom=" << sample.memHeadroom << " ioWait=" << sample.ioWait;
+    std::vector<Setting> settings;
+    for (auto const& ls : sample.lanes) {
+        Lane& lane = _lane(ls.name);
+        if (lane.defaultReserve == 0) {
+            lane.defaultActiveChunks = ls.maxActiveChunks;
+            lane.defaultReserve = ls.maxReserve;
+        }
+        Setting set{ls.maxActiveChunks, ls.maxReserve};
+
+        // Active chunk limit.
+        if (pressure) {
+            set.maxActiveChunks = std::max(1, std::min(set.maxActiveChunks - 1, ls.activeChunks));
+        } else if (room) {
+            set.maxActiveChunks = std::min(lane.defaultActiveChunks, set.maxActiveChunks + 1);
+        }
+
+        // Thread reservation.
+        if (lane.raised && ls.tasksPerSec < lane.tasksPerSec * 0.95) {
+            // The last raise did not help, undo it and leave it for a while.
+            set.maxReserve = std::max(lane.defaultReserve, set.maxReserve - 1);
+            lane.raised = false;
+            lane.hold = HOLD_STEPS;
+        } else if (ls.queued > 0 && ls.inFlight >= ls.maxReserve && sample.ioWait <= IO_HIGH
+                   && set.maxReserve < 2 * lane.defaultReserve && reserveSum < reserveBudget
+                   && lane.hold == 0) {
+            ++set.maxReserve;
+            ++reserveSum;
+            lane.raised = true;
+            lane.tasksPerSec = ls.tasksPerSec;
+        } else {
+            lane.raised = false;
+            if (lane.hold > 0) --lane.hold;
+            if (ls.queued == 0 && set.maxReserve > lane.defaultReserve) {
+                --set.maxReserve;
+                --reserveSum;
+            }
+        }
+
+        auto sign = [](int d) { return (d > 0) - (d < 0); };
+        lane.maxActiveChunks = set.maxActiveChunks;
+        lane.maxReserve = set.maxReserve;
+        lane.activeChunksChange = sign(set.maxActiveChunks - ls.maxActiveChunks);
+        lane.reserveChange = sign(set.maxReserve - ls.maxReserve);
+        if (set.maxActiveChunks != ls.maxActiveChunks || set.maxReserve != ls.maxReserve) {
+            LOGS(_log, LOG_LVL_INFO, "SchedulerTuner " << ls.name
+                 << " maxActiveChunks " << ls.maxActiveChunks << "->" << set.maxActiveChunks
+                 << " maxReserve " << ls.maxReserve << "->" << set.maxReserve
+                 << " memHeadroom=" << sample.memHeadroom << " ioWait=" << sample.ioWait
+                 << " queued=" << ls.queued << " inFlight=" << ls.inFlight
+                 << " activeChunks=" << ls.activeChunks << " tasksPerSec=" << ls.tasksPerSec);
+        }
+        os << " " << ls.name << "(queued=" << ls.queued << " inFlight=" << ls.inFlight
+           << " chunks=" << ls.activeChunks << "/" << set.maxActiveChunks
+           << " reserve=" << set.maxReserve << " tasksPerSec=" << ls.tasksPerSec << ")";
+        settings.push_back(set);
+    }
+    _status = os.str();
+    return settings;
+}
+
+
+std::string SchedulerTuner::statusStr() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _status;
+}
+
+
+void SchedulerTuner::addStats(util::Metrics::Snapshot& stats) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    stats["wsched.tuner.steps"] = _steps;
+    stats["wsched.tuner.memHeadroomPct"] = std::lround(_lastMemHeadroom * 100);
+    stats["wsched.tuner.ioWaitPct"] = std::lround(_lastIoWait * 100);
+    for (auto const& lane : _lanes) {
+        std::string prefix = "wsched.tuner." + lane.name + ".";
+        stats[prefix + "maxActiveChunks"] = lane.maxActiveChunks;
+        stats[prefix + "maxReserve"] = lane.maxReserve;
+        stats[prefix + "activeChunksChange"] = lane.activeChunksChange;
+        stats[prefix + "reserveChange"] = lane.reserveChange;
+        stats[prefix + "defaultActiveChunks"] = lane.defaultActiveChunks;
+        stats[prefix + "defaultReserve"] = lane.defaultReserve;
+        stats[prefix + "hold"] = lane.hold;
+    }
+}
+
+}}} // namespace lsst::qserv::wsched
@@ -0,0 +1,169 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2016 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WSCHED_SCHEDULERTUNER_H
+#define LSST_QSERV_WSCHED_SCHEDULERTUNER_H
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "memman/MemMan.h"
+#include "util/Metrics.h"
+#include "wsched/SchedulerBase.h"
+
+namespace lsst {
+namespace qserv {
+namespace wsched {
+
+/// SchedulerTuner adjusts, at a fixed interval, the thread reservation of each
+/// BlendScheduler sub-scheduler and the active chunk limit of each scheduler,
+/// starting from their configured values.
+///
+/// - When MemMan is nearly full or the node is waiting on I/O, opening more
+///   chunks only makes the scans compete for the disk. Active chunk limits
+///   are then lowered to the chunks already being scanned, and then by one
+///   per step, down to 1. Once there is room again they go back up by one
+///   per step, up to the configured value.
+/// - A sub-scheduler with Tasks queued that uses all its reserved threads gets
+///   one more reserved thread per step, up to twice its configured value, as
+///   long as all reservations stay within half of the pool. If its throughput
+///   drops after such a step, the step is undone. Reservations are not raised
+///   while the node is waiting on I/O. A sub-scheduler with nothing queued
+///   goes back towards its configured reservation.
+///
+/// Every change is logged, statusStr() describes the last step, and
+/// addStats() reports it in the worker stats.
+class SchedulerTuner {
+public:
+    using Ptr = std::shared_ptr<SchedulerTuner>;
+    using Clock = std::chrono::steady_clock;
+
+    /// Load of one sub-scheduler, measured over one interval.
+    struct LaneSample {
+        std::string name;
+        std::size_t queued{0};
+        int inFlight{0};
+        int activeChunks{0};
+        double tasksPerSec{0};
+        int maxActiveChunks{0}; ///< current limit
+        int maxReserve{0};      ///< current reservation
+    };
+
+    /// Load of the worker, measured over one interval.
+    struct Sample {
+        double memHeadroom{1.0}; ///< fraction of MemMan memory neither locked nor reserved
+        double ioWait{0.0};      ///< fraction of CPU time spent waiting on I/O
+        int poolThreads{0};
+        std::vector<LaneSample> lanes;
+    };
+
+    /// Limits chosen for one sub-scheduler.
+    struct Setting {
+        int maxActiveChunks;
+        int maxReserve;
+    };
+
+    /// @param memMan used to measure memory headroom, may be nullptr.
+    /// @param interval time between steps.
+    SchedulerTuner(memman::MemMan::Ptr const& memMan, std::chrono::milliseconds interval);
+    SchedulerTuner(SchedulerTuner const&) = delete;
+    SchedulerTuner& operator=(SchedulerTuner const&) = delete;
+
+    /// @return true, for one caller only, once the interval has passed since
+    ///         the last step.
+    bool due();
+
+    /// Measure the load of the worker and of 'scheds'. This reads /proc/stat
+    /// and the MemMan statistics, so it should be called without holding the
+    /// BlendScheduler mutex; the schedulers' counters are read with their own
+    /// locks.
+    Sample measure(std::vector<SchedulerBase::Ptr> const& scheds, int poolThreads);
+
+    /// Apply step() to 'scheds', using the load in 'sample' from measure()
+    /// and the limits the schedulers have now.
+    /// The caller must hold the BlendScheduler mutex.
+    void apply(std::vector<SchedulerBase::Ptr> const& scheds, Sample& sample);
+
+    /// @return the limits for each lane in 'sample', in the same order.
+    /// 'sample' must list the same sub-schedulers, in any order, on every call.
+    std::vector<Setting> step(Sample const& sample);
+
+    /// Remember the configured limits of a sub-scheduler, the bounds for step().
+    void setDefaults(std::string const& name, int maxActiveChunks, int maxReserve);
+
+    /// @return a description of the last sample and the limits chosen.
+    std::string statusStr();
+
+    /// Add the state of the last step to 'stats', as "wsched.tuner.*":
+    /// the steps taken, the memory headroom and I/O wait in percent, and for
+    /// each sub-scheduler the limits chosen, their change (-1, 0 or 1), the
+    /// configured limits, and the steps left before a raise may be retried.
+    void addStats(util::Metrics::Snapshot& stats);
+
+    static constexpr double MEM_LOW = 0.1;  ///< headroom below which chunks are limited
+    static constexpr double MEM_HIGH = 0.5; ///< headroom above which limits are relaxed
+    static constexpr double IO_HIGH = 0.3;  ///< I/O wait above which chunks are limited
+    static constexpr double IO_LOW = 0.1;   ///< I/O wait below which limits are relaxed
+
+private:
+    /// State kept for each sub-scheduler between steps.
+    struct Lane {
+        std::string name;
+        int defaultActiveChunks{0};
+        int defaultReserve{0};
+        std::uint64_t finished{0}; ///< getTasksFinished() at the last step
+        double tasksPerSec{0};     ///< throughput before the reservation was raised
+        bool raised{false};        ///< reservation was raised by the last step
+        int hold{0};               ///< steps left before it may be raised again
+        int maxActiveChunks{0};    ///< chosen by the last step
+        int maxReserve{0};         ///< chosen by the last step
+        int activeChunksChange{0}; ///< by the last step, -1, 0 or 1
+        int reserveChange{0};      ///< by the last step, -1, 0 or 1
+    };
+    Lane& _lane(std::string const& name);
+    double _ioWait();
+
+    memman::MemMan::Ptr _memMan;
+    std::chrono::milliseconds const _interval;
+    std::atomic<Clock::rep> _next; ///< time of the next step
+
+    std::mutex _mtx; ///< protects all members below
+    std::vector<Lane> _lanes;
+    Clock::time_point _last;
+    std::uint64_t _cpuTotal{0}; ///< from /proc/stat at the last step
+    std::uint64_t _cpuIoWait{0};
+    std::string _status;
+    std::int64_t _steps{0};
+    double _lastMemHeadroom{1.0}; ///< of the last step
+    double _lastIoWait{0.0};      ///< of the last step
+};
+
+}}} // namespace lsst::qserv::wsched
+
+#endif // LSST_QSERV_WSCHED_SCHEDULERTUNER_H
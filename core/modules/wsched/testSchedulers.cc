@@ -27,6 +27,17 @@
   * @author Daniel L. Wang, SLAC
   */
 
+// System headers
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
 // Third-party headers
 
 // LSST headers
@@ -42,6 +53,8 @@
 #include "wsched/FifoScheduler.h"
 #include "wsched/GroupScheduler.h"
 #include "wsched/ScanScheduler.h"
+#include "wsched/ScanStats.h"
+#include "wsched/SchedulerTuner.h"
 
 // Boost unit test header
 #define BOOST_TEST_MODULE FifoScheduler_1
@@ -58,6 +71,62 @@ using lsst::qserv::proto::TaskMsg;
 using lsst::qserv::wbase::Task;
 using lsst::qserv::wbase::SendChannel;
 
+namespace memman = lsst::qserv::memman;
+
+/// MemMan that grants every lock, except on chunks in 'denied', and records
+/// lock/unlock calls per chunk. Chunks in 'resident' are reported as locked.
+class MemManCount : public memman::MemMan {
+public:
+    Handle lock(std::vector<memman::TableInfo> const& tables, int chunk) override {
+        std::lock_guard<std::mutex> lg(mtx);
+        if (denied.count(chunk) != 0) {
+            errno = ENOMEM;
+            return memman::MemMan::HandleType::INVALID;
+        }
+        ++locks[chunk];
+        Handle h = ++lastHandle;
+        handleChunk[h] = chunk;
+        return h;
+    }
+    bool unlock(Handle handle) override {
+        std::lock_guard<std::mutex> lg(mtx);
+        ++unlocks[handleChunk[handle]];
+        return true;
+    }
+    bool isResident(std::vector<memman::TableInfo> const& tables, int chunk) override {
+        std::lock_guard<std::mutex> lg(mtx);
+        return resident.count(chunk) != 0;
+    }
+    void unlockAll() override {}
+    Statistics getStatistics() override {
+        Statistics stats;
+        memset(&stats, 0, sizeof(stats));
+        stats.bytesLockMax = 1000;
+        return stats;
+    }
+    Status getStatus(Handle handle) override {
+        Status status;
+        memset(&status, 0, sizeof(status));
+        return status;
+    }
+    int getLocks(int chunk) {
+        std::lock_guard<std::mutex> lg(mtx);
+        return locks[chunk];
+    }
+    int getUnlocks(int chunk) {
+        std::lock_guard<std::mutex> lg(mtx);
+        return unlocks[chunk];
+    }
+
+    std::mutex mtx;
+    Handle lastHandle{memman::MemMan::HandleType::ISEMPTY};
+    std::map<Handle, int> handleChunk;
+    std::map<int, int> locks;
+    std::map<int, int> unlocks;
+    std::set<int> denied;
+    std::set<int> resident;
+};
+
 
 
 Task::Ptr makeTask(std::shared_ptr<TaskMsg> tm) {
@@ -231,6 +300,123 @@ BOOST_AUTO_TEST_CASE(GroupMaxThread) {
     BOOST_CHECK(gs.ready() == false);
 }
 
+BOOST_AUTO_TEST_CASE(GroupBurst) {
+    // Queue a burst of 100k Tasks over 1000 chunks, then drain it. Tasks must
+    // come out in groups of at most maxGroupSize Tasks of one chunk, groups in
+    // the order their first Task arrived, Tasks of a chunk in arrival order.
+    int const taskCount = 100000;
+    int const chunkCount = 1000;
+    int const maxGroupSize = 10;
+    wsched::GroupScheduler gs{"GroupSchedBurst", taskCount, 0, maxGroupSize, 0};
+    std::unordered_map<Task*, int> arrival;
+    std::map<int, int> perChunk;
+    auto start = std::chrono::steady_clock::now();
+    for (int j=0; j < taskCount; ++j) {
+        auto tm = newTaskMsgSimple((j * 7919) % chunkCount);
+        if (j % 1000 == 999) {
+            tm->clear_chunkid(); // Tasks without a chunk id are a group of their own.
+        }
+        Task::Ptr t = makeTask(tm);
+        arrival[t.get()] = j;
+        ++perChunk[tm->has_chunkid() ? tm->chunkid() : -1];
+        gs.queCmd(t);
+    }
+    auto queued = std::chrono::steady_clock::now();
+    std::size_t expectedGroups = 0;
+    for (auto const& elem : perChunk) {
+        expectedGroups += (elem.second + maxGroupSize - 1) / maxGroupSize;
+    }
+    BOOST_CHECK_EQUAL(gs.getSize(), expectedGroups);
+
+    std::map<int, int> lastArrival; // last arrival index seen per chunk
+    int groupChunk = -2;
+    int groupLen = 0;
+    int groupFirst = -1;
+    int dequeued = 0;
+    bool ordered = true;
+    while (auto cmd = gs.getCmd(false)) {
+        auto t = std::dynamic_pointer_cast<Task>(cmd);
+        int chunk = t->msg->has_chunkid() ? t->msg->chunkid() : -1;
+        int idx = arrival[t.get()];
+        if (chunk != groupChunk || groupLen == maxGroupSize) {
+            ordered = ordered && idx > groupFirst; // FIFO between groups
+            groupChunk = chunk;
+            groupFirst = idx;
+            groupLen = 0;
+        }
+        ++groupLen;
+        auto last = lastArrival.find(chunk);
+        ordered = ordered && (last == lastArrival.end() || last->second < idx);
+        lastArrival[chunk] = idx;
+        ++dequeued;
+    }
+    auto drained = std::chrono::steady_clock::now();
+    BOOST_CHECK(ordered);
+    BOOST_CHECK_EQUAL(dequeued, taskCount);
+    BOOST_CHECK(gs.empty());
+    using ms = std::chrono::milliseconds;
+    LOGS(_log, LOG_LVL_INFO, "GroupBurst tasks=" << taskCount
+         << " queue=" << std::chrono::duration_cast<ms>(queued - start).count() << "ms"
+         << " drain=" << std::chrono::duration_cast<ms>(drained - queued).count() << "ms");
+}
+
+BOOST_AUTO_TEST_CASE(GroupDeadline) {
+    // Tasks with deadlines run earliest deadline first, ahead of Tasks without
+    // one until those have waited for the aging limit.
+    wsched::GroupScheduler gs{"GroupSchedD", 100, 0, 3, 0};
+    auto withDeadline = [this](int chunkId, int budgetSec) {
+        auto tm = newTaskMsgSimple(chunkId);
+        tm->set_priorityclass(TaskMsg::INTERACTIVE);
+        tm->set_deadlinebudget(budgetSec * 1000);
+        return makeTask(tm);
+    };
+    Task::Ptr a = makeTask(newTaskMsgSimple(1));
+    Task::Ptr b = withDeadline(2, 10);
+    Task::Ptr c = withDeadline(3, 5);
+    Task::Ptr d = withDeadline(3, 5); // joins c
+    Task::Ptr e = withDeadline(3, 1); // earlier than c, new group
+    for (auto const& t : {a, b, c, d, e}) gs.queCmd(t);
+    BOOST_CHECK(gs.getSize() == 4);
+    for (auto const& t : {e, c, d, b, a}) {
+        BOOST_CHECK(gs.getCmd(false) == t);
+    }
+    BOOST_CHECK(gs.empty());
+    BOOST_CHECK(gs.getDeadlineMisses() == 0);
+
+    // The czar sends what is left of a query's deadline. A Task of an older
+    // query, received after Tasks of newer queries on the same chunk, goes
+    // ahead of them.
+    Task::Ptr newer1 = withDeadline(8, 60);
+    Task::Ptr newer2 = withDeadline(8, 60);
+    Task::Ptr older = withDeadline(8, 20);
+    for (auto const& t : {newer1, newer2, older}) gs.queCmd(t);
+    for (auto const& t : {older, newer1, newer2}) {
+        BOOST_CHECK(gs.getCmd(false) == t);
+    }
+    BOOST_CHECK(gs.empty());
+
+    // Aging, a group without a deadline waiting longer than the limit goes first.
+    gs.setAgingLimit(std::chrono::milliseconds(0));
+    Task::Ptr f = makeTask(newTaskMsgSimple(4));
+    Task::Ptr g = withDeadline(5, 10);
+    gs.queCmd(f);
+    gs.queCmd(g);
+    BOOST_CHECK(gs.getCmd(false) == f);
+    BOOST_CHECK(gs.getCmd(false) == g);
+
+    // Starting a Task after its deadline is counted.
+    gs.queCmd(withDeadline(6, 0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    BOOST_CHECK(gs.getCmd(false) != nullptr);
+    BOOST_CHECK(gs.getDeadlineMisses() == 1);
+
+    // Only interactive Tasks have a deadline.
+    auto tm = newTaskMsgSimple(7);
+    tm->set_priorityclass(TaskMsg::SCAN);
+    tm->set_deadlinebudget(1000);
+    BOOST_CHECK(!makeTask(tm)->hasDeadline());
+}
+
 BOOST_AUTO_TEST_CASE(DiskMinHeap) {
     wsched::ChunkDisk::MinHeap minHeap{};
 
@@ -336,6 +522,48 @@ BOOST_AUTO_TEST_CASE(ChunkDiskMemManNoneTest) {
 }
 
 
+BOOST_AUTO_TEST_CASE(ChunkDiskResident) {
+    auto memMan = std::make_shared<MemManCount>();
+    wsched::ChunkDisk cDisk(memMan);
+    Task::Ptr a40 = makeTask(newTaskMsgScan(40, 0));
+    Task::Ptr a41 = makeTask(newTaskMsgScan(41, 0));
+    Task::Ptr a42 = makeTask(newTaskMsgScan(42, 0));
+    cDisk.enqueue(a40);
+    cDisk.enqueue(a41);
+    cDisk.enqueue(a42);
+
+    // No memory for chunk 40, but another scheduler holds the tables of 41.
+    memMan->denied.insert(40);
+    memMan->resident.insert(41);
+    BOOST_CHECK(cDisk.ready(false) == true);
+    BOOST_CHECK(cDisk.getSize() == 3);
+    BOOST_CHECK(cDisk.getTask(false) == a41);
+    BOOST_CHECK(a41->hasMemHandle());
+    BOOST_CHECK(memMan->getLocks(41) == 1);
+
+    // Chunk 42 is not resident, so nothing else can run until 40 gets memory.
+    BOOST_CHECK(cDisk.ready(false) == false);
+    BOOST_CHECK(cDisk.getSize() == 2);
+    memMan->denied.clear();
+    BOOST_CHECK(cDisk.getTask(false) == a40);
+    BOOST_CHECK(cDisk.getTask(false) == a42);
+    BOOST_CHECK(cDisk.empty());
+
+    // A resident chunk the scheduler may not start yet is not granted.
+    Task::Ptr a50 = makeTask(newTaskMsgScan(50, 0));
+    Task::Ptr a51 = makeTask(newTaskMsgScan(51, 0));
+    cDisk.enqueue(a50);
+    cDisk.enqueue(a51);
+    memMan->denied.insert(50);
+    memMan->resident.insert(51);
+    cDisk.setChunkFilter([](int chunkId) { return chunkId != 51; });
+    BOOST_CHECK(cDisk.ready(false) == false);
+    BOOST_CHECK(memMan->getLocks(51) == 0);
+    cDisk.setChunkFilter(nullptr);
+    BOOST_CHECK(cDisk.getTask(false) == a51);
+}
+
+
 BOOST_AUTO_TEST_CASE(ScanScheduleTest) {
     auto memMan = std::make_shared<lsst::qserv::memman::MemManNone>(1, false);
     wsched::ScanScheduler sched{"ScanSchedA", 2, 1, 0, memMan, 0, 100};
@@ -677,4 +905,329 @@ BOOST_AUTO_TEST_CASE(BlendScheduleTest) {
     LOGS(_log, LOG_LVL_DEBUG, "BlendScheduleTest-2 done");
 }
 
+BOOST_AUTO_TEST_CASE(BlendRelaxReserve) {
+    // With relaxed reservations, the GroupScheduler can use the threads kept
+    // for idle ScanSchedulers. A scan Task then waits for a thread to free up.
+    LOGS(_log, LOG_LVL_DEBUG, "BlendRelaxReserve start");
+    int const fast    = lsst::qserv::proto::ScanInfo::Rating::FAST;
+    int const medium  = lsst::qserv::proto::ScanInfo::Rating::MEDIUM;
+    int const slow    = lsst::qserv::proto::ScanInfo::Rating::SLOW;
+    int const maxThreads = 9;
+    auto memMan = std::make_shared<lsst::qserv::memman::MemManNone>(1, true);
+    auto group = std::make_shared<wsched::GroupScheduler>("GroupSched", maxThreads, 2, 3, 1);
+    auto scanSlow = std::make_shared<wsched::ScanScheduler>(
+        "ScanSlow", maxThreads, 2, 2, memMan, medium+1, slow);
+    auto scanMed  = std::make_shared<wsched::ScanScheduler>(
+        "ScanMed",  maxThreads, 2, 3, memMan, fast+1, medium);
+    auto scanFast = std::make_shared<wsched::ScanScheduler>(
+        "ScanFast", maxThreads, 3, 4, memMan, 0, fast);
+    std::vector<wsched::ScanScheduler::Ptr> scanSchedulers{scanFast, scanMed, scanSlow};
+    auto blend = std::make_shared<wsched::BlendScheduler>("blendSched", maxThreads, group, scanSchedulers);
+    blend->setRelaxReserve(true);
+
+    std::vector<lsst::qserv::util::Command::Ptr> groupTasks;
+    for (int j=0; j < 10; ++j) {
+        blend->queCmd(makeTask(newTaskMsg(j)));
+    }
+    for (int j=0; j < maxThreads; ++j) {
+        BOOST_CHECK(blend->ready() == true);
+        auto cmd = blend->getCmd(false);
+        BOOST_CHECK(cmd != nullptr);
+        groupTasks.push_back(cmd);
+    }
+    // All threads are in use.
+    BOOST_CHECK(blend->ready() == false);
+    BOOST_CHECK(blend->getInFlight() == maxThreads);
+
+    Task::Ptr scan = makeTask(newTaskMsgScan(40, fast));
+    blend->queCmd(scan);
+    BOOST_CHECK(blend->ready() == false);
+    // The reservation for ScanFast applies again now that it has a Task queued.
+    blend->commandFinish(groupTasks[0]);
+    BOOST_CHECK(blend->getCmd(false) == scan);
+    // ScanFast has nothing queued again, so the last group Task gets the free thread.
+    blend->commandFinish(groupTasks[1]);
+    auto last = blend->getCmd(false);
+    BOOST_CHECK(last != nullptr);
+    BOOST_CHECK(blend->ready() == false);
+    blend->commandFinish(scan);
+    blend->commandFinish(last);
+    for (unsigned int j=2; j < groupTasks.size(); ++j) {
+        blend->commandFinish(groupTasks[j]);
+    }
+    BOOST_CHECK(blend->getInFlight() == 0);
+    LOGS(_log, LOG_LVL_DEBUG, "BlendRelaxReserve done");
+}
+
+BOOST_AUTO_TEST_CASE(BlendConcurrent) {
+    // Many threads queuing Tasks while pool threads run them. Every Task must
+    // be run exactly once and no pool thread may be left waiting while Tasks
+    // are queued.
+    LOGS(_log, LOG_LVL_DEBUG, "BlendConcurrent start");
+    int const fast    = lsst::qserv::proto::ScanInfo::Rating::FAST;
+    int const medium  = lsst::qserv::proto::ScanInfo::Rating::MEDIUM;
+    int const slow    = lsst::qserv::proto::ScanInfo::Rating::SLOW;
+    int const maxThreads = 9;
+    auto memMan = std::make_shared<lsst::qserv::memman::MemManNone>(1, true);
+    auto group = std::make_shared<wsched::GroupScheduler>("GroupSched", maxThreads, 2, 3, 1);
+    auto scanSlow = std::make_shared<wsched::ScanScheduler>(
+        "ScanSlow", maxThreads, 2, 2, memMan, medium+1, slow);
+    auto scanMed  = std::make_shared<wsched::ScanScheduler>(
+        "ScanMed",  maxThreads, 2, 3, memMan, fast+1, medium);
+    auto scanFast = std::make_shared<wsched::ScanScheduler>(
+        "ScanFast", maxThreads, 3, 4, memMan, 0, fast);
+    std::vector<wsched::ScanScheduler::Ptr> scanSchedulers{scanFast, scanMed, scanSlow};
+    auto blend = std::make_shared<wsched::BlendScheduler>("blendSched", maxThreads, group, scanSchedulers);
+
+    int const producers = 4;
+    int const tasksPerProducer = 2000;
+    int const total = producers * tasksPerProducer;
+    std::vector<std::vector<Task::Ptr>> tasks(producers);
+    int const ratings[] = {0, fast, medium, slow};
+    for (int p=0; p < producers; ++p) {
+        for (int j=0; j < tasksPerProducer; ++j) {
+            int chunk = (j * 31 + p) % 200;
+            tasks[p].push_back(makeTask(j % 5 == 0 ? newTaskMsgSimple(chunk)
+                                                   : newTaskMsgScan(chunk, ratings[j % 4])));
+        }
+    }
+    std::atomic<int> done{0};
+    std::vector<std::thread> pool;
+    for (int j=0; j < maxThreads; ++j) {
+        pool.emplace_back([&blend, &done]() {
+            while (true) {
+                auto cmd = blend->getCmd(true);
+                auto task = std::dynamic_pointer_cast<Task>(cmd);
+                blend->commandStart(cmd);
+                blend->commandFinish(cmd);
+                if (task->msg->chunkid() < 0) break; // end of test
+                ++done;
+            }
+        });
+    }
+    std::vector<std::thread> queuers;
+    for (int p=0; p < producers; ++p) {
+        queuers.emplace_back([&blend, &tasks, p]() {
+            for (auto const& t : tasks[p]) blend->queCmd(t);
+        });
+    }
+    for (auto& thrd : queuers) thrd.join();
+    for (int j=0; j < 10000 && done < total; ++j) {
+        usleep(1000);
+    }
+    BOOST_CHECK_EQUAL(done, total);
+    for (int j=0; j < maxThreads; ++j) {
+        blend->queCmd(makeTask(newTaskMsgSimple(-1)));
+    }
+    for (auto& thrd : pool) thrd.join();
+    BOOST_CHECK(blend->getInFlight() == 0);
+    BOOST_CHECK(blend->getSize() == 0);
+    LOGS(_log, LOG_LVL_DEBUG, "BlendConcurrent done");
+}
+
+BOOST_AUTO_TEST_CASE(ScanStatsTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "ScanStatsTest start");
+    int const fast    = lsst::qserv::proto::ScanInfo::Rating::FAST;
+    int const medium  = lsst::qserv::proto::ScanInfo::Rating::MEDIUM;
+    int const slow    = lsst::qserv::proto::ScanInfo::Rating::SLOW;
+    std::string path = "/tmp/testSchedulers_scanstats_" + std::to_string(getpid());
+    std::remove(path.c_str());
+    {
+        wsched::ScanStats stats(path, 30.0, 300.0);
+        auto t1 = makeTask(newTaskMsgScan(1, fast));
+        BOOST_CHECK(stats.estimateSec(*t1) < 0);
+        BOOST_CHECK(stats.adjustRating(*t1, fast) == fast);
+        stats.record(*t1, 100.0, 1000);
+        stats.record(*makeTask(newTaskMsgScan(2, fast)), 100.0, 1000);
+        // A single chunk, or two samples, are not enough to move the tables.
+        BOOST_CHECK(stats.estimateSec(*t1) < 0);
+        auto t7 = makeTask(newTaskMsgScan(7, fast));
+        BOOST_CHECK(stats.adjustRating(*t7, fast) == fast);
+        stats.record(*makeTask(newTaskMsgScan(3, fast)), 100.0, 1000);
+        // Every chunk of the tables uses the table average.
+        BOOST_CHECK_CLOSE(stats.estimateSec(*t7), 100.0, 0.001);
+        BOOST_CHECK_CLOSE(stats.estimateSec(*t1), 100.0, 0.001);
+        BOOST_CHECK(stats.adjustRating(*t7, fast) == medium);
+        BOOST_CHECK(stats.adjustRating(*t7, slow) == medium); // lowered too
+        stats.record(*t1, 2000.0, 1000);
+        BOOST_CHECK_CLOSE(stats.estimateSec(*t7), 100.0 + 0.2*1900.0, 0.001);
+        BOOST_CHECK(stats.adjustRating(*t7, fast) == slow);
+        BOOST_CHECK(stats.getTableEntry(*t1).count == 4);
+    } // saved on destruction
+    {
+        wsched::ScanStats stats(path, 30.0, 300.0);
+        auto t7 = makeTask(newTaskMsgScan(7, fast));
+        BOOST_CHECK(stats.getTableEntry(*t7).count == 4);
+        BOOST_CHECK(stats.adjustRating(*t7, fast) == slow);
+
+        // BlendScheduler puts a FAST Task on the table in the slow lane.
+        auto memMan = std::make_shared<lsst::qserv::memman::MemManNone>(1, true);
+        auto group = std::make_shared<wsched::GroupScheduler>("GroupSched", 9, 2, 3, 1);
+        auto scanSlow = std::make_shared<wsched::ScanScheduler>(
+            "ScanSlow", 9, 2, 2, memMan, medium+1, slow);
+        auto scanMed  = std::make_shared<wsched::ScanScheduler>(
+            "ScanMed",  9, 2, 3, memMan, fast+1, medium);
+        auto scanFast = std::make_shared<wsched::ScanScheduler>(
+            "ScanFast", 9, 3, 4, memMan, 0, fast);
+        std::vector<wsched::ScanScheduler::Ptr> scanSchedulers{scanFast, scanMed, scanSlow};
+        auto blend = std::make_shared<wsched::BlendScheduler>("blendSched", 9, group, scanSchedulers);
+        auto statsPtr = std::make_shared<wsched::ScanStats>("");
+        for (int j = 0; j < wsched::ScanStats::MIN_TABLE_SAMPLES; ++j) {
+            statsPtr->record(*t7, 500.0, 10);
+        }
+        blend->setScanStats(statsPtr);
+        blend->queCmd(t7);
+        BOOST_CHECK(scanFast->getSize() == 0);
+        BOOST_CHECK(scanSlow->getSize() == 1);
+        auto cmd = blend->getCmd(false);
+        BOOST_CHECK(cmd == t7);
+        blend->commandStart(cmd);
+        t7->setMysqlTime(std::chrono::seconds(1));
+        blend->commandFinish(cmd);
+        BOOST_CHECK(statsPtr->getTableEntry(*t7).count == wsched::ScanStats::MIN_TABLE_SAMPLES + 1);
+        // Measured to be fast again, the tables go back to the fast lane.
+        for (int j = 0; j < 20; ++j) statsPtr->record(*t7, 1.0, 10);
+        BOOST_CHECK(statsPtr->adjustRating(*t7, fast) == fast);
+    }
+    std::remove(path.c_str());
+    LOGS(_log, LOG_LVL_DEBUG, "ScanStatsTest done");
+}
+
+BOOST_AUTO_TEST_CASE(SchedulerTunerStep) {
+    wsched::SchedulerTuner tuner(nullptr, std::chrono::hours(1));
+    BOOST_CHECK(!tuner.due());
+    tuner.setDefaults("B", 20, 1);
+    wsched::SchedulerTuner::Sample sample;
+    sample.poolThreads = 20;
+    wsched::SchedulerTuner::LaneSample a;
+    a.name = "A";
+    a.queued = 5;
+    a.inFlight = 2;
+    a.activeChunks = 3;
+    a.tasksPerSec = 10;
+    a.maxActiveChunks = 20;
+    a.maxReserve = 2;
+    wsched::SchedulerTuner::LaneSample b;
+    b.name = "B";
+    b.maxActiveChunks = 20;
+    b.maxReserve = 2;
+    sample.lanes = {a, b};
+
+    // Little memory left: A stops opening chunks, and as it has a backlog
+    // using all its threads, it gets another one. B is idle and goes back
+    // to its default reservation.
+    sample.memHeadroom = 0.05;
+    auto set = tuner.step(sample);
+    BOOST_CHECK_EQUAL(set[0].maxActiveChunks, 3);
+    BOOST_CHECK_EQUAL(set[0].maxReserve, 3);
+    BOOST_CHECK_EQUAL(set[1].maxActiveChunks, 1);
+    BOOST_CHECK_EQUAL(set[1].maxReserve, 1);
+
+    // Memory is back, limits go up one step. A's throughput dropped after
+    // its raise, so the raise is undone and not tried again for a while.
+    sample.memHeadroom = 0.9;
+    sample.lanes[0].maxActiveChunks = 3;
+    sample.lanes[0].maxReserve = 3;
+    sample.lanes[0].inFlight = 3;
+    sample.lanes[0].tasksPerSec = 5;
+    sample.lanes[1].maxActiveChunks = 1;
+    sample.lanes[1].maxReserve = 1;
+    set = tuner.step(sample);
+    BOOST_CHECK_EQUAL(set[0].maxActiveChunks, 4);
+    BOOST_CHECK_EQUAL(set[0].maxReserve, 2);
+    BOOST_CHECK_EQUAL(set[1].maxActiveChunks, 2);
+    BOOST_CHECK_EQUAL(set[1].maxReserve, 1);
+    sample.lanes[0].maxReserve = 2;
+    set = tuner.step(sample);
+    BOOST_CHECK_EQUAL(set[0].maxReserve, 2);
+    BOOST_CHECK(tuner.statusStr().find("A(queued=5") != std::string::npos);
+
+    // The last step is reported in the worker stats.
+    lsst::qserv::util::Metrics::Snapshot stats;
+    tuner.addStats(stats);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.steps"], 3);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.memHeadroomPct"], 90);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.A.maxActiveChunks"], 4);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.A.activeChunksChange"], 1);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.A.maxReserve"], 2);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.A.reserveChange"], 0);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.A.defaultReserve"], 2);
+    BOOST_CHECK(stats["wsched.tuner.A.hold"] > 0);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.B.maxActiveChunks"], 2);
+    BOOST_CHECK_EQUAL(stats["wsched.tuner.B.defaultReserve"], 1);
+}
+
+BOOST_AUTO_TEST_CASE(SchedulerTunerApply) {
+    // The sample is taken before the limits are read and changed, as
+    // BlendScheduler does without and then with its mutex.
+    auto memMan = std::make_shared<MemManCount>();
+    auto scan = std::make_shared<wsched::ScanScheduler>("ScanTune", 4, 1, 0, memMan, 0, 100);
+    std::vector<wsched::SchedulerBase::Ptr> scheds{scan};
+    wsched::SchedulerTuner tuner(memMan, std::chrono::hours(1));
+    auto sample = tuner.measure(scheds, 10);
+    BOOST_REQUIRE_EQUAL(sample.lanes.size(), 1U);
+    BOOST_CHECK_EQUAL(sample.lanes[0].name, "ScanTune");
+    BOOST_CHECK_CLOSE(sample.memHeadroom, 1.0, 0.001);
+    scan->setMaxActiveChunks(5);
+    tuner.apply(scheds, sample);
+    // One step from the current limit, which way depends on the host's I/O wait.
+    BOOST_CHECK_EQUAL(sample.lanes[0].maxActiveChunks, 5);
+    BOOST_CHECK(scan->getMaxActiveChunks() >= 1 && scan->getMaxActiveChunks() <= 6);
+}
+
+BOOST_AUTO_TEST_CASE(ScanPrefetchTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "ScanPrefetchTest start");
+    auto memMan = std::make_shared<MemManCount>();
+    wsched::ScanScheduler sched{"ScanSchedP", 2, 1, 0, memMan, 0, 100};
+    sched.setPrefetch(true);
+    int const medium = lsst::qserv::proto::ScanInfo::Rating::MEDIUM;
+    sched.queCmd(makeTask(newTaskMsgScan(40, medium)));
+    sched.queCmd(makeTask(newTaskMsgScan(41, medium)));
+
+    // Granting chunk 40 queues a background lock of chunk 41.
+    auto t40 = std::dynamic_pointer_cast<Task>(sched.getCmd(false));
+    BOOST_REQUIRE(t40 != nullptr);
+    BOOST_CHECK(t40->getChunkId() == 40);
+    for (int j=0; j < 500 && memMan->getLocks(41) == 0; ++j) {
+        usleep(1000);
+    }
+    BOOST_CHECK(memMan->getLocks(41) == 1);
+
+    // Once the Task on chunk 41 has its own handle, the prefetch handle is released.
+    sched.commandStart(t40);
+    sched.commandFinish(t40);
+    std::shared_ptr<Task> t41;
+    for (int j=0; j < 500 && t41 == nullptr; ++j) {
+        t41 = std::dynamic_pointer_cast<Task>(sched.getCmd(false));
+        if (t41 == nullptr) usleep(1000);
+    }
+    BOOST_REQUIRE(t41 != nullptr);
+    BOOST_CHECK(t41->getChunkId() == 41);
+    BOOST_CHECK(memMan->getLocks(41) == 2);
+    BOOST_CHECK(memMan->getUnlocks(41) == 1);
+    sched.commandStart(t41);
+    sched.commandFinish(t41);
+    BOOST_CHECK(memMan->getUnlocks(41) == 2);
+    sched.setPrefetch(false);
+    LOGS(_log, LOG_LVL_DEBUG, "ScanPrefetchTest done");
+}
+
+BOOST_AUTO_TEST_CASE(SchedulerAddStats) {
+    auto memMan = std::make_shared<lsst::qserv::memman::MemManNone>(1, false);
+    wsched::ScanScheduler sched{"ScanStatsA", 2, 1, 0, memMan, 0, 100};
+    sched.queCmd(makeTask(newTaskMsgScan(38, 0)));
+    sched.queCmd(makeTask(newTaskMsgScan(40, 0)));
+    auto cmd = sched.getCmd(false);
+    BOOST_REQUIRE(cmd != nullptr);
+    sched.commandStart(cmd);
+
+    lsst::qserv::util::Metrics::Snapshot stats;
+    sched.addStats(stats);
+    BOOST_CHECK_EQUAL(stats["wsched.ScanStatsA.queued"], 1);
+    BOOST_CHECK_EQUAL(stats["wsched.ScanStatsA.inFlight"], 1);
+    BOOST_CHECK_EQUAL(stats["wsched.ScanStatsA.activeChunks"], 1);
+    BOOST_CHECK_EQUAL(stats["wsched.ScanStatsA.query.0"], 1);
+    sched.commandFinish(cmd);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
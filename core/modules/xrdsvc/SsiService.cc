@@ -26,6 +26,7 @@
 
 // System headers
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <stdlib.h>
@@ -43,6 +44,7 @@
 #include "memman/MemManNone.h"
 #include "mysql/MySqlConnection.h"
 #include "sql/SqlConnection.h"
+#include "util/Diagnostics.h"
 #include "wbase/Base.h"
 #include "wconfig/WorkerConfig.h"
 #include "wconfig/WorkerConfigError.h"
@@ -52,6 +54,8 @@
 #include "wsched/FifoScheduler.h"
 #include "wsched/GroupScheduler.h"
 #include "wsched/ScanScheduler.h"
+#include "wsched/ScanStats.h"
+#include "wsched/SchedulerTuner.h"
 #include "xrdsvc/SsiSession.h"
 #include "xrdsvc/XrdName.h"
 
@@ -121,10 +125,29 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
                  "SchedFast", maxThread, workerConfig.getMaxReserveFast(), workerConfig.getPriorityFast(), memMan, fastest, fast)
     };
 
+    for (auto const& scan : scanSchedulers) {
+        scan->setPrefetch(workerConfig.getScanPrefetch());
+    }
+
+    auto blend = std::make_shared<wsched::BlendScheduler>("BlendSched", maxThread, group, scanSchedulers);
+    blend->setRelaxReserve(workerConfig.getRelaxReserve());
+    if (workerConfig.getTuneInterval() > 0) {
+        blend->setTuner(std::make_shared<wsched::SchedulerTuner>(
+                 memMan, std::chrono::seconds(workerConfig.getTuneInterval())));
+    }
+    if (!workerConfig.getScanStatsFile().empty()) {
+        blend->setScanStats(std::make_shared<wsched::ScanStats>(workerConfig.getScanStatsFile()));
+    }
+
     _foreman = std::make_shared<wcontrol::Foreman>(
-        std::make_shared<wsched::BlendScheduler>("BlendSched", maxThread, group, scanSchedulers),
+        blend,
         poolSize,
         workerConfig.getMySqlConfig());
+    if (!workerConfig.getDiagDir().empty() && workerConfig.getSlowTaskSec() > 0) {
+        _foreman->setDiagnostics(std::make_shared<util::Diagnostics>(
+                 workerConfig.getDiagDir(), workerConfig.getDiagMaxFiles()),
+                 std::chrono::seconds(workerConfig.getSlowTaskSec()));
+    }
 }
 
 SsiService::~SsiService() {
@@ -28,6 +28,7 @@
 #include <cctype>
 #include <cstddef>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 // Third-party headers
@@ -39,6 +40,7 @@
 // Qserv headers
 #include "global/ResourceUnit.h"
 #include "proto/worker.pb.h"
+#include "util/Metrics.h"
 #include "util/Timer.h"
 #include "wbase/SendChannel.h"
 #include "xrdsvc/SsiSession_ReplyChannel.h"
@@ -80,6 +82,10 @@ void SsiSession::ProcessRequest(XrdSsiRequest* req, unsigned short timeout) {
     };
 
     ResourceUnit ru(sessName);
+    if (ru.unitType() == ResourceUnit::STATS) {
+        _replyStats(req, replyChannel);
+        return;
+    }
     if (ru.unitType() != ResourceUnit::DBCHUNK) {
         std::ostringstream os;
         os << "Unexpected unit type in query db=" << ru.db() << " unitType=" << ru.unitType();
@@ -174,6 +180,22 @@ bool SsiSession::Unprovision(bool forced) {
     return true; // false if we can't unprovision now.
 }
 
+/// Reply to a request for "/stats" with the metrics of this worker and the
+/// state of its schedulers, one "name value" line each. Any request data is ignored.
+void SsiSession::_replyStats(XrdSsiRequest* req, std::shared_ptr<wbase::SendChannel> const& replyChannel) {
+    auto stats = util::Metrics::get().snapshot();
+    _processor->addStats(stats);
+    std::ostringstream os;
+    for (auto const& entry : stats) {
+        os << entry.first << " " << entry.second << "\n";
+    }
+    _stats = os.str();
+    LOGS(_log, LOG_LVL_DEBUG, "Replying with " << stats.size() << " stats");
+    replyChannel->send(_stats.data(), _stats.size());
+    BindRequest(req, this);
+    ReleaseRequestBuffer();
+}
+
 void SsiSession::_addTask(wbase::Task::Ptr const& task) {
     {
         std::lock_guard<std::mutex> lock(_tasksMutex);
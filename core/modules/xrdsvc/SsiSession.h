@@ -72,6 +72,7 @@ public:
 
 private:
     void _addTask(wbase::Task::Ptr const& task);
+    void _replyStats(XrdSsiRequest* req, std::shared_ptr<wbase::SendChannel> const& replyChannel);
 
     class ReplyChannel;
     friend class ReplyChannel;
@@ -83,6 +84,7 @@ private:
     std::mutex _tasksMutex; ///< protects _tasks.
     std::vector<wbase::Task::Ptr> _tasks;
     std::atomic<bool> _cancelled{false}; ///< true if the session has been cancelled.
+    std::string _stats; ///< reply to a stats request, must live until RequestFinished()
 
     friend class SsiProcessor; // Allow access for cancellation
 };